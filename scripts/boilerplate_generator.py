@@ -142,8 +142,13 @@ def get_arg_names(args):
 
     return [starred_name.strip("* ") for starred_name in starred_names]
 
-def get_func_boilerplate(fn_info):
-    call_args_str = ", ".join(get_arg_names(fn_info.args))
+def get_plugin_enum(module_name):
+    return "BD_PLUGIN_%s" % module_name.upper()
+
+def get_func_boilerplate(fn_info, module_name, fn_idx, instrument=False):
+    plugin_enum = get_plugin_enum(module_name)
+    arg_names = get_arg_names(fn_info.args)
+    call_args_str = ", ".join(arg_names)
     args_ann_unused = fn_info.args.replace(",", " G_GNUC_UNUSED,")
 
     if "int" in fn_info.rtype:
@@ -168,14 +173,79 @@ def get_func_boilerplate(fn_info):
            "}}\n\n").format(fn_info, default_ret, args_ann_unused)
 
     # then add a variable holding a reference to the dynamically loaded function
-    # (if any) initialized to the stub
+    # (if any) initialized to the stub, it may be changed by the lazy loading
+    # while other threads are calling the function so it's always accessed
+    # atomically
     ret += "static {0.rtype} (*_{0.name}) ({0.args}) = {0.name}_stub;\n\n".format(fn_info)
 
+    # then add a function loading the plugin and the function itself on the first
+    # call (used in the lazy mode)
+    ret += ("static {0.rtype} {0.name}_lazy ({0.args}) {{\n" +
+            "    gpointer plugin_handle = NULL;\n" +
+            "    {0.rtype} (*fn) ({0.args}) = NULL;\n" +
+            "    char *dl_error = NULL;\n\n" +
+            "    plugin_handle = load_lazy_plugin ({1});\n" +
+            "    if (!plugin_handle)\n" +
+            "        return {0.name}_stub ({2});\n\n" +
+            "    dlerror();\n" +
+            "    * (void**) (&fn) = dlsym(plugin_handle, \"{0.name}\");\n" +
+            "    if ((dl_error = dlerror()) != NULL) {{\n" +
+            "        bd_utils_log_format (BD_UTILS_LOG_WARNING, \"failed to load {0.name}: %s\", dl_error);\n" +
+            "        fn = {0.name}_stub;\n" +
+            "    }}\n" +
+            "    g_atomic_pointer_set (&_{0.name}, fn);\n\n" +
+            "    return fn ({2});\n" +
+            "}}\n\n").format(fn_info, plugin_enum, call_args_str)
+
     # then add a documented function calling the dynamically loaded one via the
     # reference
-    ret += ("{0.doc}{0.rtype} {0.name} ({0.args}) {{\n" +
-            "    return _{0.name} ({1});\n" +
-            "}}\n\n\n").format(fn_info, call_args_str)
+    if instrument:
+        ret += get_instrumented_func(fn_info, module_name, fn_idx, arg_names)
+    else:
+        ret += ("{0.doc}{0.rtype} {0.name} ({0.args}) {{\n" +
+                "    {0.rtype} (*fn) ({0.args}) = g_atomic_pointer_get (&_{0.name});\n\n" +
+                "    return fn ({1});\n" +
+                "}}\n\n\n").format(fn_info, call_args_str)
+
+    return ret
+
+def get_api_stats_module(fn_infos, module_name):
+    # names of the functions (indexed the same way as in the instrumented
+    # functions) and the per-module statistics, see src/lib/api_stats.h
+    ret = 'static const gchar *{0}_api_fn_names[] = {{\n'.format(module_name)
+    for info in fn_infos:
+        ret += '    "{0.name}",\n'.format(info)
+    ret += '};\n\n'
+    ret += 'static ApiStatsModule {0}_api_stats = API_STATS_MODULE_INIT ("{0}", {0}_api_fn_names, {1});\n\n'.format(module_name,
+                                                                                                                 len(fn_infos))
+
+    return ret
+
+def get_instrumented_func(fn_info, module_name, fn_idx, arg_names):
+    # pass a local error to the function to see if it failed even if the caller
+    # doesn't care about the error
+    has_error = "error" in arg_names and "GError" in fn_info.args
+    call_args_str = ", ".join("&l_error" if (has_error and name == "error") else name for name in arg_names)
+    has_ret = fn_info.rtype.strip() != "void"
+
+    ret = "{0.doc}{0.rtype} {0.name} ({0.args}) {{\n".format(fn_info)
+    ret += "    {0.rtype} (*fn) ({0.args}) = g_atomic_pointer_get (&_{0.name});\n".format(fn_info)
+    ret += "    ApiCallTrace trace;\n"
+    if has_error:
+        ret += "    GError *l_error = NULL;\n"
+    if has_ret:
+        ret += "    {0} ret;\n".format(fn_info.rtype.strip())
+    ret += "\n"
+    ret += "    api_stats_call_begin (&{0}_api_stats, {1}, &trace);\n".format(module_name, fn_idx)
+    ret += "    {0}fn ({1});\n".format("ret = " if has_ret else "", call_args_str)
+    ret += "    api_stats_call_end (&{0}_api_stats, {1}, &trace, {2});\n".format(module_name, fn_idx,
+                                                                                  "l_error != NULL" if has_error else "FALSE")
+    if has_error:
+        ret += "    if (l_error)\n"
+        ret += "        g_propagate_error (error, l_error);\n"
+    if has_ret:
+        ret += "\n    return ret;\n"
+    ret += "}\n\n\n"
 
     return ret
 
@@ -196,6 +266,7 @@ def get_loading_func(fn_infos, module_name):
     ret =  'static gpointer load_{0}_from_plugin(const gchar *so_name) {{\n'.format(module_name)
     ret += '    void *handle = NULL;\n'
     ret += '    char *error = NULL;\n'
+    ret += '    gpointer fn = NULL;\n'
     ret += '    gboolean (*init_fn) (void) = NULL;\n\n'
 
     ret += '    handle = dlopen(so_name, RTLD_LAZY | RTLD_NODELETE);\n'
@@ -218,25 +289,41 @@ def get_loading_func(fn_infos, module_name):
     for info in fn_infos:
         # clear any previous error and load the function
         ret += '    dlerror();\n'
-        ret += '    * (void**) (&_{0.name}) = dlsym(handle, "{0.name}");\n'.format(info)
+        ret += '    fn = dlsym(handle, "{0.name}");\n'.format(info)
         ret += '    if ((error = dlerror()) != NULL) {\n'
         ret += '        bd_utils_log_format (BD_UTILS_LOG_WARNING, "failed to load {0.name}: %s", error);\n'.format(info)
-        ret += '        _{0.name} = {0.name}_stub;\n'.format(info)
-        ret += '    }\n\n'
+        ret += '        g_atomic_pointer_set (&_{0.name}, {0.name}_stub);\n'.format(info)
+        ret += '    } else\n'
+        ret += '        g_atomic_pointer_set (&_{0.name}, fn);\n\n'.format(info)
 
     ret += '    return handle;\n'
     ret += '}\n\n'
 
     return ret
 
+def get_stubs_funcs(fn_infos, module_name):
+    # function reverting the functions to stubs
+    ret = 'static void reset_{0}_stubs (void) {{\n'.format(module_name)
+    for info in fn_infos:
+        ret += '    g_atomic_pointer_set (&_{0.name}, {0.name}_stub);\n'.format(info)
+    ret += '}\n\n'
+
+    # function setting the functions to the ones loading the plugin on the
+    # first call
+    ret += 'static void set_{0}_lazy (void) {{\n'.format(module_name)
+    for info in fn_infos:
+        ret += '    g_atomic_pointer_set (&_{0.name}, {0.name}_lazy);\n'.format(info)
+    ret += '}\n\n'
+
+    return ret
+
 def get_unloading_func(fn_infos, module_name):
     ret =  'static gboolean unload_{0} (gpointer handle) {{\n'.format(module_name)
     ret += '    char *error = NULL;\n'
     ret += '    gboolean (*close_fn) (void) = NULL;\n\n'
 
     # revert the functions to stubs
-    for info in fn_infos:
-        ret += '    _{0.name} = {0.name}_stub;\n'.format(info)
+    ret += '    reset_{0}_stubs ();\n'.format(module_name)
 
     ret += '\n'
     ret += '    dlerror();\n'
@@ -262,7 +349,7 @@ def get_fn_code(fn_info):
 def get_fn_header(fn_info):
     return "{0.doc}{0.rtype} {0.name} ({0.args});\n\n".format(fn_info)
 
-def generate_source_header(api_file, out_dir, skip_patterns=None):
+def generate_source_header(api_file, out_dir, skip_patterns=None, instrument=False):
     skip_patterns = skip_patterns or list()
     file_name = os.path.basename(api_file)
     mod_name, dot, ext = file_name.partition(".")
@@ -285,8 +372,11 @@ def generate_source_header(api_file, out_dir, skip_patterns=None):
     with open(os.path.join(out_dir, mod_name + ".c"), "w") as src_f:
         for info in nonapi_fn_infos:
             src_f.write(get_fn_code(info))
-        for info in api_fn_infos:
-            src_f.write(get_func_boilerplate(info))
+        if instrument:
+            src_f.write(get_api_stats_module(api_fn_infos, mod_name))
+        for idx, info in enumerate(api_fn_infos):
+            src_f.write(get_func_boilerplate(info, mod_name, idx, instrument))
+        src_f.write(get_stubs_funcs(api_fn_infos, mod_name))
         src_f.write(get_loading_func(api_fn_infos, mod_name))
         src_f.write(get_unloading_func(api_fn_infos, mod_name))
 
@@ -304,9 +394,14 @@ def generate_source_header(api_file, out_dir, skip_patterns=None):
     return 0
 
 if __name__ == "__main__":
+    # generate functions collecting call statistics (see bd_get_api_stats())
+    instrument = "--instrument" in sys.argv
+    if instrument:
+        sys.argv.remove("--instrument")
+
     if len(sys.argv) < 3:
         print("Needs a file name and output directory, exiting.")
-        print("Usage: %s FILE_NAME OUTPUT_DIR [SKIP_PATTERNS]" % sys.argv[0])
+        print("Usage: %s [--instrument] FILE_NAME OUTPUT_DIR [SKIP_PATTERNS]" % sys.argv[0])
         sys.exit(1)
 
     if not os.path.exists(sys.argv[1]):
@@ -321,6 +416,6 @@ if __name__ == "__main__":
     if not os.path.exists (out_dir):
         os.makedirs(out_dir)
 
-    status = generate_source_header(sys.argv[1], out_dir, skip_patterns)
+    status = generate_source_header(sys.argv[1], out_dir, skip_patterns, instrument)
 
     sys.exit(status)
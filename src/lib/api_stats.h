@@ -0,0 +1,49 @@
+#include <glib.h>
+#include "plugins.h"
+
+#ifndef BD_API_STATS_PRIVATE
+#define BD_API_STATS_PRIVATE
+
+/* Internal support for the instrumented API functions generated by
+   boilerplate_generator.py --instrument, see bd_get_api_stats(). */
+
+typedef struct ApiCallCounters {
+    guint64 calls;
+    guint64 errors;
+    guint64 total_time;
+    guint64 max_time;
+    guint64 histogram[BD_API_STATS_HISTOGRAM_BUCKETS];
+} ApiCallCounters;
+
+/* counters for all the functions of a module, each block is only incremented
+   by the single thread owning it (and reset by bd_reset_api_stats()), all
+   accesses are atomic so no locking is needed */
+typedef struct ApiStatsBlock {
+    struct ApiStatsBlock *next;
+    gint in_use;
+    ApiCallCounters *counters;
+} ApiStatsBlock;
+
+typedef struct ApiStatsModule {
+    const gchar *name;
+    const gchar **fn_names;
+    guint n_fns;
+    gint registered;
+    struct ApiStatsModule *next;
+    ApiStatsBlock *blocks;
+    GPrivate thread_block;
+} ApiStatsModule;
+
+typedef struct ApiCallTrace {
+    gint64 start;
+} ApiCallTrace;
+
+void api_stats_release_block (gpointer block);
+
+#define API_STATS_MODULE_INIT(name, fn_names, n_fns) \
+    { (name), (fn_names), (n_fns), 0, NULL, NULL, G_PRIVATE_INIT (api_stats_release_block) }
+
+void api_stats_call_begin (ApiStatsModule *module, guint fn_idx, ApiCallTrace *trace);
+void api_stats_call_end (ApiStatsModule *module, guint fn_idx, ApiCallTrace *trace, gboolean failed);
+
+#endif  /* BD_API_STATS_PRIVATE */
@@ -25,5 +25,7 @@ gboolean bd_try_init(BDPluginSpec **request_plugins, BDUtilsLogFunc log_func,
 gboolean bd_try_reinit (BDPluginSpec **require_plugins, gboolean reload, BDUtilsLogFunc log_func,
                         gchar ***loaded_plugin_names, GError **error);
 gboolean bd_is_initialized (void);
+void bd_set_lazy_loading (gboolean enabled);
+void bd_set_deps_probing (gboolean enabled);
 
 #endif  /* BD_LIB */
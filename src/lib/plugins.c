@@ -1,6 +1,11 @@
 #include <glib.h>
 #include <glib-object.h>
 #include "plugins.h"
+#include "api_stats.h"
+
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#endif
 
 /**
  * SECTION: plugins
@@ -69,3 +74,235 @@ GType bd_plugin_spec_get_type (void) {
 
     return type;
 }
+
+/* modules with instrumented functions (see api_stats.h) that were called at
+   least once, only prepended to */
+static ApiStatsModule *api_stats_modules = NULL;
+static BDApiTraceFunc api_trace_func = NULL;
+
+static void register_api_stats_module (ApiStatsModule *module) {
+    ApiStatsModule *head = NULL;
+
+    if (!g_atomic_int_compare_and_exchange (&(module->registered), 0, 1))
+        /* already registered (or being registered by a different thread) */
+        return;
+
+    do {
+        head = g_atomic_pointer_get (&api_stats_modules);
+        module->next = head;
+    } while (!g_atomic_pointer_compare_and_exchange (&api_stats_modules, head, module));
+}
+
+static ApiStatsBlock* get_thread_block (ApiStatsModule *module) {
+    ApiStatsBlock *block = NULL;
+    ApiStatsBlock *head = NULL;
+
+    block = g_private_get (&(module->thread_block));
+    if (G_LIKELY (block))
+        return block;
+
+    register_api_stats_module (module);
+
+    /* reuse a block released by a thread that has finished (if any) */
+    for (block = g_atomic_pointer_get (&(module->blocks)); block; block = block->next)
+        if (g_atomic_int_compare_and_exchange (&(block->in_use), 0, 1))
+            break;
+
+    if (!block) {
+        block = g_new0 (ApiStatsBlock, 1);
+        block->counters = g_new0 (ApiCallCounters, module->n_fns);
+        block->in_use = 1;
+        do {
+            head = g_atomic_pointer_get (&(module->blocks));
+            block->next = head;
+        } while (!g_atomic_pointer_compare_and_exchange (&(module->blocks), head, block));
+    }
+
+    g_private_set (&(module->thread_block), block);
+    return block;
+}
+
+/* called when the thread owning the block finishes, the counters are kept (and
+   continue to be updated by the next thread claiming the block) */
+void api_stats_release_block (gpointer block) {
+    g_atomic_int_set (&(((ApiStatsBlock *) block)->in_use), 0);
+}
+
+void api_stats_call_begin (ApiStatsModule *module, guint fn_idx, ApiCallTrace *trace) {
+    BDApiTraceFunc trace_func = g_atomic_pointer_get (&api_trace_func);
+
+    trace->start = g_get_monotonic_time ();
+#ifdef HAVE_SYS_SDT_H
+    DTRACE_PROBE1 (libblockdev, api_call_begin, module->fn_names[fn_idx]);
+#endif
+    if (trace_func)
+        trace_func (module->fn_names[fn_idx], FALSE, 0, FALSE);
+}
+
+void api_stats_call_end (ApiStatsModule *module, guint fn_idx, ApiCallTrace *trace, gboolean failed) {
+    BDApiTraceFunc trace_func = g_atomic_pointer_get (&api_trace_func);
+    gint64 duration = g_get_monotonic_time () - trace->start;
+    ApiCallCounters *counters = &(get_thread_block (module)->counters[fn_idx]);
+    guint64 max_time = 0;
+    guint bucket = 0;
+
+    if (duration < 0)
+        duration = 0;
+    bucket = MIN (g_bit_storage ((gulong) duration), BD_API_STATS_HISTOGRAM_BUCKETS - 1);
+    if (duration == 0)
+        bucket = 0;
+
+    /* only this thread increments the counters, but bd_reset_api_stats() may
+       reset them at any time so the updates need to be atomic (not just a
+       load and a store) for the reset not to be lost */
+    __atomic_fetch_add (&(counters->calls), 1, __ATOMIC_RELAXED);
+    if (failed)
+        __atomic_fetch_add (&(counters->errors), 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add (&(counters->total_time), duration, __ATOMIC_RELAXED);
+    max_time = __atomic_load_n (&(counters->max_time), __ATOMIC_RELAXED);
+    while ((guint64) duration > max_time &&
+           !__atomic_compare_exchange_n (&(counters->max_time), &max_time, duration, FALSE,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+    __atomic_fetch_add (&(counters->histogram[bucket]), 1, __ATOMIC_RELAXED);
+
+#ifdef HAVE_SYS_SDT_H
+    DTRACE_PROBE3 (libblockdev, api_call_end, module->fn_names[fn_idx], duration, failed);
+#endif
+    if (trace_func)
+        trace_func (module->fn_names[fn_idx], TRUE, duration, failed);
+}
+
+/**
+ * bd_api_stats_copy: (skip)
+ * @stats: (nullable): %BDApiStats to copy
+ *
+ * Creates a new copy of @stats.
+ */
+BDApiStats* bd_api_stats_copy (BDApiStats *stats) {
+    BDApiStats *ret = NULL;
+
+    if (!stats)
+        return NULL;
+
+    ret = g_new0 (BDApiStats, 1);
+    *ret = *stats;
+    ret->function = g_strdup (stats->function);
+
+    return ret;
+}
+
+/**
+ * bd_api_stats_free: (skip)
+ * @stats: (nullable): %BDApiStats to free
+ *
+ * Frees @stats.
+ */
+void bd_api_stats_free (BDApiStats *stats) {
+    if (!stats)
+        return;
+
+    g_free (stats->function);
+    g_free (stats);
+}
+
+GType bd_api_stats_get_type (void) {
+    static GType type = 0;
+
+    if (G_UNLIKELY (type == 0)) {
+        type = g_boxed_type_register_static ("BDApiStats",
+                                             (GBoxedCopyFunc) bd_api_stats_copy,
+                                             (GBoxedFreeFunc) bd_api_stats_free);
+    }
+
+    return type;
+}
+
+/**
+ * bd_get_api_stats:
+ *
+ * Gets statistics of the calls of the plugins' API functions. The statistics
+ * are only collected if the library was built with the instrumented API
+ * functions (`--enable-api-stats`), otherwise no statistics are returned.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): statistics of all the
+ *          API functions called so far
+ */
+BDApiStats** bd_get_api_stats (void) {
+    GPtrArray *ret = g_ptr_array_new ();
+    ApiStatsModule *module = NULL;
+    ApiStatsBlock *block = NULL;
+    ApiCallCounters *counters = NULL;
+    BDApiStats *stats = NULL;
+    guint64 max_time = 0;
+    guint i = 0;
+    guint j = 0;
+
+    for (module = g_atomic_pointer_get (&api_stats_modules); module; module = module->next) {
+        for (i = 0; i < module->n_fns; i++) {
+            stats = g_new0 (BDApiStats, 1);
+            for (block = g_atomic_pointer_get (&(module->blocks)); block; block = block->next) {
+                counters = &(block->counters[i]);
+                stats->calls += __atomic_load_n (&(counters->calls), __ATOMIC_RELAXED);
+                stats->errors += __atomic_load_n (&(counters->errors), __ATOMIC_RELAXED);
+                stats->total_time += __atomic_load_n (&(counters->total_time), __ATOMIC_RELAXED);
+                max_time = __atomic_load_n (&(counters->max_time), __ATOMIC_RELAXED);
+                stats->max_time = MAX (stats->max_time, max_time);
+                for (j = 0; j < BD_API_STATS_HISTOGRAM_BUCKETS; j++)
+                    stats->histogram[j] += __atomic_load_n (&(counters->histogram[j]), __ATOMIC_RELAXED);
+            }
+            if (stats->calls == 0) {
+                g_free (stats);
+                continue;
+            }
+            stats->function = g_strdup (module->fn_names[i]);
+            g_ptr_array_add (ret, stats);
+        }
+    }
+    g_ptr_array_add (ret, NULL);
+
+    return (BDApiStats **) g_ptr_array_free (ret, FALSE);
+}
+
+/**
+ * bd_reset_api_stats:
+ *
+ * Resets the statistics of the calls of the plugins' API functions. Calls
+ * finishing at the same time may or may not be counted, but all the calls
+ * finishing after the reset are.
+ */
+void bd_reset_api_stats (void) {
+    ApiStatsModule *module = NULL;
+    ApiStatsBlock *block = NULL;
+    ApiCallCounters *counters = NULL;
+    guint i = 0;
+    guint j = 0;
+
+    for (module = g_atomic_pointer_get (&api_stats_modules); module; module = module->next)
+        for (block = g_atomic_pointer_get (&(module->blocks)); block; block = block->next)
+            for (i = 0; i < module->n_fns; i++) {
+                counters = &(block->counters[i]);
+                __atomic_store_n (&(counters->calls), 0, __ATOMIC_RELAXED);
+                __atomic_store_n (&(counters->errors), 0, __ATOMIC_RELAXED);
+                __atomic_store_n (&(counters->total_time), 0, __ATOMIC_RELAXED);
+                __atomic_store_n (&(counters->max_time), 0, __ATOMIC_RELAXED);
+                for (j = 0; j < BD_API_STATS_HISTOGRAM_BUCKETS; j++)
+                    __atomic_store_n (&(counters->histogram[j]), 0, __ATOMIC_RELAXED);
+            }
+}
+
+/**
+ * bd_set_api_trace_func:
+ * @trace_func: (nullable) (scope forever): function to call when the plugins'
+ *              API functions are entered and when they return or %NULL to
+ *              disable tracing
+ *
+ * Sets a function for tracing the calls of the plugins' API functions. Like
+ * the statistics (see bd_get_api_stats()), tracing only works if the library
+ * was built with the instrumented API functions. In such case the
+ * `libblockdev:api_call_begin` and `libblockdev:api_call_end` USDT probes are
+ * also available (if supported by the system).
+ */
+void bd_set_api_trace_func (BDApiTraceFunc trace_func) {
+    g_atomic_pointer_set (&api_trace_func, trace_func);
+}
@@ -40,6 +40,49 @@ BDPluginSpec* bd_plugin_spec_copy (BDPluginSpec *spec);
 void bd_plugin_spec_free (BDPluginSpec *spec);
 BDPluginSpec* bd_plugin_spec_new (BDPlugin name, const gchar *so_name);
 
+#define BD_API_STATS_HISTOGRAM_BUCKETS 24
+
+#define BD_TYPE_API_STATS (bd_api_stats_get_type ())
+GType bd_api_stats_get_type (void);
+
+/**
+ * BDApiStats:
+ * @function: name of the function
+ * @calls: number of calls of the function
+ * @errors: number of calls that reported an error
+ * @total_time: total time (in microseconds) spent in the function
+ * @max_time: longest time (in microseconds) of a single call of the function
+ * @histogram: call duration histogram, the bucket `i` contains the number of
+ *             calls that took less than `2^i` microseconds (and longer than the
+ *             limit of the previous bucket), the last bucket contains all the
+ *             longer calls
+ */
+typedef struct BDApiStats {
+    gchar *function;
+    guint64 calls;
+    guint64 errors;
+    guint64 total_time;
+    guint64 max_time;
+    guint64 histogram[BD_API_STATS_HISTOGRAM_BUCKETS];
+} BDApiStats;
+
+/**
+ * BDApiTraceFunc:
+ * @function: name of the called function
+ * @finished: %FALSE when the function is entered, %TRUE when it returns
+ * @duration: duration of the call (in microseconds) if @finished, 0 otherwise
+ * @failed: whether the call reported an error (only valid if @finished)
+ *
+ * Function type for tracing calls of the plugins' API functions.
+ */
+typedef void (*BDApiTraceFunc) (const gchar *function, gboolean finished, gint64 duration, gboolean failed);
+
+BDApiStats* bd_api_stats_copy (BDApiStats *stats);
+void bd_api_stats_free (BDApiStats *stats);
+BDApiStats** bd_get_api_stats (void);
+void bd_reset_api_stats (void);
+void bd_set_api_trace_func (BDApiTraceFunc trace_func);
+
 gboolean bd_is_plugin_available (BDPlugin plugin);
 gchar** bd_get_available_plugin_names (void);
 gchar* bd_get_plugin_soname (BDPlugin plugin);
@@ -249,77 +249,6 @@ check_dbus_deps (volatile guint *avail_deps, guint req_deps, const DBusDep *buse
     return (val & req_deps) == req_deps;
 }
 
-static gboolean _check_util_feature (const gchar *util, const gchar *feature, const gchar *feature_arg, const gchar *feature_regexp, GError **error) {
-    g_autofree gchar *util_path = NULL;
-    const gchar *argv[] = {util, feature_arg, NULL};
-    g_autofree gchar *output = NULL;
-    gboolean succ = FALSE;
-    GRegex *regex = NULL;
-    GMatchInfo *match_info = NULL;
-    g_autofree gchar *features_str = NULL;
-    GError *l_error = NULL;
-
-    util_path = g_find_program_in_path (util);
-    if (!util_path) {
-        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_UTIL_UNAVAILABLE,
-                     "The '%s' utility is not available", util);
-        return FALSE;
-    }
-
-    succ = bd_utils_exec_and_capture_output (argv, NULL, &output, &l_error);
-    if (!succ) {
-        /* if we got nothing on STDOUT, try using STDERR data from error message */
-        if (g_error_matches (l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_NOOUT)) {
-            output = g_strdup (l_error->message);
-            g_clear_error (&l_error);
-        } else if (g_error_matches (l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED)) {
-            /* exit status != 0, try using the output anyway */
-            output = g_strdup (l_error->message);
-            g_clear_error (&l_error);
-        } else
-            return FALSE;
-    }
-
-    if (feature_regexp) {
-        regex = g_regex_new (feature_regexp, 0, 0, error);
-        if (!regex) {
-            /* error is already populated */
-            return FALSE;
-        }
-
-        succ = g_regex_match (regex, output, 0, &match_info);
-        if (!succ) {
-            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_UTIL_FEATURE_CHECK_ERROR,
-                         "Failed to determine %s's features from: %s", util, output);
-            g_regex_unref (regex);
-            g_match_info_free (match_info);
-            return FALSE;
-        }
-        g_regex_unref (regex);
-
-        features_str = g_match_info_fetch (match_info, 1);
-        g_match_info_free (match_info);
-    }
-    else
-        features_str = g_strstrip (g_strdup (output));
-
-    if (!features_str || (g_strcmp0 (features_str, "") == 0)) {
-        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_UTIL_FEATURE_CHECK_ERROR,
-                     "Failed to determine %s's features from: %s", util, output);
-        return FALSE;
-    }
-
-
-    if (!g_strrstr (features_str, feature)) {
-        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_UTIL_FEATURE_UNAVAILABLE,
-                     "Required feature %s not supported by this version of %s",
-                     feature, util);
-        return FALSE;
-    }
-
-    return TRUE;
-}
-
 G_GNUC_INTERNAL gboolean
 check_features (volatile guint *avail_deps, guint req_deps, const UtilFeatureDep *deps_specs, guint l_deps, GMutex *deps_check_lock, GError **error) {
     guint i = 0;
@@ -345,8 +274,8 @@ check_features (volatile guint *avail_deps, guint req_deps, const UtilFeatureDep
 
     for (i=0; i < l_deps; i++) {
         if (((1 << i) & req_deps) && !((1 << i) & val)) {
-            ret = _check_util_feature (deps_specs[i].util_name, deps_specs[i].feature,
-                                       deps_specs[i].feature_arg, deps_specs[i].feature_regexp, &l_error);
+            ret = bd_utils_check_util_feature (deps_specs[i].util_name, deps_specs[i].feature,
+                                               deps_specs[i].feature_arg, deps_specs[i].feature_regexp, &l_error);
             /* if not ret and l_error -> set/prepend error */
             if (!ret) {
                 if (l_error) {
@@ -368,3 +297,174 @@ check_features (volatile guint *avail_deps, guint req_deps, const UtilFeatureDep
     val = (guint) g_atomic_int_get (avail_deps);
     return (val & req_deps) == req_deps;
 }
+
+typedef enum {
+    DEPS_PROBE_UTIL,
+    DEPS_PROBE_MODULE,
+    DEPS_PROBE_DBUS,
+    DEPS_PROBE_FEATURE,
+} DepsProbeKind;
+
+typedef struct DepsProbeCheck {
+    DepsProbeKind kind;
+    volatile guint *avail_deps;
+    guint idx;
+    gconstpointer spec;
+} DepsProbeCheck;
+
+struct DepsProbe {
+    GPtrArray *checks;
+    GPtrArray *locks;
+};
+
+/*
+ * Creates a new (empty) probe for checking dependencies of a plugin
+ * concurrently. Add the dependencies with the deps_probe_add_*() functions and
+ * run the checks with deps_probe_run().
+ */
+G_GNUC_INTERNAL DepsProbe*
+deps_probe_new (void) {
+    DepsProbe *probe = g_new0 (DepsProbe, 1);
+
+    probe->checks = g_ptr_array_new_with_free_func (g_free);
+    probe->locks = g_ptr_array_new ();
+
+    return probe;
+}
+
+static void _probe_add (DepsProbe *probe, DepsProbeKind kind, volatile guint *avail_deps, guint idx, gconstpointer spec, GMutex *deps_check_lock) {
+    DepsProbeCheck *check = g_new0 (DepsProbeCheck, 1);
+    guint i = 0;
+    gboolean have_lock = FALSE;
+
+    check->kind = kind;
+    check->avail_deps = avail_deps;
+    check->idx = idx;
+    check->spec = spec;
+    g_ptr_array_add (probe->checks, check);
+
+    for (i=0; !have_lock && i < probe->locks->len; i++)
+        have_lock = (g_ptr_array_index (probe->locks, i) == deps_check_lock);
+    if (!have_lock)
+        g_ptr_array_add (probe->locks, deps_check_lock);
+}
+
+G_GNUC_INTERNAL void
+deps_probe_add_deps (DepsProbe *probe, volatile guint *avail_deps, const UtilDep *deps_specs, guint l_deps, GMutex *deps_check_lock) {
+    guint i = 0;
+
+    for (i=0; i < l_deps; i++)
+        _probe_add (probe, DEPS_PROBE_UTIL, avail_deps, i, &(deps_specs[i]), deps_check_lock);
+}
+
+G_GNUC_INTERNAL void
+deps_probe_add_module_deps (DepsProbe *probe, volatile guint *avail_deps, const gchar *const*modules, guint l_modules, GMutex *deps_check_lock) {
+    guint i = 0;
+
+    for (i=0; i < l_modules; i++)
+        _probe_add (probe, DEPS_PROBE_MODULE, avail_deps, i, modules[i], deps_check_lock);
+}
+
+G_GNUC_INTERNAL void
+deps_probe_add_dbus_deps (DepsProbe *probe, volatile guint *avail_deps, const DBusDep *buses, guint l_buses, GMutex *deps_check_lock) {
+    guint i = 0;
+
+    for (i=0; i < l_buses; i++)
+        _probe_add (probe, DEPS_PROBE_DBUS, avail_deps, i, &(buses[i]), deps_check_lock);
+}
+
+G_GNUC_INTERNAL void
+deps_probe_add_features (DepsProbe *probe, volatile guint *avail_deps, const UtilFeatureDep *deps_specs, guint l_deps, GMutex *deps_check_lock) {
+    guint i = 0;
+
+    for (i=0; i < l_deps; i++)
+        _probe_add (probe, DEPS_PROBE_FEATURE, avail_deps, i, &(deps_specs[i]), deps_check_lock);
+}
+
+static void _run_probe_check (gpointer data, gpointer user_data G_GNUC_UNUSED) {
+    DepsProbeCheck *check = (DepsProbeCheck *) data;
+    const UtilDep *dep = NULL;
+    const UtilFeatureDep *feature = NULL;
+    const DBusDep *bus = NULL;
+    gboolean ret = FALSE;
+    GError *l_error = NULL;
+
+    switch (check->kind) {
+        case DEPS_PROBE_UTIL:
+            dep = (const UtilDep *) check->spec;
+            ret = bd_utils_check_util_version (dep->name, dep->version, dep->ver_arg, dep->ver_regexp, &l_error);
+            break;
+        case DEPS_PROBE_MODULE:
+            ret = bd_utils_have_kernel_module ((const gchar *) check->spec, &l_error);
+            break;
+        case DEPS_PROBE_DBUS:
+            bus = (const DBusDep *) check->spec;
+            ret = bd_utils_dbus_service_available (NULL, bus->bus_type, bus->bus_name, bus->obj_prefix, &l_error);
+            if (ret && bus->version)
+                ret = _check_dbus_api_version (bus->bus_type, bus->version, bus->ver_intf, bus->ver_prop,
+                                               bus->bus_name, bus->ver_path, &l_error);
+            break;
+        case DEPS_PROBE_FEATURE:
+            feature = (const UtilFeatureDep *) check->spec;
+            ret = bd_utils_check_util_feature (feature->util_name, feature->feature, feature->feature_arg,
+                                               feature->feature_regexp, &l_error);
+            break;
+    }
+
+    if (ret)
+        g_atomic_int_or (check->avail_deps, 1 << check->idx);
+    else if (l_error) {
+        /* the error is reported again by the check_*() functions when the
+           dependency is actually needed */
+        bd_utils_log_format (BD_UTILS_LOG_DEBUG, "Dependency probe failed: %s", l_error->message);
+        g_clear_error (&l_error);
+    }
+}
+
+/*
+ * Runs all the checks added to @probe concurrently (one thread per check) and
+ * frees @probe. The results are stored in the same @avail_deps bitmasks the
+ * check_*() functions use, the locks given when adding the checks are held
+ * while the checks are running so that the check_*() functions called in the
+ * meantime wait for the results instead of running the same checks again.
+ */
+G_GNUC_INTERNAL void
+deps_probe_run (DepsProbe *probe) {
+    GThreadPool *pool = NULL;
+    DepsProbeCheck *check = NULL;
+    GError *l_error = NULL;
+    guint i = 0;
+
+    for (i=0; i < probe->locks->len; i++)
+        g_mutex_lock ((GMutex *) g_ptr_array_index (probe->locks, i));
+
+    if (probe->checks->len > 0) {
+        pool = g_thread_pool_new (_run_probe_check, NULL, probe->checks->len, FALSE, &l_error);
+        if (!pool) {
+            bd_utils_log_format (BD_UTILS_LOG_DEBUG, "Failed to create threads for dependency probing: %s",
+                                 l_error->message);
+            g_clear_error (&l_error);
+        }
+    }
+
+    for (i=0; i < probe->checks->len; i++) {
+        check = (DepsProbeCheck *) g_ptr_array_index (probe->checks, i);
+        if ((guint) g_atomic_int_get (check->avail_deps) & (1 << check->idx))
+            /* already known to be available */
+            continue;
+        if (!pool || !g_thread_pool_push (pool, check, NULL))
+            /* run in this thread if we cannot run it in parallel */
+            _run_probe_check (check, NULL);
+    }
+
+    if (pool)
+        /* waits for all the checks to finish */
+        g_thread_pool_free (pool, FALSE, TRUE);
+
+    for (i=probe->locks->len; i > 0; i--)
+        g_mutex_unlock ((GMutex *) g_ptr_array_index (probe->locks, i - 1));
+
+    g_ptr_array_free (probe->checks, TRUE);
+    g_ptr_array_free (probe->locks, TRUE);
+    g_free (probe);
+}
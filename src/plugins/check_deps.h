@@ -51,4 +51,14 @@ gboolean check_module_deps (volatile guint *avail_deps, guint req_deps, const gc
 gboolean check_dbus_deps (volatile guint *avail_deps, guint req_deps, const DBusDep *buses, guint l_buses, GMutex *deps_check_lock, GError **error);
 gboolean check_features (volatile guint *avail_deps, guint req_deps, const UtilFeatureDep *deps_specs, guint l_deps, GMutex *deps_check_lock, GError **error);
 
+/* probing all the dependencies at once, concurrently */
+typedef struct DepsProbe DepsProbe;
+
+DepsProbe* deps_probe_new (void);
+void deps_probe_add_deps (DepsProbe *probe, volatile guint *avail_deps, const UtilDep *deps_specs, guint l_deps, GMutex *deps_check_lock);
+void deps_probe_add_module_deps (DepsProbe *probe, volatile guint *avail_deps, const gchar *const*modules, guint l_modules, GMutex *deps_check_lock);
+void deps_probe_add_dbus_deps (DepsProbe *probe, volatile guint *avail_deps, const DBusDep *buses, guint l_buses, GMutex *deps_check_lock);
+void deps_probe_add_features (DepsProbe *probe, volatile guint *avail_deps, const UtilFeatureDep *deps_specs, guint l_deps, GMutex *deps_check_lock);
+void deps_probe_run (DepsProbe *probe);
+
 #endif  /* BD_CHECK_DEPS */
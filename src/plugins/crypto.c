@@ -521,7 +521,7 @@ gboolean bd_crypto_device_is_luks (const gchar *device, GError **error) {
     gint fd = 0;
     gint status = 0;
     const gchar *value = NULL;
-    guint n_try = 0;
+    BDUtilsDevWait *wait = NULL;
 
     probe = blkid_new_probe ();
     if (!probe) {
@@ -538,13 +538,13 @@ gboolean bd_crypto_device_is_luks (const gchar *device, GError **error) {
         return FALSE;
     }
 
-    /* we may need to try multiple times with some delays in case the device is
-       busy at the very moment */
-    for (n_try=5, status=-1; (status != 0) && (n_try > 0); n_try--) {
+    /* we may need to try multiple times in case the device is busy at the very
+       moment, wait for it to settle in between */
+    wait = bd_utils_dev_wait_new (device, BD_UTILS_DEV_SETTLE_TIMEOUT);
+    do {
         status = blkid_probe_set_device (probe, fd, 0, 0);
-        if (status != 0)
-            g_usleep (100 * 1000); /* microseconds */
-    }
+    } while (status != 0 && errno == EBUSY && bd_utils_dev_wait_next (wait));
+    bd_utils_dev_wait_free (wait);
     if (status != 0) {
         g_set_error (error, BD_CRYPTO_ERROR, BD_CRYPTO_ERROR_DEVICE,
                      "Failed to create a probe for the device '%s'", device);
@@ -559,13 +559,14 @@ gboolean bd_crypto_device_is_luks (const gchar *device, GError **error) {
     blkid_probe_set_superblocks_flags (probe, BLKID_SUBLKS_USAGE | BLKID_SUBLKS_TYPE |
                                               BLKID_SUBLKS_MAGIC | BLKID_SUBLKS_BADCSUM);
 
-    /* we may need to try multiple times with some delays in case the device is
-       busy at the very moment */
-    for (n_try=5, status=-1; !(status == 0 || status == 1) && (n_try > 0); n_try--) {
+    /* we may need to try multiple times in case the device is busy at the very
+       moment, wait for it to settle in between (-2 means ambiguous signatures,
+       no point in trying again) */
+    wait = bd_utils_dev_wait_new (device, BD_UTILS_DEV_SETTLE_TIMEOUT);
+    do {
         status = blkid_do_safeprobe (probe);
-        if (status < 0)
-            g_usleep (100 * 1000); /* microseconds */
-    }
+    } while (status == -1 && bd_utils_dev_wait_next (wait));
+    bd_utils_dev_wait_free (wait);
     if (status < 0) {
         /* -1 or -2 = error during probing*/
         g_set_error (error, BD_CRYPTO_ERROR, BD_CRYPTO_ERROR_DEVICE,
@@ -36,6 +36,7 @@ typedef enum {
  */
 gboolean bd_dm_init (void);
 void bd_dm_close (void);
+void bd_dm_probe_deps (void);
 
 gboolean bd_dm_is_tech_avail (BDDMTech tech, guint64 mode, GError **error);
 
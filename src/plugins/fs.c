@@ -84,6 +84,30 @@ void bd_fs_close (void) {
     _fs_nilfs_reset_avail_deps ();
 }
 
+/**
+ * bd_fs_probe_deps:
+ *
+ * Checks all the runtime dependencies of the plugin concurrently so that later
+ * availability checks don't need to run them one by one. **This function is
+ * called automatically by the library's initialization functions if
+ * dependency probing is enabled (see bd_set_deps_probing()).**
+ *
+ */
+void bd_fs_probe_deps (void) {
+    DepsProbe *probe = deps_probe_new ();
+
+    _fs_ext_add_deps_probe (probe);
+    _fs_xfs_add_deps_probe (probe);
+    _fs_vfat_add_deps_probe (probe);
+    _fs_ntfs_add_deps_probe (probe);
+    _fs_exfat_add_deps_probe (probe);
+    _fs_btrfs_add_deps_probe (probe);
+    _fs_udf_add_deps_probe (probe);
+    _fs_f2fs_add_deps_probe (probe);
+    _fs_nilfs_add_deps_probe (probe);
+    deps_probe_run (probe);
+}
+
 /**
  * bd_fs_is_tech_avail:
  * @tech: the queried tech
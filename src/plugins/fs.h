@@ -64,6 +64,7 @@ typedef enum {
  */
 gboolean bd_fs_init (void);
 void bd_fs_close (void);
+void bd_fs_probe_deps (void);
 
 gboolean bd_fs_is_tech_avail (BDFSTech tech, guint64 mode, GError **error);
 
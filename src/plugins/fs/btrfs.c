@@ -51,6 +51,11 @@ static const UtilDep deps[DEPS_LAST] = {
     {"btrfstune", NULL, NULL, NULL},
 };
 
+G_GNUC_INTERNAL
+void _fs_btrfs_add_deps_probe (DepsProbe *probe) {
+    deps_probe_add_deps (probe, &avail_deps, deps, DEPS_LAST, &deps_check_lock);
+}
+
 static guint32 fs_mode_util[BD_FS_MODE_LAST+1] = {
     DEPS_MKFSBTRFS_MASK,    /* mkfs */
     0,                      /* wipe */
@@ -1,6 +1,8 @@
 #include <glib.h>
 #include <blkid.h>
 
+#include <check_deps.h>
+
 #ifndef BD_FS_COMMON
 #define BD_FS_COMMON
 
@@ -21,4 +23,14 @@ void _fs_udf_reset_avail_deps (void);
 void _fs_f2fs_reset_avail_deps (void);
 void _fs_nilfs_reset_avail_deps (void);
 
+void _fs_ext_add_deps_probe (DepsProbe *probe);
+void _fs_xfs_add_deps_probe (DepsProbe *probe);
+void _fs_vfat_add_deps_probe (DepsProbe *probe);
+void _fs_ntfs_add_deps_probe (DepsProbe *probe);
+void _fs_exfat_add_deps_probe (DepsProbe *probe);
+void _fs_btrfs_add_deps_probe (DepsProbe *probe);
+void _fs_udf_add_deps_probe (DepsProbe *probe);
+void _fs_f2fs_add_deps_probe (DepsProbe *probe);
+void _fs_nilfs_add_deps_probe (DepsProbe *probe);
+
 #endif  /* BD_FS_COMMON */
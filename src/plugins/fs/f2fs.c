@@ -65,6 +65,12 @@ static const UtilDep shrink_deps[SHRINK_DEPS_LAST] = {
     {"resize.f2fs", "1.12.0", "-V", "resize.f2fs\\s+([\\d\\.]+).+"}
 };
 
+G_GNUC_INTERNAL
+void _fs_f2fs_add_deps_probe (DepsProbe *probe) {
+    deps_probe_add_deps (probe, &avail_deps, deps, DEPS_LAST, &deps_check_lock);
+    deps_probe_add_deps (probe, &avail_shrink_deps, shrink_deps, SHRINK_DEPS_LAST, &deps_check_lock);
+}
+
 static guint32 fs_mode_util[BD_FS_MODE_LAST+1] = {
     DEPS_MKFSF2FS_MASK,     /* mkfs */
     0,                      /* wipe */
@@ -388,7 +388,7 @@ gboolean bd_fs_wipe (const gchar *device, gboolean all, gboolean force, GError *
     gint status = 0;
     guint64 progress_id = 0;
     gchar *msg = NULL;
-    guint n_try = 0;
+    BDUtilsDevWait *wait = NULL;
     gint mode = 0;
     GError *l_error = NULL;
 
@@ -420,13 +420,13 @@ gboolean bd_fs_wipe (const gchar *device, gboolean all, gboolean force, GError *
         return FALSE;
     }
 
-    /* we may need to try multiple times with some delays in case the device is
-       busy at the very moment */
-    for (n_try=5, status=-1; (status != 0) && (n_try > 0); n_try--) {
+    /* we may need to try multiple times in case the device is busy at the very
+       moment, wait for it to settle in between */
+    wait = bd_utils_dev_wait_new (device, BD_UTILS_DEV_SETTLE_TIMEOUT);
+    do {
         status = blkid_probe_set_device (probe, fd, 0, 0);
-        if (status != 0)
-            g_usleep (100 * 1000); /* microseconds */
-    }
+    } while (status != 0 && errno == EBUSY && bd_utils_dev_wait_next (wait));
+    bd_utils_dev_wait_free (wait);
     if (status != 0) {
         g_set_error (&l_error, BD_FS_ERROR, BD_FS_ERROR_FAIL,
                      "Failed to create a probe for the device '%s'", device);
@@ -442,15 +442,14 @@ gboolean bd_fs_wipe (const gchar *device, gboolean all, gboolean force, GError *
     blkid_probe_enable_superblocks (probe, 1);
     blkid_probe_set_superblocks_flags (probe, BLKID_SUBLKS_MAGIC | BLKID_SUBLKS_BADCSUM);
 
-    /* we may need to try multiple times with some delays in case the device is
-       busy at the very moment */
-    for (n_try=5, status=-1; (status != 0) && (n_try > 0); n_try--) {
+    /* we may need to try multiple times in case the device is busy at the very
+       moment, wait for it to settle in between (-2 means ambiguous signatures,
+       no point in trying again) */
+    wait = bd_utils_dev_wait_new (device, BD_UTILS_DEV_SETTLE_TIMEOUT);
+    do {
         status = blkid_do_safeprobe (probe);
-        if (status == 1)
-            break;
-        if (status < 0)
-            g_usleep (100 * 1000); /* microseconds */
-    }
+    } while (status == -1 && bd_utils_dev_wait_next (wait));
+    bd_utils_dev_wait_free (wait);
     if (status == 1) {
         g_set_error (&l_error, BD_FS_ERROR, BD_FS_ERROR_NOFS,
                      "No signature detected on the device '%s'", device);
@@ -559,7 +558,7 @@ gchar* bd_fs_get_fstype (const gchar *device,  GError **error) {
     const gchar *value = NULL;
     gchar *fstype = NULL;
     size_t len = 0;
-    guint n_try = 0;
+    BDUtilsDevWait *wait = NULL;
 
     probe = blkid_new_probe ();
     if (!probe) {
@@ -577,13 +576,13 @@ gchar* bd_fs_get_fstype (const gchar *device,  GError **error) {
         return NULL;
     }
 
-    /* we may need to try multiple times with some delays in case the device is
-       busy at the very moment */
-    for (n_try=5, status=-1; (status != 0) && (n_try > 0); n_try--) {
+    /* we may need to try multiple times in case the device is busy at the very
+       moment, wait for it to settle in between */
+    wait = bd_utils_dev_wait_new (device, BD_UTILS_DEV_SETTLE_TIMEOUT);
+    do {
         status = blkid_probe_set_device (probe, fd, 0, 0);
-        if (status != 0)
-            g_usleep (100 * 1000); /* microseconds */
-    }
+    } while (status != 0 && errno == EBUSY && bd_utils_dev_wait_next (wait));
+    bd_utils_dev_wait_free (wait);
     if (status != 0) {
         g_set_error (error, BD_FS_ERROR, BD_FS_ERROR_FAIL,
                      "Failed to create a probe for the device '%s'", device);
@@ -598,13 +597,14 @@ gchar* bd_fs_get_fstype (const gchar *device,  GError **error) {
     blkid_probe_set_superblocks_flags (probe, BLKID_SUBLKS_USAGE | BLKID_SUBLKS_TYPE |
                                               BLKID_SUBLKS_MAGIC | BLKID_SUBLKS_BADCSUM);
 
-    /* we may need to try multiple times with some delays in case the device is
-       busy at the very moment */
-    for (n_try=5, status=-1; !(status == 0 || status == 1) && (n_try > 0); n_try--) {
+    /* we may need to try multiple times in case the device is busy at the very
+       moment, wait for it to settle in between (-2 means ambiguous signatures,
+       no point in trying again) */
+    wait = bd_utils_dev_wait_new (device, BD_UTILS_DEV_SETTLE_TIMEOUT);
+    do {
         status = blkid_do_safeprobe (probe);
-        if (status < 0)
-            g_usleep (100 * 1000); /* microseconds */
-    }
+    } while (status == -1 && bd_utils_dev_wait_next (wait));
+    bd_utils_dev_wait_free (wait);
     if (status < 0) {
         /* -1 or -2 = error during probing*/
         g_set_error (error, BD_FS_ERROR, BD_FS_ERROR_FAIL,
@@ -32,6 +32,10 @@
 #define LOOP_SET_BLOCK_SIZE	0x4C09
 #endif
 
+/* the loop ioctls may keep returning EAGAIN for a while after the device was
+   set up, give them more time than the default */
+#define LOOP_SETTLE_TIMEOUT (2 * BD_UTILS_DEV_SETTLE_TIMEOUT)
+
 /**
  * SECTION: loop
  * @short_description: plugin for operations with loop devices
@@ -297,7 +301,7 @@ gboolean bd_loop_setup_from_fd (gint fd, guint64 offset, guint64 size, gboolean
     struct loop_info64 li64;
     guint64 progress_id = 0;
     gint status = 0;
-    guint n_try = 0;
+    BDUtilsDevWait *wait = NULL;
     GError *l_error = NULL;
 
     progress_id = bd_utils_report_started ("Started setting up loop device");
@@ -359,15 +363,13 @@ gboolean bd_loop_setup_from_fd (gint fd, guint64 offset, guint64 size, gboolean
 
     bd_utils_report_progress (progress_id, 66, "Associated the loop device");
 
-    /* we may need to try multiple times with some delays in case the device is
-       busy at the very moment */
-    for (n_try=10, status=-1; (status != 0) && (n_try > 0); n_try--) {
+    /* we may need to try multiple times in case the device is busy at the very
+       moment, wait for it to settle in between */
+    wait = bd_utils_dev_wait_new (loop_device, LOOP_SETTLE_TIMEOUT);
+    do {
         status = ioctl (loop_fd, LOOP_SET_STATUS64, &li64);
-        if (status < 0 && errno == EAGAIN)
-            g_usleep (100 * 1000); /* microseconds */
-        else
-            break;
-    }
+    } while (status < 0 && errno == EAGAIN && bd_utils_dev_wait_next (wait));
+    bd_utils_dev_wait_free (wait);
 
     if (status != 0) {
         g_set_error (&l_error, BD_LOOP_ERROR, BD_LOOP_ERROR_FAIL,
@@ -383,13 +385,11 @@ gboolean bd_loop_setup_from_fd (gint fd, guint64 offset, guint64 size, gboolean
     }
 
     if (sector_size > 0) {
-        for (n_try=10, status=-1; (status != 0) && (n_try > 0); n_try--) {
+        wait = bd_utils_dev_wait_new (loop_device, LOOP_SETTLE_TIMEOUT);
+        do {
             status = ioctl (loop_fd, LOOP_SET_BLOCK_SIZE, (unsigned long) sector_size);
-            if (status < 0 && errno == EAGAIN)
-                g_usleep (100 * 1000); /* microseconds */
-            else
-                break;
-        }
+        } while (status < 0 && errno == EAGAIN && bd_utils_dev_wait_next (wait));
+        bd_utils_dev_wait_free (wait);
 
         if (status != 0) {
             g_set_error (&l_error, BD_LOOP_ERROR, BD_LOOP_ERROR_FAIL,
@@ -486,10 +486,10 @@ gboolean bd_loop_set_autoclear (const gchar *loop, gboolean autoclear, GError **
     g_free (msg);
 
     fd = open (dev_loop ? dev_loop : loop, O_RDWR);
-    g_free (dev_loop);
     if (fd < 0) {
         g_set_error (&l_error, BD_LOOP_ERROR, BD_LOOP_ERROR_DEVICE,
                      "Failed to open device %s: %m", loop);
+        g_free (dev_loop);
         bd_utils_report_finished (progress_id, l_error->message);
         g_propagate_error (error, l_error);
         return FALSE;
@@ -541,7 +541,7 @@ gboolean bd_loop_set_capacity (const gchar *loop, GError **error) {
     gint fd = -1;
     guint64 progress_id = 0;
     gchar *msg = NULL;
-    guint n_try = 0;
+    BDUtilsDevWait *wait = NULL;
     gint status = 0;
     GError *l_error = NULL;
 
@@ -554,22 +554,21 @@ gboolean bd_loop_set_capacity (const gchar *loop, GError **error) {
     g_free (msg);
 
     fd = open (dev_loop ? dev_loop : loop, O_RDWR);
-    g_free (dev_loop);
     if (fd < 0) {
         g_set_error (&l_error, BD_LOOP_ERROR, BD_LOOP_ERROR_DEVICE,
                      "Failed to open device %s: %m", loop);
+        g_free (dev_loop);
         bd_utils_report_finished (progress_id, l_error->message);
         g_propagate_error (error, l_error);
         return FALSE;
     }
 
-    for (n_try=10, status=-1; (status != 0) && (n_try > 0); n_try--) {
+    wait = bd_utils_dev_wait_new (dev_loop ? dev_loop : loop, LOOP_SETTLE_TIMEOUT);
+    do {
         status = ioctl (fd, LOOP_SET_CAPACITY, 0);
-        if (status < 0 && errno == EAGAIN)
-            g_usleep (100 * 1000); /* microseconds */
-        else
-            break;
-    }
+    } while (status < 0 && errno == EAGAIN && bd_utils_dev_wait_next (wait));
+    bd_utils_dev_wait_free (wait);
+    g_free (dev_loop);
 
     if (status != 0) {
         g_set_error (&l_error, BD_LOOP_ERROR, BD_LOOP_ERROR_FAIL,
@@ -46,6 +46,9 @@
 #define MAX_THPOOL_CHUNK_SIZE (1 GiB)
 #define DEFAULT_CHUNK_SIZE (64 KiB)
 
+/* thin pool metadata is always allocated in 4 KiB blocks */
+#define THPOOL_MD_BLOCK_SIZE (4 KiB)
+
 /* according to lvmcache (7) */
 #define MIN_CACHE_MD_SIZE (8 MiB)
 
@@ -265,6 +268,9 @@ BDLVMCacheStats* bd_lvm_cache_stats_copy (BDLVMCacheStats *data) {
     new->write_hits = data->write_hits;
     new->write_misses = data->write_misses;
     new->mode = data->mode;
+    new->promotions = data->promotions;
+    new->demotions = data->demotions;
+    new->dirty = data->dirty;
 
     return new;
 }
@@ -273,6 +279,222 @@ void bd_lvm_cache_stats_free (BDLVMCacheStats *data) {
     g_free (data);
 }
 
+BDLVMCachedLVStats* bd_lvm_cached_lv_stats_copy (BDLVMCachedLVStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMCachedLVStats *new_data = g_new0 (BDLVMCachedLVStats, 1);
+    new_data->vg_name = g_strdup (data->vg_name);
+    new_data->lv_name = g_strdup (data->lv_name);
+    new_data->stats = bd_lvm_cache_stats_copy (data->stats);
+
+    return new_data;
+}
+
+void bd_lvm_cached_lv_stats_free (BDLVMCachedLVStats *data) {
+    if (data == NULL)
+        return;
+
+    g_free (data->vg_name);
+    g_free (data->lv_name);
+    bd_lvm_cache_stats_free (data->stats);
+    g_free (data);
+}
+
+BDLVMThPoolStats* bd_lvm_thpool_stats_copy (BDLVMThPoolStats *stats) {
+    if (stats == NULL)
+        return NULL;
+
+    BDLVMThPoolStats *new_stats = g_new0 (BDLVMThPoolStats, 1);
+    *new_stats = *stats;
+    new_stats->vg_name = g_strdup (stats->vg_name);
+    new_stats->pool_name = g_strdup (stats->pool_name);
+
+    return new_stats;
+}
+
+void bd_lvm_thpool_stats_free (BDLVMThPoolStats *stats) {
+    if (stats == NULL)
+        return;
+
+    g_free (stats->vg_name);
+    g_free (stats->pool_name);
+    g_free (stats);
+}
+
+BDLVMLVCreateSpec* bd_lvm_lv_create_spec_copy (BDLVMLVCreateSpec *spec) {
+    if (spec == NULL)
+        return NULL;
+
+    BDLVMLVCreateSpec *new_spec = g_new0 (BDLVMLVCreateSpec, 1);
+    new_spec->lv_name = g_strdup (spec->lv_name);
+    new_spec->size = spec->size;
+    new_spec->type = g_strdup (spec->type);
+    new_spec->pv_list = g_strdupv (spec->pv_list);
+
+    return new_spec;
+}
+
+void bd_lvm_lv_create_spec_free (BDLVMLVCreateSpec *spec) {
+    if (spec == NULL)
+        return;
+
+    g_free (spec->lv_name);
+    g_free (spec->type);
+    g_strfreev (spec->pv_list);
+    g_free (spec);
+}
+
+BDLVMLVOpResult* bd_lvm_lv_op_result_copy (BDLVMLVOpResult *result) {
+    if (result == NULL)
+        return NULL;
+
+    BDLVMLVOpResult *new_result = g_new0 (BDLVMLVOpResult, 1);
+    new_result->lv_name = g_strdup (result->lv_name);
+    new_result->success = result->success;
+    new_result->error_message = g_strdup (result->error_message);
+
+    return new_result;
+}
+
+void bd_lvm_lv_op_result_free (BDLVMLVOpResult *result) {
+    if (result == NULL)
+        return;
+
+    g_free (result->lv_name);
+    g_free (result->error_message);
+    g_free (result);
+}
+
+/**
+ * lv_op_result_new: (skip)
+ * @lv_name: name of the LV the operation was run on
+ * @error: (transfer full) (nullable): error the operation failed with or %NULL
+ *
+ * Returns: (transfer full): a new result of an operation on @lv_name
+ */
+G_GNUC_INTERNAL BDLVMLVOpResult*
+lv_op_result_new (const gchar *lv_name, GError *error) {
+    BDLVMLVOpResult *ret = g_new0 (BDLVMLVOpResult, 1);
+
+    ret->lv_name = g_strdup (lv_name);
+    ret->success = (error == NULL);
+    if (error) {
+        ret->error_message = g_strdup (error->message);
+        g_error_free (error);
+    }
+
+    return ret;
+}
+
+BDLVMVDOSample* bd_lvm_vdo_sample_copy (BDLVMVDOSample *sample) {
+    if (sample == NULL)
+        return NULL;
+
+    BDLVMVDOSample *new_sample = g_new0 (BDLVMVDOSample, 1);
+    *new_sample = *sample;
+    new_sample->vg_name = g_strdup (sample->vg_name);
+    new_sample->pool_name = g_strdup (sample->pool_name);
+
+    return new_sample;
+}
+
+void bd_lvm_vdo_sample_free (BDLVMVDOSample *sample) {
+    if (sample == NULL)
+        return;
+
+    g_free (sample->vg_name);
+    g_free (sample->pool_name);
+    g_free (sample);
+}
+
+BDLVMVDORates* bd_lvm_vdo_rates_copy (BDLVMVDORates *rates) {
+    if (rates == NULL)
+        return NULL;
+
+    BDLVMVDORates *new_rates = g_new0 (BDLVMVDORates, 1);
+    *new_rates = *rates;
+    new_rates->vg_name = g_strdup (rates->vg_name);
+    new_rates->pool_name = g_strdup (rates->pool_name);
+
+    return new_rates;
+}
+
+void bd_lvm_vdo_rates_free (BDLVMVDORates *rates) {
+    if (rates == NULL)
+        return;
+
+    g_free (rates->vg_name);
+    g_free (rates->pool_name);
+    g_free (rates);
+}
+
+BDLVMFullReport* bd_lvm_full_report_copy (BDLVMFullReport *data) {
+    guint len = 0;
+
+    if (data == NULL)
+        return NULL;
+
+    BDLVMFullReport *new_data = g_new0 (BDLVMFullReport, 1);
+
+    if (data->pvs) {
+        for (len = 0; data->pvs[len]; len++)
+            ;
+        new_data->pvs = g_new0 (BDLVMPVdata *, len + 1);
+        for (guint i = 0; i < len; i++)
+            new_data->pvs[i] = bd_lvm_pvdata_copy (data->pvs[i]);
+    }
+
+    if (data->vgs) {
+        for (len = 0; data->vgs[len]; len++)
+            ;
+        new_data->vgs = g_new0 (BDLVMVGdata *, len + 1);
+        for (guint i = 0; i < len; i++)
+            new_data->vgs[i] = bd_lvm_vgdata_copy (data->vgs[i]);
+    }
+
+    if (data->lvs) {
+        for (len = 0; data->lvs[len]; len++)
+            ;
+        new_data->lvs = g_new0 (BDLVMLVdata *, len + 1);
+        for (guint i = 0; i < len; i++)
+            new_data->lvs[i] = bd_lvm_lvdata_copy (data->lvs[i]);
+    }
+
+    return new_data;
+}
+
+void bd_lvm_full_report_free (BDLVMFullReport *data) {
+    if (data == NULL)
+        return;
+
+    for (guint i = 0; data->pvs && data->pvs[i]; i++)
+        bd_lvm_pvdata_free (data->pvs[i]);
+    g_free (data->pvs);
+    for (guint i = 0; data->vgs && data->vgs[i]; i++)
+        bd_lvm_vgdata_free (data->vgs[i]);
+    g_free (data->vgs);
+    for (guint i = 0; data->lvs && data->lvs[i]; i++)
+        bd_lvm_lvdata_free (data->lvs[i]);
+    g_free (data->lvs);
+    g_free (data);
+}
+
+BDLVMMetadataCacheStats* bd_lvm_metadata_cache_stats_copy (BDLVMMetadataCacheStats *data) {
+    if (data == NULL)
+        return NULL;
+
+    BDLVMMetadataCacheStats *new_data = g_new0 (BDLVMMetadataCacheStats, 1);
+    new_data->hits = data->hits;
+    new_data->misses = data->misses;
+
+    return new_data;
+}
+
+void bd_lvm_metadata_cache_stats_free (BDLVMMetadataCacheStats *data) {
+    g_free (data);
+}
+
 /**
  * bd_lvm_is_supported_pe_size:
  * @size: size (in bytes) to test
@@ -505,6 +727,8 @@ gboolean bd_lvm_set_global_config (const gchar *new_config, GError **error G_GNU
     else
         global_config_str = g_strdup (new_config);
 
+    lvm_global_config_changed ();
+
     g_mutex_unlock (&global_config_lock);
     return TRUE;
 }
@@ -555,6 +779,8 @@ gboolean bd_lvm_set_devices_filter (const gchar **devices, GError **error) {
     else
         global_devices_str = g_strjoinv (",", (gchar **) devices);
 
+    lvm_global_config_changed ();
+
     g_mutex_unlock (&global_config_lock);
     return TRUE;
 }
@@ -823,6 +1049,218 @@ BDLVMVDOStats* bd_lvm_vdo_get_stats (const gchar *vg_name, const gchar *pool_nam
     return stats;
 }
 
+/* called by foreach_lvm_dm_target() for every LVM DM map, the @type and @params
+   strings are only valid during the call; returning %FALSE (with @error set)
+   stops the walk */
+typedef gboolean (*LVMDMTargetFunc) (struct dm_pool *pool, const gchar *map_name, const gchar *vg_name, const gchar *lv_name,
+                                     const struct dm_info *info, const gchar *type, const gchar *params,
+                                     gpointer user_data, GError **error);
+
+/* Walks over all the active LVM DM maps (with the first target of @target_type
+   or all of them if %NULL) using one status query for every map. Maps removed
+   in the meantime, non-LVM maps and maps the names of which cannot be
+   translated back into the VG and LV name are skipped. */
+static gboolean foreach_lvm_dm_target (const gchar *target_type, LVMDMTargetFunc func, gpointer user_data, GError **error) {
+    struct dm_pool *pool = NULL;
+    struct dm_task *task_list = NULL;
+    struct dm_task *task = NULL;
+    struct dm_names *names = NULL;
+    struct dm_info info;
+    guint64 next = 0;
+    guint64 start = 0;
+    guint64 length = 0;
+    gchar *type = NULL;
+    gchar *params = NULL;
+    const gchar *uuid = NULL;
+    gchar *vg_name = NULL;
+    gchar *lv_name = NULL;
+    gchar *layer = NULL;
+    gboolean ret = TRUE;
+
+    task_list = dm_task_create (DM_DEVICE_LIST);
+    if (!task_list) {
+        g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                             "Failed to create DM task");
+        return FALSE;
+    }
+
+    if (dm_task_run (task_list) == 0) {
+        g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                             "Failed to list DM maps");
+        dm_task_destroy (task_list);
+        return FALSE;
+    }
+
+    names = dm_task_get_names (task_list);
+    if (!names || !names->dev) {
+        /* no DM maps at all */
+        dm_task_destroy (task_list);
+        return TRUE;
+    }
+
+    pool = dm_pool_create ("bd-pool", 20);
+    do {
+        names = (void *)names + next;
+        next = names->next;
+
+        task = dm_task_create (DM_DEVICE_STATUS);
+        if (!task) {
+            g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                                 "Failed to create DM task");
+            ret = FALSE;
+            break;
+        }
+
+        /* maps removed in the meantime are just skipped */
+        if (dm_task_set_name (task, names->name) == 0 || dm_task_run (task) == 0 ||
+            dm_task_get_info (task, &info) == 0 || !info.exists) {
+            dm_task_destroy (task);
+            continue;
+        }
+
+        /* only LVM maps (of the given type) are interesting */
+        uuid = dm_task_get_uuid (task);
+        dm_get_next_target (task, NULL, &start, &length, &type, &params);
+        if (!uuid || !g_str_has_prefix (uuid, "LVM-") || (target_type && g_strcmp0 (type, target_type) != 0)) {
+            dm_task_destroy (task);
+            continue;
+        }
+
+        /* translate the DM map name (e.g. "vg-pool-tpool") back into the VG+LV name */
+        if (dm_split_lvm_name (pool, names->name, &vg_name, &lv_name, &layer) == 0) {
+            bd_utils_log_format (BD_UTILS_LOG_DEBUG, "Skipping the DM map '%s': failed to get VG and LV name from it",
+                                 names->name);
+            dm_task_destroy (task);
+            continue;
+        }
+
+        ret = func (pool, names->name, vg_name, lv_name, &info, type, params, user_data, error);
+        dm_task_destroy (task);
+    } while (ret && next);
+
+    dm_task_destroy (task_list);
+    dm_pool_destroy (pool);
+
+    return ret;
+}
+
+static gboolean vdo_sample_map (struct dm_pool *pool G_GNUC_UNUSED, const gchar *map_name, const gchar *vg_name, const gchar *lv_name,
+                                const struct dm_info *info G_GNUC_UNUSED, const gchar *type G_GNUC_UNUSED,
+                                const gchar *params G_GNUC_UNUSED, gpointer user_data, GError **error G_GNUC_UNUSED) {
+    GPtrArray *samples = (GPtrArray *) user_data;
+    BDLVMVDOSample *sample = NULL;
+    GError *l_error = NULL;
+
+    /* a failed pool (or a map being removed right now) shouldn't make the
+       samples of all the other pools unavailable */
+    sample = g_new0 (BDLVMVDOSample, 1);
+    if (!vdo_get_stats_sample (map_name, sample, &l_error)) {
+        bd_utils_log_format (BD_UTILS_LOG_DEBUG, "Skipping the VDO pool map '%s': %s", map_name, l_error->message);
+        g_clear_error (&l_error);
+        g_free (sample);
+        return TRUE;
+    }
+    sample->vg_name = g_strdup (vg_name);
+    sample->pool_name = g_strdup (lv_name);
+    g_ptr_array_add (samples, sample);
+
+    return TRUE;
+}
+
+/**
+ * bd_lvm_vdo_sample_all:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Samples the counters of all the active VDO pools in the system in one pass
+ * over the device mapper maps (one stats message for every VDO pool), without
+ * running any LVM command. Keep the result and pass it to
+ * @bd_lvm_vdo_sample_rates together with the next sample to get the rates for
+ * the interval between the two samples. VDO pools the stats of which cannot be
+ * read (e.g. VDO pools being removed at the moment) are skipped.
+ *
+ * Returns: (array zero-terminated=1): samples for all the active VDO pools or
+ *          %NULL in case of error
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVDOSample** bd_lvm_vdo_sample_all (GError **error) {
+    GPtrArray *ret = NULL;
+
+    ret = g_ptr_array_new_with_free_func ((GDestroyNotify) bd_lvm_vdo_sample_free);
+    if (!foreach_lvm_dm_target ("vdo", vdo_sample_map, ret, error)) {
+        g_ptr_array_free (ret, TRUE);
+        return NULL;
+    }
+
+    g_ptr_array_set_free_func (ret, NULL);
+    g_ptr_array_add (ret, NULL);
+    return (BDLVMVDOSample **) g_ptr_array_free (ret, FALSE);
+}
+
+/* counters are reset when the pool is re-activated */
+static guint64 counter_delta (guint64 prev, guint64 cur) {
+    return cur >= prev ? cur - prev : cur;
+}
+
+/**
+ * bd_lvm_vdo_sample_rates:
+ * @prev: previous sample of a VDO pool
+ * @cur: current sample of the same VDO pool
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Computes the rates for the interval between two samples of the same VDO pool
+ * taken by @bd_lvm_vdo_sample_all. Counters that went backwards (e.g. because
+ * the pool was re-activated in the meantime) are counted from zero.
+ *
+ * Returns: (transfer full): rates for the interval between @prev and @cur or
+ *                           %NULL in case of error
+ *
+ * Tech category: %BD_LVM_TECH_VDO-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVDORates* bd_lvm_vdo_sample_rates (const BDLVMVDOSample *prev, const BDLVMVDOSample *cur, GError **error) {
+    BDLVMVDORates *rates = NULL;
+    gdouble interval = 0;
+    guint64 in_write = 0;
+    guint64 out_write = 0;
+    guint64 found = 0;
+    guint64 not_found = 0;
+
+    if (g_strcmp0 (prev->vg_name, cur->vg_name) != 0 || g_strcmp0 (prev->pool_name, cur->pool_name) != 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                     "Samples of different VDO pools given: '%s/%s' and '%s/%s'",
+                     prev->vg_name, prev->pool_name, cur->vg_name, cur->pool_name);
+        return NULL;
+    }
+
+    if (cur->timestamp <= prev->timestamp) {
+        g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                             "The current sample must be newer than the previous one");
+        return NULL;
+    }
+
+    interval = (cur->timestamp - prev->timestamp) / (gdouble) G_USEC_PER_SEC;
+    in_write = counter_delta (prev->bios_in_write, cur->bios_in_write);
+    out_write = counter_delta (prev->bios_out_write, cur->bios_out_write) +
+                counter_delta (prev->bios_meta_write, cur->bios_meta_write);
+    found = counter_delta (prev->dedupe_posts_found, cur->dedupe_posts_found);
+    not_found = counter_delta (prev->dedupe_posts_not_found, cur->dedupe_posts_not_found);
+
+    rates = g_new0 (BDLVMVDORates, 1);
+    rates->vg_name = g_strdup (cur->vg_name);
+    rates->pool_name = g_strdup (cur->pool_name);
+    rates->interval = interval;
+    if (in_write > 0)
+        rates->write_amplification = (gdouble) out_write / in_write;
+    if (found + not_found > 0)
+        rates->dedupe_hit_rate = (gdouble) found / (found + not_found);
+    rates->bios_in_per_sec = (counter_delta (prev->bios_in_read, cur->bios_in_read) + in_write) / interval;
+    rates->bios_out_per_sec = (counter_delta (prev->bios_out_read, cur->bios_out_read) + out_write) / interval;
+    rates->journal_blocked_per_sec = (counter_delta (prev->journal_disk_full, cur->journal_disk_full) +
+                                      counter_delta (prev->slab_journal_blocked, cur->slab_journal_blocked)) / interval;
+
+    return rates;
+}
+
 /* check whether the LVM devices file is enabled by LVM
  * we use the existence of the "lvmdevices" command to check whether the feature is available
  * or not, but this can still be disabled either in LVM or in lvm.conf
@@ -847,8 +1285,9 @@ static gboolean _lvm_devices_enabled () {
         args[4] = config_arg;
     }
 
-    ret = bd_utils_exec_and_capture_output (args, NULL, &output, &loc_error);
     g_mutex_unlock (&global_config_lock);
+
+    ret = bd_utils_exec_and_capture_output (args, NULL, &output, &loc_error);
     if (ret) {
         scanned = sscanf (output, "use_devicesfile=%u", &enabled);
         g_free (output);
@@ -1062,6 +1501,41 @@ gboolean bd_lvm_vgcfgrestore (const gchar *vg_name, const gchar *backup_file, co
     return _vgcfgbackup_restore ("vgcfgrestore", vg_name, backup_file, extra, error);
 }
 
+static BDLVMCacheStats* get_cache_stats_from_status (struct dm_status_cache *status, GError **error) {
+    BDLVMCacheStats *ret = g_new0 (BDLVMCacheStats, 1);
+
+    ret->block_size = status->block_size * SECTOR_SIZE;
+    ret->cache_size = status->total_blocks * ret->block_size;
+    ret->cache_used = status->used_blocks * ret->block_size;
+
+    ret->md_block_size = status->metadata_block_size * SECTOR_SIZE;
+    ret->md_size = status->metadata_total_blocks * ret->md_block_size;
+    ret->md_used = status->metadata_used_blocks * ret->md_block_size;
+
+    ret->read_hits = status->read_hits;
+    ret->read_misses = status->read_misses;
+    ret->write_hits = status->write_hits;
+    ret->write_misses = status->write_misses;
+
+    ret->promotions = status->promotions;
+    ret->demotions = status->demotions;
+    ret->dirty = status->dirty_blocks * ret->block_size;
+
+    if (status->feature_flags & DM_CACHE_FEATURE_WRITETHROUGH)
+        ret->mode = BD_LVM_CACHE_MODE_WRITETHROUGH;
+    else if (status->feature_flags & DM_CACHE_FEATURE_WRITEBACK)
+        ret->mode = BD_LVM_CACHE_MODE_WRITEBACK;
+    else {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
+                      "Failed to determine status of the cache from '%"G_GUINT64_FORMAT"': ",
+                      status->feature_flags);
+        bd_lvm_cache_stats_free (ret);
+        return NULL;
+    }
+
+    return ret;
+}
+
 /**
  * bd_lvm_cache_stats:
  * @vg_name: name of the VG containing the @cached_lv
@@ -1149,36 +1623,423 @@ BDLVMCacheStats* bd_lvm_cache_stats (const gchar *vg_name, const gchar *cached_l
         return NULL;
     }
 
-    ret = g_new0 (BDLVMCacheStats, 1);
-    ret->block_size = status->block_size * SECTOR_SIZE;
-    ret->cache_size = status->total_blocks * ret->block_size;
-    ret->cache_used = status->used_blocks * ret->block_size;
+    ret = get_cache_stats_from_status (status, error);
 
-    ret->md_block_size = status->metadata_block_size * SECTOR_SIZE;
-    ret->md_size = status->metadata_total_blocks * ret->md_block_size;
-    ret->md_used = status->metadata_used_blocks * ret->md_block_size;
+    dm_task_destroy (task);
+    dm_pool_destroy (pool);
 
-    ret->read_hits = status->read_hits;
-    ret->read_misses = status->read_misses;
-    ret->write_hits = status->write_hits;
-    ret->write_misses = status->write_misses;
+    return ret;
+}
 
-    if (status->feature_flags & DM_CACHE_FEATURE_WRITETHROUGH)
-        ret->mode = BD_LVM_CACHE_MODE_WRITETHROUGH;
-    else if (status->feature_flags & DM_CACHE_FEATURE_WRITEBACK)
-        ret->mode = BD_LVM_CACHE_MODE_WRITEBACK;
-    else {
+/* the writecache target only reports block counts, the block size is in the table */
+static BDLVMCacheStats* get_writecache_stats (struct dm_pool *pool, const gchar *map_name, const gchar *params, GError **error) {
+    struct dm_task *task = NULL;
+    struct dm_status_writecache *status = NULL;
+    guint64 start = 0;
+    guint64 length = 0;
+    gchar *type = NULL;
+    gchar *table_params = NULL;
+    guint block_size = 0;
+    BDLVMCacheStats *ret = NULL;
+
+    if (dm_get_status_writecache (pool, params, &status) == 0) {
         g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
-                      "Failed to determine status of the cache from '%"G_GUINT64_FORMAT"': ",
-                      status->feature_flags);
+                     "Failed to get status of the writecache map '%s'", map_name);
+        return NULL;
+    }
+
+    task = dm_task_create (DM_DEVICE_TABLE);
+    if (!task || dm_task_set_name (task, map_name) == 0 || dm_task_run (task) == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                     "Failed to get table of the writecache map '%s'", map_name);
+        if (task)
+            dm_task_destroy (task);
+        return NULL;
+    }
+
+    /* <p|s> <origin> <cache> <block size> ... */
+    dm_get_next_target (task, NULL, &start, &length, &type, &table_params);
+    if (!table_params || sscanf (table_params, "%*s %*s %*s %u", &block_size) != 1) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
+                     "Failed to get block size of the writecache map '%s'", map_name);
         dm_task_destroy (task);
-        dm_pool_destroy (pool);
-        bd_lvm_cache_stats_free (ret);
         return NULL;
     }
+    dm_task_destroy (task);
+
+    ret = g_new0 (BDLVMCacheStats, 1);
+    ret->block_size = block_size;
+    ret->cache_size = status->total_blocks * ret->block_size;
+    ret->cache_used = (status->total_blocks - status->free_blocks) * ret->block_size;
 
+    /* writecache only caches writes and always writes them back */
+    ret->mode = BD_LVM_CACHE_MODE_WRITEBACK;
+
+    return ret;
+}
+
+static gboolean cache_stats_map (struct dm_pool *pool, const gchar *map_name, const gchar *vg_name, const gchar *lv_name,
+                                 const struct dm_info *info G_GNUC_UNUSED, const gchar *type, const gchar *params,
+                                 gpointer user_data, GError **error G_GNUC_UNUSED) {
+    GPtrArray *entries = (GPtrArray *) user_data;
+    struct dm_status_cache *status = NULL;
+    BDLVMCacheStats *stats = NULL;
+    BDLVMCachedLVStats *entry = NULL;
+    GError *l_error = NULL;
+
+    if (g_strcmp0 (type, "cache") == 0) {
+        if (dm_get_status_cache (pool, params, &status) == 0)
+            g_set_error (&l_error, BD_LVM_ERROR, BD_LVM_ERROR_CACHE_INVAL,
+                         "Failed to get status of the cache map '%s'", map_name);
+        else
+            stats = get_cache_stats_from_status (status, &l_error);
+    } else if (g_strcmp0 (type, "writecache") == 0)
+        stats = get_writecache_stats (pool, map_name, params, &l_error);
+    else
+        return TRUE;
+
+    /* a failed cache (or a map being removed right now) shouldn't make
+       the stats of all the other caches unavailable */
+    if (!stats) {
+        bd_utils_log_format (BD_UTILS_LOG_DEBUG, "Skipping the cache map '%s': %s", map_name, l_error->message);
+        g_clear_error (&l_error);
+        return TRUE;
+    }
+
+    entry = g_new0 (BDLVMCachedLVStats, 1);
+    entry->vg_name = g_strdup (vg_name);
+    entry->lv_name = g_strdup (lv_name);
+    entry->stats = stats;
+    g_ptr_array_add (entries, entry);
+
+    return TRUE;
+}
+
+/**
+ * bd_lvm_cache_stats_all:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Gets stats for all the active cached (both cache and writecache) LVs in the
+ * system directly from device mapper (one status query for every DM map),
+ * without running any LVM command.
+ *
+ * Note: For writecache LVs only the @block_size, @cache_size and @cache_used
+ *       fields of the stats are filled in, the @mode is always
+ *       %BD_LVM_CACHE_MODE_WRITEBACK. Cached thin pools are reported with the
+ *       name of their data LV (e.g. "pool_tdata"). Caches the stats of which
+ *       cannot be read (e.g. failed caches or caches being removed at the
+ *       moment) are skipped.
+ *
+ * Returns: (array zero-terminated=1): stats for all the active cached LVs or
+ *          %NULL in case of error
+ *
+ * Tech category: %BD_LVM_TECH_CACHE-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMCachedLVStats** bd_lvm_cache_stats_all (GError **error) {
+    GPtrArray *ret = NULL;
+
+    ret = g_ptr_array_new_with_free_func ((GDestroyNotify) bd_lvm_cached_lv_stats_free);
+    if (!foreach_lvm_dm_target (NULL, cache_stats_map, ret, error)) {
+        g_ptr_array_free (ret, TRUE);
+        return NULL;
+    }
+
+    g_ptr_array_set_free_func (ret, NULL);
+    g_ptr_array_add (ret, NULL);
+    return (BDLVMCachedLVStats **) g_ptr_array_free (ret, FALSE);
+}
+
+/* the thin-pool target only reports block counts, the data block size is in the table */
+static BDLVMThPoolStats* get_thpool_stats (struct dm_pool *pool, const gchar *map_name, const gchar *params, GError **error) {
+    struct dm_task *task = NULL;
+    struct dm_status_thin_pool *status = NULL;
+    guint64 start = 0;
+    guint64 length = 0;
+    gchar *type = NULL;
+    gchar *table_params = NULL;
+    guint64 block_size = 0;
+    BDLVMThPoolStats *ret = NULL;
+
+    if (dm_get_status_thin_pool (pool, params, &status) == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                     "Failed to get status of the thin pool map '%s'", map_name);
+        return NULL;
+    }
+
+    task = dm_task_create (DM_DEVICE_TABLE);
+    if (!task || dm_task_set_name (task, map_name) == 0 || dm_task_run (task) == 0) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                     "Failed to get table of the thin pool map '%s'", map_name);
+        if (task)
+            dm_task_destroy (task);
+        return NULL;
+    }
+
+    /* <metadata dev> <data dev> <data block size (in sectors)> ... */
+    dm_get_next_target (task, NULL, &start, &length, &type, &table_params);
+    if (!table_params || sscanf (table_params, "%*s %*s %" G_GUINT64_FORMAT, &block_size) != 1) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
+                     "Failed to get data block size of the thin pool map '%s'", map_name);
+        dm_task_destroy (task);
+        return NULL;
+    }
     dm_task_destroy (task);
-    dm_pool_destroy (pool);
+
+    ret = g_new0 (BDLVMThPoolStats, 1);
+    ret->data_used = status->used_data_blocks * block_size * SECTOR_SIZE;
+    ret->data_size = status->total_data_blocks * block_size * SECTOR_SIZE;
+    ret->metadata_used = status->used_metadata_blocks * THPOOL_MD_BLOCK_SIZE;
+    ret->metadata_size = status->total_metadata_blocks * THPOOL_MD_BLOCK_SIZE;
+    if (status->total_data_blocks > 0)
+        ret->data_percent = 100.0 * status->used_data_blocks / status->total_data_blocks;
+    if (status->total_metadata_blocks > 0)
+        ret->metadata_percent = 100.0 * status->used_metadata_blocks / status->total_metadata_blocks;
+    ret->read_only = status->read_only != 0;
+    ret->out_of_data_space = status->out_of_data_space != 0;
+    ret->needs_check = status->needs_check != 0;
+    ret->failed = status->fail != 0;
+
+    return ret;
+}
+
+static gboolean thpool_stats_map (struct dm_pool *pool, const gchar *map_name, const gchar *vg_name, const gchar *lv_name,
+                                  const struct dm_info *info G_GNUC_UNUSED, const gchar *type G_GNUC_UNUSED,
+                                  const gchar *params, gpointer user_data, GError **error G_GNUC_UNUSED) {
+    GPtrArray *pools = (GPtrArray *) user_data;
+    BDLVMThPoolStats *stats = NULL;
+    GError *l_error = NULL;
+
+    /* a failed pool (or a map being removed right now) shouldn't make the
+       stats of all the other pools unavailable */
+    stats = get_thpool_stats (pool, map_name, params, &l_error);
+    if (!stats) {
+        bd_utils_log_format (BD_UTILS_LOG_DEBUG, "Skipping the thin pool map '%s': %s", map_name, l_error->message);
+        g_clear_error (&l_error);
+        return TRUE;
+    }
+
+    stats->vg_name = g_strdup (vg_name);
+    stats->pool_name = g_strdup (lv_name);
+    g_ptr_array_add (pools, stats);
+
+    return TRUE;
+}
+
+/**
+ * bd_lvm_thpool_stats_all:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Gets data and metadata usage of all the active thin pools in the system
+ * directly from device mapper (one status query for every DM map), without
+ * running any LVM command. Thin pools the stats of which cannot be read (e.g.
+ * failed thin pools or thin pools being removed at the moment) are skipped.
+ *
+ * Returns: (array zero-terminated=1): stats for all the active thin pools or
+ *          %NULL in case of error
+ *
+ * Tech category: %BD_LVM_TECH_THIN-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMThPoolStats** bd_lvm_thpool_stats_all (GError **error) {
+    GPtrArray *ret = NULL;
+
+    /* thin pool maps are either "vg-pool-tpool" or just "vg-pool" */
+    ret = g_ptr_array_new_with_free_func ((GDestroyNotify) bd_lvm_thpool_stats_free);
+    if (!foreach_lvm_dm_target ("thin-pool", thpool_stats_map, ret, error)) {
+        g_ptr_array_free (ret, TRUE);
+        return NULL;
+    }
+
+    g_ptr_array_set_free_func (ret, NULL);
+    g_ptr_array_add (ret, NULL);
+    return (BDLVMThPoolStats **) g_ptr_array_free (ret, FALSE);
+}
+
+static gboolean thpool_over_threshold (const BDLVMThPoolStats *stats, gdouble data_threshold, gdouble metadata_threshold) {
+    return stats->out_of_data_space ||
+           (data_threshold > 0 && stats->data_percent >= data_threshold) ||
+           (metadata_threshold > 0 && stats->metadata_percent >= metadata_threshold);
+}
+
+/* lets bd_lvm_thpool_monitor() sleep between the checks and still stop right away when cancelled */
+typedef struct ThPoolMonitorWait {
+    GMutex lock;
+    GCond cond;
+    gboolean cancelled;
+} ThPoolMonitorWait;
+
+static void thpool_monitor_cancelled (GCancellable *cancellable G_GNUC_UNUSED, gpointer user_data) {
+    ThPoolMonitorWait *state = (ThPoolMonitorWait *) user_data;
+
+    g_mutex_lock (&(state->lock));
+    state->cancelled = TRUE;
+    g_cond_signal (&(state->cond));
+    g_mutex_unlock (&(state->lock));
+}
+
+/* waits for @interval seconds or until @state is cancelled */
+static void thpool_monitor_wait (ThPoolMonitorWait *state, guint interval) {
+    gint64 end_time = g_get_monotonic_time () + (gint64) interval * G_TIME_SPAN_SECOND;
+
+    g_mutex_lock (&(state->lock));
+    /* g_cond_wait_until() returns FALSE once the time is up, it may also wake up spuriously */
+    while (!state->cancelled && g_cond_wait_until (&(state->cond), &(state->lock), end_time))
+        ;
+    g_mutex_unlock (&(state->lock));
+}
+
+/**
+ * bd_lvm_thpool_monitor:
+ * @data_threshold: data usage (in percents) to report or 0 to ignore data usage
+ * @metadata_threshold: metadata usage (in percents) to report or 0 to ignore
+ *                      metadata usage
+ * @interval: number of seconds between the checks
+ * @count: number of checks to do or 0 to monitor until @callback returns %FALSE
+ *         or @cancellable is cancelled
+ * @cancellable: (nullable): a #GCancellable to stop the monitoring
+ * @callback: (scope call): function to call for thin pools crossing the thresholds
+ * @user_data: (closure callback): data to pass to @callback
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Checks usage of all the active thin pools every @interval seconds (see
+ * bd_lvm_thpool_stats_all()) and calls @callback for every thin pool that
+ * reached @data_threshold or @metadata_threshold or ran out of data space
+ * since the previous check. A thin pool is reported again only after its usage
+ * dropped below the thresholds in the meantime. Cancelling @cancellable stops
+ * the monitoring right away, even in the middle of waiting for the next check,
+ * and @error is set to %G_IO_ERROR_CANCELLED.
+ *
+ * Returns: whether the monitoring finished successfully (after @count checks or
+ *          when @callback returned %FALSE) or not
+ *
+ * Tech category: %BD_LVM_TECH_THIN-%BD_LVM_TECH_MODE_QUERY
+ */
+gboolean bd_lvm_thpool_monitor (gdouble data_threshold, gdouble metadata_threshold, guint interval, guint count, GCancellable *cancellable, BDLVMThPoolMonitorFunc callback, gpointer user_data, GError **error) {
+    BDLVMThPoolStats **stats = NULL;
+    BDLVMThPoolStats **stats_p = NULL;
+    GHashTable *reported = NULL;
+    GHashTable *over = NULL;
+    gchar *key = NULL;
+    gboolean keep_going = TRUE;
+    guint n_checks = 0;
+    ThPoolMonitorWait wait_state;
+    gulong handler_id = 0;
+    gboolean ret = TRUE;
+
+    g_mutex_init (&(wait_state.lock));
+    g_cond_init (&(wait_state.cond));
+    wait_state.cancelled = FALSE;
+    if (cancellable)
+        /* called right away if already cancelled */
+        handler_id = g_cancellable_connect (cancellable, G_CALLBACK (thpool_monitor_cancelled), &wait_state, NULL);
+
+    /* thin pools that were over the thresholds at the previous check */
+    reported = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    while (keep_going && (count == 0 || n_checks < count)) {
+        /* the wait is cut short when @cancellable is cancelled */
+        if (n_checks > 0)
+            thpool_monitor_wait (&wait_state, interval);
+        if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+            ret = FALSE;
+            break;
+        }
+        n_checks++;
+
+        stats = bd_lvm_thpool_stats_all (error);
+        if (!stats) {
+            ret = FALSE;
+            break;
+        }
+
+        over = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+        for (stats_p = stats; *stats_p; stats_p++) {
+            if (!thpool_over_threshold (*stats_p, data_threshold, metadata_threshold))
+                continue;
+
+            key = g_strdup_printf ("%s/%s", (*stats_p)->vg_name, (*stats_p)->pool_name);
+            if (keep_going && !g_hash_table_contains (reported, key))
+                keep_going = callback (*stats_p, user_data);
+            g_hash_table_add (over, key);
+        }
+
+        for (stats_p = stats; *stats_p; stats_p++)
+            bd_lvm_thpool_stats_free (*stats_p);
+        g_free (stats);
+
+        /* pools that dropped below the thresholds (or disappeared) can be reported again */
+        g_hash_table_destroy (reported);
+        reported = over;
+    }
+
+    g_hash_table_destroy (reported);
+    /* waits for the handler if it's running in a different thread right now */
+    g_cancellable_disconnect (cancellable, handler_id);
+    g_cond_clear (&(wait_state.cond));
+    g_mutex_clear (&(wait_state.lock));
+
+    return ret;
+}
+
+static gboolean lvm_dm_state_map (struct dm_pool *pool G_GNUC_UNUSED, const gchar *map_name, const gchar *vg_name,
+                                  const gchar *lv_name G_GNUC_UNUSED, const struct dm_info *info,
+                                  const gchar *type G_GNUC_UNUSED, const gchar *params G_GNUC_UNUSED,
+                                  gpointer user_data, GError **error G_GNUC_UNUSED) {
+    GHashTable *vg_states = (GHashTable *) user_data;
+    GPtrArray *states = NULL;
+
+    states = g_hash_table_lookup (vg_states, vg_name);
+    if (!states) {
+        states = g_ptr_array_new_with_free_func (g_free);
+        g_hash_table_insert (vg_states, g_strdup (vg_name), states);
+    }
+    g_ptr_array_add (states, g_strdup_printf ("%s:%d:%d:%d:%d:%d:%"G_GUINT32_FORMAT,
+                                              map_name, info->open_count, info->suspended, info->read_only,
+                                              info->live_table, info->inactive_table, info->event_nr));
+
+    return TRUE;
+}
+
+static gint compare_strings (gconstpointer a, gconstpointer b) {
+    return g_strcmp0 (*((const gchar **) a), *((const gchar **) b));
+}
+
+/**
+ * get_lvm_dm_states: (skip)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Gets the state of the DM maps of the active LVs (open count, suspended and
+ * read-only flags, the tables loaded and the event counter) as one string for
+ * every VG with active LVs. The state changes with things that don't change
+ * the VG metadata (e.g. activation or opening an LV) so it can be used to
+ * check that the cached information about the LVs is still up to date.
+ *
+ * Returns: (transfer full): VG name -> state table or %NULL in case of error
+ */
+G_GNUC_INTERNAL GHashTable*
+get_lvm_dm_states (GError **error) {
+    GHashTable *vg_states = NULL;
+    GPtrArray *states = NULL;
+    GHashTable *ret = NULL;
+    GHashTableIter iter;
+    gpointer key = NULL;
+    gpointer value = NULL;
+
+    vg_states = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+    if (!foreach_lvm_dm_target (NULL, lvm_dm_state_map, vg_states, error)) {
+        g_hash_table_destroy (vg_states);
+        return NULL;
+    }
+
+    /* the maps are not listed in any particular order */
+    ret = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    g_hash_table_iter_init (&iter, vg_states);
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+        states = (GPtrArray *) value;
+        g_ptr_array_sort (states, (GCompareFunc) compare_strings);
+        g_ptr_array_add (states, NULL);
+        g_hash_table_insert (ret, g_strdup (key), g_strjoinv (",", (gchar **) states->pdata));
+    }
+    g_hash_table_destroy (vg_states);
 
     return ret;
 }
@@ -55,9 +55,10 @@
 #define CACHE_POOL_INTF LVM_BUS_NAME".CachePool"
 #define VDO_POOL_INTF LVM_BUS_NAME".VdoPool"
 #define DBUS_PROPS_IFACE "org.freedesktop.DBus.Properties"
-#define DBUS_INTRO_IFACE "org.freedesktop.DBus.Introspectable"
+#define DBUS_OBJ_MANAGER_IFACE "org.freedesktop.DBus.ObjectManager"
 #define METHOD_CALL_TIMEOUT 5000
-#define PROGRESS_WAIT 500 * 1000 /* microseconds */
+#define PROGRESS_WAIT 500 /* milliseconds */
+#define JOB_SIGNAL_TIMEOUT 5000 /* milliseconds */
 
 
 static GDBusConnection *bus = NULL;
@@ -80,6 +81,10 @@ GQuark bd_lvm_error_quark (void)
     return g_quark_from_static_string ("g-bd-lvm-error-quark");
 }
 
+void lvm_global_config_changed (void) {
+    /* nothing to do here, the config is passed to lvmdbusd with every call */
+}
+
 static gboolean setup_dbus_connection (GError **error) {
     gchar *addr = NULL;
 
@@ -220,6 +225,25 @@ void bd_lvm_close (void) {
     g_atomic_int_set (&avail_module_deps, 0);
 }
 
+/**
+ * bd_lvm_probe_deps:
+ *
+ * Checks all the runtime dependencies of the plugin concurrently so that later
+ * availability checks don't need to run them one by one. **This function is
+ * called automatically by the library's initialization functions if
+ * dependency probing is enabled (see bd_set_deps_probing()).**
+ *
+ */
+void bd_lvm_probe_deps (void) {
+    DepsProbe *probe = deps_probe_new ();
+
+    deps_probe_add_deps (probe, &avail_deps, deps, DEPS_LAST, &deps_check_lock);
+    deps_probe_add_dbus_deps (probe, &avail_dbus_deps, dbus_deps, DBUS_DEPS_LAST, &deps_check_lock);
+    deps_probe_add_features (probe, &avail_features, features, FEATURES_LAST, &deps_check_lock);
+    deps_probe_add_module_deps (probe, &avail_module_deps, module_deps, MODULE_DEPS_LAST, &deps_check_lock);
+    deps_probe_run (probe);
+}
+
 /**
  * bd_lvm_is_tech_avail:
  * @tech: the queried tech
@@ -264,41 +288,6 @@ gboolean bd_lvm_is_tech_avail (BDLVMTech tech, guint64 mode, GError **error) {
     }
 }
 
-static gchar** get_existing_objects (const gchar *obj_prefix, GError **error) {
-    GVariant *intro_v = NULL;
-    gchar *intro_data = NULL;
-    GDBusNodeInfo *info = NULL;
-    gchar **ret = NULL;
-    GDBusNodeInfo **nodes;
-    guint64 n_nodes = 0;
-    guint64 i = 0;
-
-    intro_v = g_dbus_connection_call_sync (bus, LVM_BUS_NAME, obj_prefix, DBUS_INTRO_IFACE,
-                                           "Introspect", NULL, NULL, G_DBUS_CALL_FLAGS_NONE,
-                                           -1, NULL, error);
-    if (!intro_v)
-        /* no introspection data, something went wrong (error must be set) */
-        return NULL;
-
-    g_variant_get (intro_v, "(s)", &intro_data);
-    g_variant_unref (intro_v);
-    info = g_dbus_node_info_new_for_xml (intro_data, error);
-    g_free (intro_data);
-
-    for (nodes = info->nodes; (*nodes); nodes++)
-        n_nodes++;
-
-    ret = g_new0 (gchar*, n_nodes + 1);
-    for (nodes = info->nodes, i=0; (*nodes); nodes++, i++) {
-        ret[i] = g_strdup_printf ("%s/%s", obj_prefix, ((*nodes)->path));
-    }
-    ret[i] = NULL;
-
-    g_dbus_node_info_unref (info);
-
-    return ret;
-}
-
 
 /**
  * get_object_path:
@@ -426,22 +415,18 @@ static gboolean unbox_params_and_add (GVariant *params, GVariantBuilder *builder
 }
 
 /**
- * call_lvm_method
- * @obj: lvmdbusd object path
- * @intf: interface to call @method on
- * @method: method to call
- * @params: parameters for @method
- * @extra_params: extra parameters for @method
+ * build_method_params: (skip)
+ * @params: parameters for the method
+ * @extra_params: extra parameters for the method
  * @extra_args: extra command line argument to be passed to the LVM command
- * @task_id: (out): task ID to watch progress of the operation
- * @progress_id: (out): progress ID to watch progress of the operation
  * @lock_config: whether to lock %global_config_lock or not (if %FALSE is given, caller is responsible
  *               for holding the lock for this call)
- * @error: (out) (optional): place to store error (if any)
  *
- * Returns: (transfer full): return value of @method (variant)
+ * Returns: (transfer floating): all the parameters for a call of an lvmdbusd
+ *                               method with the global config and extra
+ *                               parameters merged in
  */
-static GVariant* call_lvm_method (const gchar *obj, const gchar *intf, const gchar *method, GVariant *params, GVariant *extra_params, const BDExtraArg **extra_args, guint64 *task_id, guint64 *progress_id, gboolean lock_config, GError **error) {
+static GVariant* build_method_params (GVariant *params, GVariant *extra_params, const BDExtraArg **extra_args, gboolean lock_config) {
     GVariant *config = NULL;
     GVariant *devices = NULL;
     GVariant *param = NULL;
@@ -451,17 +436,11 @@ static GVariant* call_lvm_method (const gchar *obj, const gchar *intf, const gch
     GVariant *config_extra_params = NULL;
     GVariant *tmo = NULL;
     GVariant *all_params = NULL;
-    GVariant *ret = NULL;
-    gchar *params_str = NULL;
-    gchar *log_msg = NULL;
-    gchar *prog_msg = NULL;
     const BDExtraArg **extra_p = NULL;
     gboolean added_extra = FALSE;
 
-    if (!check_dbus_deps (&avail_dbus_deps, DBUS_DEPS_LVMDBUSD_MASK, dbus_deps, DBUS_DEPS_LAST, &deps_check_lock, error))
-        return NULL;
-
-    /* don't allow global config string changes during the run */
+    /* the global config is copied into the parameters so the lock is only
+       needed while they are being built, not for the call itself */
     if (lock_config)
         g_mutex_lock (&global_config_lock);
 
@@ -528,6 +507,40 @@ static GVariant* call_lvm_method (const gchar *obj, const gchar *intf, const gch
     all_params = g_variant_builder_end (&builder);
     g_variant_builder_clear (&builder);
 
+    if (lock_config)
+        g_mutex_unlock (&global_config_lock);
+
+    return all_params;
+}
+
+/**
+ * call_lvm_method
+ * @obj: lvmdbusd object path
+ * @intf: interface to call @method on
+ * @method: method to call
+ * @params: parameters for @method
+ * @extra_params: extra parameters for @method
+ * @extra_args: extra command line argument to be passed to the LVM command
+ * @task_id: (out): task ID to watch progress of the operation
+ * @progress_id: (out): progress ID to watch progress of the operation
+ * @lock_config: whether to lock %global_config_lock or not (if %FALSE is given, caller is responsible
+ *               for holding the lock for this call)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (transfer full): return value of @method (variant)
+ */
+static GVariant* call_lvm_method (const gchar *obj, const gchar *intf, const gchar *method, GVariant *params, GVariant *extra_params, const BDExtraArg **extra_args, guint64 *task_id, guint64 *progress_id, gboolean lock_config, GError **error) {
+    GVariant *all_params = NULL;
+    GVariant *ret = NULL;
+    gchar *params_str = NULL;
+    gchar *log_msg = NULL;
+    gchar *prog_msg = NULL;
+
+    if (!check_dbus_deps (&avail_dbus_deps, DBUS_DEPS_LVMDBUSD_MASK, dbus_deps, DBUS_DEPS_LAST, &deps_check_lock, error))
+        return NULL;
+
+    all_params = build_method_params (params, extra_params, extra_args, lock_config);
+
     params_str = g_variant_print (all_params, FALSE);
 
     *task_id = bd_utils_get_next_task_id ();
@@ -540,8 +553,6 @@ static GVariant* call_lvm_method (const gchar *obj, const gchar *intf, const gch
     ret = g_dbus_connection_call_sync (bus, LVM_BUS_NAME, obj, intf, method, all_params,
                                        NULL, G_DBUS_CALL_FLAGS_NONE, METHOD_CALL_TIMEOUT, NULL, error);
 
-    if (lock_config)
-         g_mutex_unlock (&global_config_lock);
     prog_msg = g_strdup_printf ("Started the '%s.%s' method on the '%s' object with the following parameters: '%s'",
                                intf, method, obj, params_str);
     g_free (params_str);
@@ -556,6 +567,72 @@ static GVariant* call_lvm_method (const gchar *obj, const gchar *intf, const gch
     return ret;
 }
 
+/* shared with the signal subscription which may outlive the waiting for the
+   job (the user data is only freed once the subscription is really gone) */
+typedef struct JobState {
+    gint ref_count;
+    gboolean unsubscribed;
+    gboolean got_signal;
+    gboolean completed;
+    gboolean progress_changed;
+    gboolean timed_out;
+    gdouble progress;
+} JobState;
+
+static JobState* job_state_new (void) {
+    JobState *state = g_new0 (JobState, 1);
+
+    state->ref_count = 1;
+    return state;
+}
+
+static gpointer job_state_ref (JobState *state) {
+    g_atomic_int_inc (&(state->ref_count));
+    return state;
+}
+
+static void job_state_unref (gpointer data) {
+    JobState *state = (JobState *) data;
+
+    if (g_atomic_int_dec_and_test (&(state->ref_count)))
+        g_free (state);
+}
+
+/* user_data_free_func of the signal subscription, run in the subscription's
+   main context */
+static void job_state_unsubscribed (gpointer data) {
+    JobState *state = (JobState *) data;
+
+    state->unsubscribed = TRUE;
+    job_state_unref (state);
+}
+
+static void job_properties_changed (GDBusConnection *connection G_GNUC_UNUSED, const gchar *sender_name G_GNUC_UNUSED,
+                                    const gchar *obj_path G_GNUC_UNUSED, const gchar *iface G_GNUC_UNUSED,
+                                    const gchar *signal_name G_GNUC_UNUSED, GVariant *params, gpointer user_data) {
+    JobState *state = (JobState *) user_data;
+    GVariant *changed = NULL;
+    gboolean completed = FALSE;
+
+    if (!g_variant_check_format_string (params, "(sa{sv}as)", FALSE))
+        return;
+
+    state->got_signal = TRUE;
+    g_variant_get (params, "(&s@a{sv}@as)", NULL, &changed, NULL);
+    if (g_variant_lookup (changed, "Complete", "b", &completed) && completed)
+        state->completed = TRUE;
+    if (g_variant_lookup (changed, "Percent", "d", &(state->progress)))
+        state->progress_changed = TRUE;
+    g_variant_unref (changed);
+}
+
+static gboolean job_wait_timeout (gpointer user_data) {
+    JobState *state = (JobState *) user_data;
+
+    state->timed_out = TRUE;
+    return G_SOURCE_REMOVE;
+}
+
 /**
  * call_lvm_method_sync
  * @obj: lvmdbusd object path
@@ -581,6 +658,10 @@ static gboolean call_lvm_method_sync (const gchar *obj, const gchar *intf, const
     gboolean completed = FALSE;
     gint64 error_code = 0;
     gchar *error_msg = NULL;
+    GMainContext *context = NULL;
+    GSource *timeout = NULL;
+    guint subscription = 0;
+    JobState *job_state = NULL;
     GError *l_error = NULL;
 
     ret = call_lvm_method (obj, intf, method, params, extra_params, extra_args, &log_task_id, &prog_id, lock_config, &l_error);
@@ -646,9 +727,49 @@ static gboolean call_lvm_method_sync (const gchar *obj, const gchar *intf, const
     bd_utils_log_task_status (log_task_id, log_msg);
     g_free (log_msg);
 
-    ret = NULL;
+    /* lvmdbusd announces changes of the job's state with the PropertiesChanged
+       signal, the subscription delivers it to our own main context so that we
+       can just wait for it here */
+    job_state = job_state_new ();
+    context = g_main_context_new ();
+    g_main_context_push_thread_default (context);
+    subscription = g_dbus_connection_signal_subscribe (bus, LVM_BUS_NAME, DBUS_PROPS_IFACE, "PropertiesChanged",
+                                                       task_path, JOB_INTF, G_DBUS_SIGNAL_FLAGS_NONE,
+                                                       job_properties_changed, job_state_ref (job_state),
+                                                       job_state_unsubscribed);
+    g_main_context_pop_thread_default (context);
+
+    /* the job may have finished before we subscribed to the signal */
+    ret = get_object_property (task_path, JOB_INTF, "Complete", &l_error);
+    if (ret) {
+        g_variant_get (ret, "b", &completed);
+        g_variant_unref (ret);
+        ret = NULL;
+    }
+
     while (!completed && !l_error) {
-        g_usleep (PROGRESS_WAIT);
+        /* lvmdbusd versions that don't emit the signal are polled, once a signal
+           arrives polling is only a fallback in case we miss the completion */
+        job_state->timed_out = FALSE;
+        timeout = g_timeout_source_new (job_state->got_signal ? JOB_SIGNAL_TIMEOUT : PROGRESS_WAIT);
+        g_source_set_callback (timeout, job_wait_timeout, job_state, NULL);
+        g_source_attach (timeout, context);
+        while (!job_state->completed && !job_state->progress_changed && !job_state->timed_out)
+            g_main_context_iteration (context, TRUE);
+        g_source_destroy (timeout);
+        g_source_unref (timeout);
+
+        if (job_state->completed) {
+            completed = TRUE;
+            break;
+        }
+
+        if (job_state->progress_changed) {
+            job_state->progress_changed = FALSE;
+            bd_utils_report_progress (prog_id, (gint) job_state->progress, NULL);
+            continue;
+        }
+
         ret = get_object_property (task_path, JOB_INTF, "Complete", &l_error);
         if (ret) {
             g_variant_get (ret, "b", &completed);
@@ -671,8 +792,17 @@ static gboolean call_lvm_method_sync (const gchar *obj, const gchar *intf, const
             bd_utils_log_task_status (log_task_id, log_msg);
             g_free (log_msg);
         }
-
     }
+
+    /* the subscription drops its reference of the state from an idle source
+       in our context once it's really gone, signals already queued for the
+       context are not delivered after unsubscribing */
+    g_dbus_connection_signal_unsubscribe (bus, subscription);
+    while (!job_state->unsubscribed)
+        g_main_context_iteration (context, TRUE);
+    g_main_context_unref (context);
+    job_state_unref (job_state);
+
     log_msg = g_strdup_printf ("Job '%s' finished", task_path);
     bd_utils_log_task_status (log_task_id, log_msg);
     g_free (log_msg);
@@ -870,31 +1000,146 @@ static GVariant* get_vg_properties (const gchar *vg_name, GError **error) {
     return ret;
 }
 
-static GVariant* get_lv_properties (const gchar *vg_name, const gchar *lv_name, GError **error) {
+static GVariant* get_vdo_properties (const gchar *vg_name, const gchar *pool_name, GError **error) {
     gchar *lvm_spec = NULL;
     GVariant *ret = NULL;
 
-    lvm_spec = g_strdup_printf ("%s/%s", vg_name, lv_name);
+    lvm_spec = g_strdup_printf ("%s/%s", vg_name, pool_name);
 
-    ret = get_lvm_object_properties (lvm_spec, LV_CMN_INTF, error);
+    ret = get_lvm_object_properties (lvm_spec, VDO_POOL_INTF, error);
     g_free (lvm_spec);
 
     return ret;
 }
 
-static GVariant* get_vdo_properties (const gchar *vg_name, const gchar *pool_name, GError **error) {
-    gchar *lvm_spec = NULL;
+/**
+ * get_managed_objects:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (transfer full): snapshot of all the objects exported by lvmdbusd as
+ *                           a hashtable of object path -> a{sa{sv}} variant with
+ *                           the properties of all the object's interfaces
+ */
+static GHashTable* get_managed_objects (GError **error) {
     GVariant *ret = NULL;
+    GVariant *objects = NULL;
+    GVariant *ifaces = NULL;
+    GVariantIter iter;
+    const gchar *obj_path = NULL;
+    GHashTable *table = NULL;
 
-    lvm_spec = g_strdup_printf ("%s/%s", vg_name, pool_name);
+    ret = g_dbus_connection_call_sync (bus, LVM_BUS_NAME, LVM_OBJ_PREFIX, DBUS_OBJ_MANAGER_IFACE,
+                                       "GetManagedObjects", NULL, G_VARIANT_TYPE ("(a{oa{sa{sv}}})"),
+                                       G_DBUS_CALL_FLAGS_NONE, METHOD_CALL_TIMEOUT, NULL, error);
+    if (!ret) {
+        g_prefix_error (error, "Failed to get the LVM objects: ");
+        return NULL;
+    }
 
-    ret = get_lvm_object_properties (lvm_spec, VDO_POOL_INTF, error);
-    g_free (lvm_spec);
+    objects = g_variant_get_child_value (ret, 0);
+    g_variant_unref (ret);
+
+    table = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+    g_variant_iter_init (&iter, objects);
+    while (g_variant_iter_next (&iter, "{&o@a{sa{sv}}}", &obj_path, &ifaces))
+        g_hash_table_insert (table, g_strdup (obj_path), ifaces);
+    g_variant_unref (objects);
+
+    return table;
+}
+
+static gint compare_object_paths (gconstpointer a, gconstpointer b) {
+    const gchar *path_a = *((const gchar **) a);
+    const gchar *path_b = *((const gchar **) b);
+    guint64 id_a = g_ascii_strtoull (strrchr (path_a, '/') + 1, NULL, 10);
+    guint64 id_b = g_ascii_strtoull (strrchr (path_b, '/') + 1, NULL, 10);
+
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+/**
+ * get_objects_by_prefix:
+ * @objects: snapshot of the lvmdbusd objects (see get_managed_objects())
+ * @obj_prefix: prefix of the object paths to get (e.g. %PV_OBJ_PREFIX)
+ *
+ * Returns: (transfer container): object paths from @objects under @obj_prefix
+ *                                in the order lvmdbusd created the objects in
+ */
+static GPtrArray* get_objects_by_prefix (GHashTable *objects, const gchar *obj_prefix) {
+    GPtrArray *ret = g_ptr_array_new ();
+    GHashTableIter iter;
+    gchar *obj_path = NULL;
+    gsize prefix_len = strlen (obj_prefix);
+
+    g_hash_table_iter_init (&iter, objects);
+    while (g_hash_table_iter_next (&iter, (gpointer *) &obj_path, NULL))
+        if (g_str_has_prefix (obj_path, obj_prefix) && obj_path[prefix_len] == '/')
+            g_ptr_array_add (ret, obj_path);
+
+    g_ptr_array_sort (ret, compare_object_paths);
 
     return ret;
 }
 
-static BDLVMPVdata* get_pv_data_from_props (GVariant *props, GError **error G_GNUC_UNUSED) {
+/**
+ * lookup_object_properties:
+ * @objects: (nullable): snapshot of the lvmdbusd objects (see get_managed_objects())
+ * @obj_path: lvmdbusd object path
+ * @iface: interface on @obj_path object
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (transfer full): properties of @iface on the @obj_path object from
+ *                           @objects or from lvmdbusd if @objects is %NULL
+ */
+static GVariant* lookup_object_properties (GHashTable *objects, const gchar *obj_path, const gchar *iface, GError **error) {
+    GVariant *ifaces = NULL;
+    GVariant *ret = NULL;
+
+    if (!objects)
+        return get_object_properties (obj_path, iface, error);
+
+    ifaces = g_hash_table_lookup (objects, obj_path);
+    if (ifaces)
+        ret = g_variant_lookup_value (ifaces, iface, G_VARIANT_TYPE_VARDICT);
+    if (!ret)
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOEXIST,
+                     "Failed to get properties of the %s object: no %s interface", obj_path, iface);
+
+    return ret;
+}
+
+/**
+ * lookup_object_property:
+ * @objects: (nullable): snapshot of the lvmdbusd objects (see get_managed_objects())
+ * @obj_path: lvmdbusd object path
+ * @iface: interface on @obj_path object
+ * @property: property to get from @obj_path and @iface
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (transfer full): value of @property from @objects or from lvmdbusd
+ *                           if @objects is %NULL
+ */
+static GVariant* lookup_object_property (GHashTable *objects, const gchar *obj_path, const gchar *iface, const gchar *property, GError **error) {
+    GVariant *props = NULL;
+    GVariant *ret = NULL;
+
+    if (!objects)
+        return get_object_property (obj_path, iface, property, error);
+
+    props = lookup_object_properties (objects, obj_path, iface, error);
+    if (!props)
+        return NULL;
+
+    ret = g_variant_lookup_value (props, property, NULL);
+    g_variant_unref (props);
+    if (!ret)
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_NOEXIST,
+                     "Failed to get %s property of the %s object", property, obj_path);
+
+    return ret;
+}
+
+static BDLVMPVdata* get_pv_data_from_props (GVariant *props, GHashTable *objects, GError **error G_GNUC_UNUSED) {
     BDLVMPVdata *data = g_new0 (BDLVMPVdata, 1);
     GVariantDict dict;
     gchar *path = NULL;
@@ -933,7 +1178,7 @@ static BDLVMPVdata* get_pv_data_from_props (GVariant *props, GError **error G_GN
         return data;
     }
 
-    vg_props = get_object_properties (path, VG_INTF, &l_error);
+    vg_props = lookup_object_properties (objects, path, VG_INTF, &l_error);
     g_variant_dict_clear (&dict);
     if (!vg_props) {
         if (l_error) {
@@ -997,49 +1242,32 @@ static BDLVMVGdata* get_vg_data_from_props (GVariant *props, GError **error G_GN
     return data;
 }
 
-static gchar* _lvm_data_lv_name (const gchar *vg_name, const gchar *lv_name, GError **error) {
+static gchar* lv_data_lv_name (GHashTable *objects, const gchar *obj_path, const gchar *segtype, GError **error) {
     GVariant *prop = NULL;
-    gchar *obj_id = NULL;
-    gchar *obj_path = NULL;
+    gchar *data_lv_path = NULL;
     gchar *ret = NULL;
-    gchar *segtype = NULL;
-
-    obj_id = g_strdup_printf ("%s/%s", vg_name, lv_name);
-    obj_path = get_object_path (obj_id, error);
-    g_free (obj_id);
-    if (!obj_path)
-        return NULL;
-
-    prop = get_lv_property (vg_name, lv_name, "SegType", error);
-    if (!prop)
-        return NULL;
-    g_variant_get_child (prop, 0, "s", &segtype);
-    g_variant_unref (prop);
 
     if (g_strcmp0 (segtype, "thin-pool") == 0)
-        prop = get_object_property (obj_path, THPOOL_INTF, "DataLv", NULL);
+        prop = lookup_object_property (objects, obj_path, THPOOL_INTF, "DataLv", NULL);
     else if (g_strcmp0 (segtype, "cache-pool") == 0)
-        prop = get_object_property (obj_path, CACHE_POOL_INTF, "DataLv", NULL);
+        prop = lookup_object_property (objects, obj_path, CACHE_POOL_INTF, "DataLv", NULL);
     else if (g_strcmp0 (segtype, "vdo-pool") == 0)
-        prop = get_object_property (obj_path, VDO_POOL_INTF, "DataLv", NULL);
+        prop = lookup_object_property (objects, obj_path, VDO_POOL_INTF, "DataLv", NULL);
 
-    g_free (segtype);
-    g_free (obj_path);
     if (!prop)
         return NULL;
-    g_variant_get (prop, "o", &obj_path);
+    g_variant_get (prop, "o", &data_lv_path);
     g_variant_unref (prop);
 
-    if (g_strcmp0 (obj_path, "/") == 0) {
-        /* no origin LV */
-        g_free (obj_path);
+    if (g_strcmp0 (data_lv_path, "/") == 0) {
+        /* no data LV */
+        g_free (data_lv_path);
         return NULL;
     }
-    prop = get_object_property (obj_path, LV_CMN_INTF, "Name", error);
-    if (!prop) {
-        g_free (obj_path);
+    prop = lookup_object_property (objects, data_lv_path, LV_CMN_INTF, "Name", error);
+    g_free (data_lv_path);
+    if (!prop)
         return NULL;
-    }
 
     g_variant_get (prop, "s", &ret);
     g_variant_unref (prop);
@@ -1047,37 +1275,28 @@ static gchar* _lvm_data_lv_name (const gchar *vg_name, const gchar *lv_name, GEr
     return g_strstrip (g_strdelimit (ret, "[]", ' '));
 }
 
-static gchar* _lvm_metadata_lv_name (const gchar *vg_name, const gchar *lv_name, GError **error) {
+static gchar* lv_metadata_lv_name (GHashTable *objects, const gchar *obj_path, GError **error) {
     GVariant *prop = NULL;
-    gchar *obj_id = NULL;
-    gchar *obj_path = NULL;
+    gchar *metadata_lv_path = NULL;
     gchar *ret = NULL;
 
-    obj_id = g_strdup_printf ("%s/%s", vg_name, lv_name);
-    obj_path = get_object_path (obj_id, error);
-    g_free (obj_id);
-    if (!obj_path)
-        return NULL;
-
-    prop = get_object_property (obj_path, THPOOL_INTF, "MetaDataLv", NULL);
+    prop = lookup_object_property (objects, obj_path, THPOOL_INTF, "MetaDataLv", NULL);
     if (!prop)
-        prop = get_object_property (obj_path, CACHE_POOL_INTF, "MetaDataLv", NULL);
-    g_free (obj_path);
+        prop = lookup_object_property (objects, obj_path, CACHE_POOL_INTF, "MetaDataLv", NULL);
     if (!prop)
         return NULL;
-    g_variant_get (prop, "o", &obj_path);
+    g_variant_get (prop, "o", &metadata_lv_path);
     g_variant_unref (prop);
 
-    if (g_strcmp0 (obj_path, "/") == 0) {
-        /* no origin LV */
-        g_free (obj_path);
+    if (g_strcmp0 (metadata_lv_path, "/") == 0) {
+        /* no metadata LV */
+        g_free (metadata_lv_path);
         return NULL;
     }
-    prop = get_object_property (obj_path, LV_CMN_INTF, "Name", error);
-    if (!prop) {
-        g_free (obj_path);
+    prop = lookup_object_property (objects, metadata_lv_path, LV_CMN_INTF, "Name", error);
+    g_free (metadata_lv_path);
+    if (!prop)
         return NULL;
-    }
 
     g_variant_get (prop, "s", &ret);
     g_variant_unref (prop);
@@ -1085,7 +1304,7 @@ static gchar* _lvm_metadata_lv_name (const gchar *vg_name, const gchar *lv_name,
     return g_strstrip (g_strdelimit (ret, "[]", ' '));
 }
 
-static BDLVMSEGdata** _lvm_segs (const gchar *vg_name, const gchar *lv_name, GError **error) {
+static BDLVMSEGdata** lv_segs (GHashTable *objects, const gchar *obj_path, GError **error) {
     GVariant *prop = NULL;
     BDLVMSEGdata **segs;
     gsize n_segs;
@@ -1096,7 +1315,7 @@ static BDLVMSEGdata** _lvm_segs (const gchar *vg_name, const gchar *lv_name, GEr
     guint64 pv_first_pe, pv_last_pe;
     int i;
 
-    prop = get_lv_property (vg_name, lv_name, "Devices", error);
+    prop = lookup_object_property (objects, obj_path, LV_CMN_INTF, "Devices", error);
     if (!prop)
         return NULL;
 
@@ -1118,7 +1337,7 @@ static BDLVMSEGdata** _lvm_segs (const gchar *vg_name, const gchar *lv_name, GEr
     i = 0;
     g_variant_iter_init (&iter, prop);
     while (g_variant_iter_next (&iter, "(&o@a(tts))", &pv, &pv_segs)) {
-      pv_name_prop = get_object_property (pv, PV_INTF, "Name", NULL);
+      pv_name_prop = lookup_object_property (objects, pv, PV_INTF, "Name", NULL);
       if (pv_name_prop) {
         g_variant_get (pv_name_prop, "&s", &pv_name);
         g_variant_iter_init (&iter2, pv_segs);
@@ -1138,9 +1357,9 @@ static BDLVMSEGdata** _lvm_segs (const gchar *vg_name, const gchar *lv_name, GEr
     return segs;
 }
 
-static void _lvm_data_and_metadata_lvs (const gchar *vg_name, const gchar *lv_name,
-                                        gchar ***data_lvs_ret, gchar ***metadata_lvs_ret,
-                                        GError **error) {
+static void lv_data_and_metadata_lvs (GHashTable *objects, const gchar *obj_path,
+                                      gchar ***data_lvs_ret, gchar ***metadata_lvs_ret,
+                                      GError **error) {
   GVariant *prop;
   gsize n_hidden_lvs;
   gchar **data_lvs;
@@ -1154,7 +1373,7 @@ static void _lvm_data_and_metadata_lvs (const gchar *vg_name, const gchar *lv_na
   gchar *sublv_name;
   const gchar *role;
 
-  prop = get_lv_property (vg_name, lv_name, "HiddenLvs", error);
+  prop = lookup_object_property (objects, obj_path, LV_CMN_INTF, "HiddenLvs", error);
   if (!prop) {
     *data_lvs_ret = NULL;
     *metadata_lvs_ret = NULL;
@@ -1169,9 +1388,9 @@ static void _lvm_data_and_metadata_lvs (const gchar *vg_name, const gchar *lv_na
   i_metadata = 0;
   g_variant_iter_init (&iter, prop);
   while (g_variant_iter_next (&iter, "&o", &sublv)) {
-    sublv_roles_prop = get_object_property (sublv, LV_INTF, "Roles", NULL);
+    sublv_roles_prop = lookup_object_property (objects, sublv, LV_INTF, "Roles", NULL);
     if (sublv_roles_prop) {
-      sublv_name_prop = get_object_property (sublv, LV_INTF, "Name", NULL);
+      sublv_name_prop = lookup_object_property (objects, sublv, LV_INTF, "Name", NULL);
       if (sublv_name_prop) {
         g_variant_get (sublv_name_prop, "s", &sublv_name);
         if (sublv_name) {
@@ -1203,7 +1422,43 @@ static void _lvm_data_and_metadata_lvs (const gchar *vg_name, const gchar *lv_na
   return;
 }
 
-static BDLVMLVdata* get_lv_data_from_props (GVariant *props, GError **error G_GNUC_UNUSED) {
+/**
+ * get_lv_related_data: (skip)
+ * @objects: (nullable): snapshot of the lvmdbusd objects or %NULL to query lvmdbusd
+ * @obj_path: lvmdbusd object path of the LV described by @data
+ * @data: LV data to fill the related data in
+ * @tree: whether to also fill in the segments and the data and metadata sub-LVs
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Fills in the names of the data and metadata LVs of pools (and the segments
+ * and sub-LVs if @tree is %TRUE) into @data.
+ */
+static gboolean get_lv_related_data (GHashTable *objects, const gchar *obj_path, BDLVMLVdata *data, gboolean tree, GError **error) {
+    GError *l_error = NULL;
+
+    if ((g_strcmp0 (data->segtype, "thin-pool") == 0) ||
+        (g_strcmp0 (data->segtype, "cache-pool") == 0)) {
+        data->data_lv = lv_data_lv_name (objects, obj_path, data->segtype, &l_error);
+        if (!l_error)
+            data->metadata_lv = lv_metadata_lv_name (objects, obj_path, &l_error);
+    } else if (g_strcmp0 (data->segtype, "vdo-pool") == 0)
+        data->data_lv = lv_data_lv_name (objects, obj_path, data->segtype, &l_error);
+
+    if (tree && !l_error) {
+        data->segs = lv_segs (objects, obj_path, &l_error);
+        if (!l_error)
+            lv_data_and_metadata_lvs (objects, obj_path, &data->data_lvs, &data->metadata_lvs, &l_error);
+    }
+
+    if (l_error) {
+        g_propagate_error (error, l_error);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static BDLVMLVdata* get_lv_data_from_props (GVariant *props, GHashTable *objects, GError **error G_GNUC_UNUSED) {
     BDLVMLVdata *data = g_new0 (BDLVMLVdata, 1);
     GVariantDict dict;
     GVariant *value = NULL;
@@ -1249,7 +1504,7 @@ static BDLVMLVdata* get_lv_data_from_props (GVariant *props, GError **error G_GN
 
     /* returns an object path for the VG */
     g_variant_dict_lookup (&dict, "Vg", "o", &path);
-    name = get_object_property (path, VG_INTF, "Name", NULL);
+    name = lookup_object_property (objects, path, VG_INTF, "Name", NULL);
     g_free (path);
     if (name) {
         g_variant_get (name, "s", &(data->vg_name));
@@ -1258,7 +1513,7 @@ static BDLVMLVdata* get_lv_data_from_props (GVariant *props, GError **error G_GN
 
     g_variant_dict_lookup (&dict, "OriginLv", "o", &path);
     if (g_strcmp0 (path, "/") != 0) {
-        name = get_object_property (path, LV_CMN_INTF, "Name", NULL);
+        name = lookup_object_property (objects, path, LV_CMN_INTF, "Name", NULL);
         if (name) {
             g_variant_get (name, "s", &(data->origin));
             g_variant_unref (name);
@@ -1269,7 +1524,7 @@ static BDLVMLVdata* get_lv_data_from_props (GVariant *props, GError **error G_GN
 
     g_variant_dict_lookup (&dict, "PoolLv", "o", &path);
     if (g_strcmp0 (path, "/") != 0) {
-        name = get_object_property (path, LV_CMN_INTF, "Name", NULL);
+        name = lookup_object_property (objects, path, LV_CMN_INTF, "Name", NULL);
         if (name) {
             g_variant_get (name, "s", &(data->pool_lv));
             g_variant_unref (name);
@@ -1280,7 +1535,7 @@ static BDLVMLVdata* get_lv_data_from_props (GVariant *props, GError **error G_GN
 
     g_variant_dict_lookup (&dict, "MovePv", "o", &path);
     if (path && g_strcmp0 (path, "/") != 0) {
-        name = get_object_property (path, PV_INTF, "Name", NULL);
+        name = lookup_object_property (objects, path, PV_INTF, "Name", NULL);
         if (name) {
             g_variant_get (name, "s", &(data->move_pv));
             g_variant_unref (name);
@@ -1775,63 +2030,67 @@ BDLVMPVdata* bd_lvm_pvinfo (const gchar *device, GError **error) {
         /* the error is already populated */
         return NULL;
 
-    ret = get_pv_data_from_props (props, error);
+    ret = get_pv_data_from_props (props, NULL, error);
     g_variant_unref (props);
 
     return ret;
 }
 
 /**
- * bd_lvm_pvs:
+ * get_pvs: (skip)
+ * @objects: snapshot of the lvmdbusd objects (see get_managed_objects())
  * @error: (out) (optional): place to store error (if any)
  *
- * Returns: (array zero-terminated=1): information about PVs found in the system
- *
- * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ * Assembles the PVs (joined with their VGs) from @objects.
  */
-BDLVMPVdata** bd_lvm_pvs (GError **error) {
-    gchar **objects = NULL;
-    guint64 n_pvs = 0;
+static BDLVMPVdata** get_pvs (GHashTable *objects, GError **error) {
+    GPtrArray *paths = NULL;
     GVariant *props = NULL;
     BDLVMPVdata **ret = NULL;
-    guint64 i = 0;
-    GError *l_error = NULL;
-
-    objects = get_existing_objects (PV_OBJ_PREFIX, &l_error);
-    if (!objects) {
-        if (!l_error) {
-            /* no PVs */
-            ret = g_new0 (BDLVMPVdata*, 1);
-            ret[0] = NULL;
-            return ret;
-        } else {
-            g_propagate_error (error, l_error);
-            return NULL;
-        }
-    }
+    guint i = 0;
 
-    n_pvs = g_strv_length ((gchar **) objects);
+    paths = get_objects_by_prefix (objects, PV_OBJ_PREFIX);
 
     /* now create the return value -- NULL-terminated array of BDLVMPVdata */
-    ret = g_new0 (BDLVMPVdata*, n_pvs + 1);
-    for (i=0; i < n_pvs; i++) {
-        props = get_object_properties (objects[i], PV_INTF, error);
+    ret = g_new0 (BDLVMPVdata*, paths->len + 1);
+    for (i=0; i < paths->len; i++) {
+        props = lookup_object_properties (objects, paths->pdata[i], PV_INTF, error);
         if (!props) {
-            g_strfreev (objects);
+            g_ptr_array_free (paths, TRUE);
+            for (guint j = 0; j < i; j++)
+                bd_lvm_pvdata_free (ret[j]);
             g_free (ret);
             return NULL;
         }
-        ret[i] = get_pv_data_from_props (props, error);
+        ret[i] = get_pv_data_from_props (props, objects, error);
         g_variant_unref (props);
-        if (!(ret[i])) {
-            g_strfreev (objects);
-            g_free (ret);
-            return NULL;
-        }
     }
     ret[i] = NULL;
 
-    g_strfreev (objects);
+    g_ptr_array_free (paths, TRUE);
+    return ret;
+}
+
+/**
+ * bd_lvm_pvs:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): information about PVs found in the system
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMPVdata** bd_lvm_pvs (GError **error) {
+    GHashTable *objects = NULL;
+    BDLVMPVdata **ret = NULL;
+
+    /* get all the objects in one call and join PVs with their VGs in memory */
+    objects = get_managed_objects (error);
+    if (!objects)
+        return NULL;
+
+    ret = get_pvs (objects, error);
+    g_hash_table_destroy (objects);
+
     return ret;
 }
 
@@ -2142,56 +2401,59 @@ BDLVMVGdata* bd_lvm_vginfo (const gchar *vg_name, GError **error) {
 }
 
 /**
- * bd_lvm_vgs:
+ * get_vgs: (skip)
+ * @objects: snapshot of the lvmdbusd objects (see get_managed_objects())
  * @error: (out) (optional): place to store error (if any)
  *
- * Returns: (array zero-terminated=1): information about VGs found in the system
- *
- * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ * Assembles the VGs from @objects.
  */
-BDLVMVGdata** bd_lvm_vgs (GError **error) {
-    gchar **objects = NULL;
-    guint64 n_vgs = 0;
+static BDLVMVGdata** get_vgs (GHashTable *objects, GError **error) {
+    GPtrArray *paths = NULL;
     GVariant *props = NULL;
     BDLVMVGdata **ret = NULL;
-    guint64 i = 0;
-    GError *l_error = NULL;
+    guint i = 0;
 
-    objects = get_existing_objects (VG_OBJ_PREFIX, &l_error);
-    if (!objects) {
-        if (!l_error) {
-            /* no VGs */
-            ret = g_new0 (BDLVMVGdata*, 1);
-            ret[0] = NULL;
-            return ret;
-        } else {
-            g_propagate_error (error, l_error);
-            return NULL;
-        }
-    }
-
-    n_vgs = g_strv_length ((gchar **) objects);
+    paths = get_objects_by_prefix (objects, VG_OBJ_PREFIX);
 
     /* now create the return value -- NULL-terminated array of BDLVMVGdata */
-    ret = g_new0 (BDLVMVGdata*, n_vgs + 1);
-    for (i=0; i < n_vgs; i++) {
-        props = get_object_properties (objects[i], VG_INTF, error);
+    ret = g_new0 (BDLVMVGdata*, paths->len + 1);
+    for (i=0; i < paths->len; i++) {
+        props = lookup_object_properties (objects, paths->pdata[i], VG_INTF, error);
         if (!props) {
-            g_strfreev (objects);
+            g_ptr_array_free (paths, TRUE);
+            for (guint j = 0; j < i; j++)
+                bd_lvm_vgdata_free (ret[j]);
             g_free (ret);
             return NULL;
         }
         ret[i] = get_vg_data_from_props (props, error);
         g_variant_unref (props);
-        if (!(ret[i])) {
-            g_strfreev (objects);
-            g_free (ret);
-            return NULL;
-        }
     }
     ret[i] = NULL;
 
-    g_strfreev (objects);
+    g_ptr_array_free (paths, TRUE);
+    return ret;
+}
+
+/**
+ * bd_lvm_vgs:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): information about VGs found in the system
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVGdata** bd_lvm_vgs (GError **error) {
+    GHashTable *objects = NULL;
+    BDLVMVGdata **ret = NULL;
+
+    objects = get_managed_objects (error);
+    if (!objects)
+        return NULL;
+
+    ret = get_vgs (objects, error);
+    g_hash_table_destroy (objects);
+
     return ret;
 }
 
@@ -2234,30 +2496,437 @@ gchar* bd_lvm_lvorigin (const gchar *vg_name, const gchar *lv_name, GError **err
     return ret;
 }
 
+typedef struct LVMBatch LVMBatch;
+
+/* one method call of a batch run by call_lvm_methods_batch() */
+typedef struct LVMBatchCall {
+    LVMBatch *batch;
+    gchar *obj;
+    const gchar *intf;
+    const gchar *method;
+    GVariant *params;
+    gchar *job_path;
+    gboolean done;
+    GError *error;
+} LVMBatchCall;
+
+/* shared with the signal subscription the same way as JobState */
+struct LVMBatch {
+    gint ref_count;
+    gboolean unsubscribed;
+    guint pending_calls;
+    GHashTable *jobs;
+    gboolean got_signal;
+    gboolean timed_out;
+};
+
+static LVMBatch* lvm_batch_new (void) {
+    LVMBatch *batch = g_new0 (LVMBatch, 1);
+
+    batch->ref_count = 1;
+    batch->jobs = g_hash_table_new (g_str_hash, g_str_equal);
+    return batch;
+}
+
+static gpointer lvm_batch_ref (LVMBatch *batch) {
+    g_atomic_int_inc (&(batch->ref_count));
+    return batch;
+}
+
+static void lvm_batch_unref (gpointer data) {
+    LVMBatch *batch = (LVMBatch *) data;
+
+    if (g_atomic_int_dec_and_test (&(batch->ref_count))) {
+        g_hash_table_destroy (batch->jobs);
+        g_free (batch);
+    }
+}
+
+/* user_data_free_func of the signal subscription, see job_state_unsubscribed() */
+static void lvm_batch_unsubscribed (gpointer data) {
+    LVMBatch *batch = (LVMBatch *) data;
+
+    batch->unsubscribed = TRUE;
+    lvm_batch_unref (batch);
+}
+
+static void lvm_batch_call_clear (LVMBatchCall *call) {
+    g_free (call->obj);
+    if (call->params)
+        g_variant_unref (call->params);
+    g_free (call->job_path);
+    g_clear_error (&(call->error));
+}
+
+static void batch_call_done (GObject *source G_GNUC_UNUSED, GAsyncResult *res, gpointer user_data) {
+    LVMBatchCall *call = (LVMBatchCall *) user_data;
+    GVariant *ret = NULL;
+    gchar *obj_path = NULL;
+    gchar *job_path = NULL;
+
+    call->batch->pending_calls--;
+
+    ret = g_dbus_connection_call_finish (bus, res, &(call->error));
+    if (!ret) {
+        g_prefix_error (&(call->error), "Failed to call the '%s' method on the '%s' object: ", call->method, call->obj);
+        call->done = TRUE;
+        return;
+    }
+
+    if (g_variant_check_format_string (ret, "((oo))", TRUE))
+        g_variant_get (ret, "((oo))", &obj_path, &job_path);
+    else if (g_variant_check_format_string (ret, "(o)", TRUE))
+        g_variant_get (ret, "(o)", &job_path);
+    else
+        g_set_error_literal (&(call->error), BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                             "Failed to parse the returned value!");
+    g_variant_unref (ret);
+
+    if (call->error || (obj_path && g_strcmp0 (obj_path, "/") != 0))
+        /* failed or got a valid result right away */
+        call->done = TRUE;
+    else if (g_strcmp0 (job_path, "/") != 0) {
+        call->job_path = job_path;
+        job_path = NULL;
+        g_hash_table_insert (call->batch->jobs, call->job_path, call);
+    } else {
+        if (obj_path)
+            g_set_error (&(call->error), BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                         "Running '%s' method on the '%s' object failed: %s",
+                         call->method, call->obj, "Task finished without result and without job started");
+        call->done = TRUE;
+    }
+
+    g_free (obj_path);
+    g_free (job_path);
+}
+
+static void batch_job_properties_changed (GDBusConnection *connection G_GNUC_UNUSED, const gchar *sender_name G_GNUC_UNUSED,
+                                          const gchar *obj_path, const gchar *iface G_GNUC_UNUSED,
+                                          const gchar *signal_name G_GNUC_UNUSED, GVariant *params, gpointer user_data) {
+    LVMBatch *batch = (LVMBatch *) user_data;
+    GVariant *changed = NULL;
+    gboolean completed = FALSE;
+
+    if (!g_variant_check_format_string (params, "(sa{sv}as)", FALSE))
+        return;
+
+    batch->got_signal = TRUE;
+    if (!g_hash_table_contains (batch->jobs, obj_path))
+        return;
+
+    g_variant_get (params, "(&s@a{sv}@as)", NULL, &changed, NULL);
+    if (g_variant_lookup (changed, "Complete", "b", &completed) && completed)
+        g_hash_table_remove (batch->jobs, obj_path);
+    g_variant_unref (changed);
+}
+
+static gboolean batch_wait_timeout (gpointer user_data) {
+    LVMBatch *batch = (LVMBatch *) user_data;
+
+    batch->timed_out = TRUE;
+    return G_SOURCE_REMOVE;
+}
+
+/* checks the state of all the running jobs of @batch with a single call */
+static gboolean poll_batch_jobs (LVMBatch *batch, GError **error) {
+    GHashTable *objects = NULL;
+    GHashTableIter iter;
+    const gchar *job_path = NULL;
+    GVariant *props = NULL;
+    gboolean completed = FALSE;
+
+    objects = get_managed_objects (error);
+    if (!objects)
+        return FALSE;
+
+    g_hash_table_iter_init (&iter, batch->jobs);
+    while (g_hash_table_iter_next (&iter, (gpointer *) &job_path, NULL)) {
+        props = lookup_object_properties (objects, job_path, JOB_INTF, NULL);
+        completed = TRUE;
+        if (props) {
+            g_variant_lookup (props, "Complete", "b", &completed);
+            g_variant_unref (props);
+        }
+        /* a job that disappeared is not running anymore either */
+        if (completed)
+            g_hash_table_iter_remove (&iter);
+    }
+    g_hash_table_destroy (objects);
+
+    return TRUE;
+}
+
+/* gets the results of the finished jobs of @calls with a single call */
+static void finish_batch_jobs (LVMBatchCall *calls, guint n_calls, GError *wait_error) {
+    GHashTable *objects = NULL;
+    GVariant *props = NULL;
+    GVariant *value = NULL;
+    const gchar *result = NULL;
+    gint error_code = 0;
+    const gchar *error_msg = NULL;
+    GError *l_error = NULL;
+    guint i = 0;
+
+    if (!wait_error)
+        objects = get_managed_objects (&l_error);
+
+    for (i=0; i < n_calls; i++) {
+        if (calls[i].done || !calls[i].job_path)
+            continue;
+        calls[i].done = TRUE;
+
+        if (wait_error || l_error) {
+            calls[i].error = g_error_copy (wait_error ? wait_error : l_error);
+            g_prefix_error (&(calls[i].error), "Waiting for '%s' method of the '%s' object to finish failed: ",
+                            calls[i].method, calls[i].obj);
+            continue;
+        }
+
+        props = lookup_object_properties (objects, calls[i].job_path, JOB_INTF, &(calls[i].error));
+        if (!props) {
+            g_prefix_error (&(calls[i].error), "Getting result after waiting for '%s' method of the '%s' object failed: ",
+                            calls[i].method, calls[i].obj);
+            continue;
+        }
+
+        if (!g_variant_lookup (props, "Result", "&o", &result) || g_strcmp0 (result, "/") == 0) {
+            value = g_variant_lookup_value (props, "GetError", G_VARIANT_TYPE ("(is)"));
+            if (!value)
+                g_set_error (&(calls[i].error), BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                             "Failed to get error from '%s' method of the '%s' object",
+                             calls[i].method, calls[i].obj);
+            else {
+                g_variant_get (value, "(i&s)", &error_code, &error_msg);
+                if (error_code != 0)
+                    g_set_error (&(calls[i].error), BD_LVM_ERROR, BD_LVM_ERROR_FAIL,
+                                 "Running '%s' method on the '%s' object failed: %s",
+                                 calls[i].method, calls[i].obj, error_msg ? error_msg : "unknown error");
+                g_variant_unref (value);
+            }
+        }
+        g_variant_unref (props);
+
+        /* remove the job object and clean after ourselves, nobody waits for the reply */
+        g_dbus_connection_call (bus, LVM_BUS_NAME, calls[i].job_path, JOB_INTF, "Remove", NULL,
+                                NULL, G_DBUS_CALL_FLAGS_NONE, METHOD_CALL_TIMEOUT, NULL, NULL, NULL);
+    }
+
+    if (objects)
+        g_hash_table_destroy (objects);
+    g_clear_error (&l_error);
+}
+
 /**
- * bd_lvm_lvcreate:
- * @vg_name: name of the VG to create a new LV in
- * @lv_name: name of the to-be-created LV
- * @size: requested size of the new LV
- * @type: (nullable): type of the new LV ("striped", "raid1",..., see lvcreate (8))
- * @pv_list: (nullable) (array zero-terminated=1): list of PVs the newly created LV should use or %NULL
- * if not specified
- * @extra: (nullable) (array zero-terminated=1): extra options for the LV creation
- *                                                 (just passed to LVM as is)
+ * call_lvm_methods_batch: (skip)
+ * @calls: (array length=n_calls): method calls to run
+ * @n_calls: number of @calls
  * @error: (out) (optional): place to store error (if any)
  *
- * Returns: whether the given @vg_name/@lv_name LV was successfully created or not
+ * Sends all the not yet done @calls to lvmdbusd at once and waits for all of
+ * them (and the jobs they started) together. Results of the individual calls
+ * are stored in their @error fields.
  *
- * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_CREATE
+ * Returns: whether the batch could be run or not
  */
-gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 size, const gchar *type, const gchar **pv_list, const BDExtraArg **extra, GError **error) {
+static gboolean call_lvm_methods_batch (LVMBatchCall *calls, guint n_calls, GError **error) {
+    LVMBatch *batch = NULL;
+    GMainContext *context = NULL;
+    GSource *timeout = NULL;
+    guint subscription = 0;
+    guint n_running = 0;
+    guint64 log_task_id = 0;
+    guint64 prog_id = 0;
+    gchar *log_msg = NULL;
+    GError *l_error = NULL;
+    guint i = 0;
+
+    if (!check_dbus_deps (&avail_dbus_deps, DBUS_DEPS_LVMDBUSD_MASK, dbus_deps, DBUS_DEPS_LAST, &deps_check_lock, error))
+        return FALSE;
+
+    batch = lvm_batch_new ();
+
+    log_task_id = bd_utils_get_next_task_id ();
+    log_msg = g_strdup_printf ("Calling %u lvmdbusd methods at once", n_calls);
+    bd_utils_log_task_status (log_task_id, log_msg);
+    prog_id = bd_utils_report_started (log_msg);
+    g_free (log_msg);
+
+    /* replies and signals are delivered to our own main context, subscribe
+       before sending the calls so that no job completion is missed */
+    context = g_main_context_new ();
+    g_main_context_push_thread_default (context);
+    subscription = g_dbus_connection_signal_subscribe (bus, LVM_BUS_NAME, DBUS_PROPS_IFACE, "PropertiesChanged",
+                                                       NULL, JOB_INTF, G_DBUS_SIGNAL_FLAGS_NONE,
+                                                       batch_job_properties_changed, lvm_batch_ref (batch),
+                                                       lvm_batch_unsubscribed);
+    for (i=0; i < n_calls; i++) {
+        if (calls[i].done)
+            continue;
+        calls[i].batch = batch;
+        batch->pending_calls++;
+        g_dbus_connection_call (bus, LVM_BUS_NAME, calls[i].obj, calls[i].intf, calls[i].method, calls[i].params,
+                                NULL, G_DBUS_CALL_FLAGS_NONE, METHOD_CALL_TIMEOUT, NULL, batch_call_done, &(calls[i]));
+    }
+    g_main_context_pop_thread_default (context);
+
+    while (batch->pending_calls > 0)
+        g_main_context_iteration (context, TRUE);
+
+    /* the jobs may have finished before their paths were known */
+    if (g_hash_table_size (batch->jobs) > 0) {
+        log_msg = g_strdup_printf ("Waiting for %u jobs to finish", g_hash_table_size (batch->jobs));
+        bd_utils_log_task_status (log_task_id, log_msg);
+        g_free (log_msg);
+        poll_batch_jobs (batch, &l_error);
+    }
+
+    while (g_hash_table_size (batch->jobs) > 0 && !l_error) {
+        n_running = g_hash_table_size (batch->jobs);
+        batch->timed_out = FALSE;
+        timeout = g_timeout_source_new (batch->got_signal ? JOB_SIGNAL_TIMEOUT : PROGRESS_WAIT);
+        g_source_set_callback (timeout, batch_wait_timeout, batch, NULL);
+        g_source_attach (timeout, context);
+        while (g_hash_table_size (batch->jobs) == n_running && !batch->timed_out)
+            g_main_context_iteration (context, TRUE);
+        g_source_destroy (timeout);
+        g_source_unref (timeout);
+
+        if (batch->timed_out)
+            poll_batch_jobs (batch, &l_error);
+
+        bd_utils_report_progress (prog_id, (gint) (100 * (n_calls - g_hash_table_size (batch->jobs)) / n_calls), NULL);
+    }
+
+    /* wait for the subscription to drop its reference of the batch (from an
+       idle source in our context), queued signals are not delivered anymore */
+    g_dbus_connection_signal_unsubscribe (bus, subscription);
+    while (!batch->unsubscribed)
+        g_main_context_iteration (context, TRUE);
+    g_main_context_unref (context);
+    /* the job paths are owned by @calls, don't leave them to the subscription */
+    g_hash_table_remove_all (batch->jobs);
+    lvm_batch_unref (batch);
+
+    finish_batch_jobs (calls, n_calls, l_error);
+    g_clear_error (&l_error);
+
+    bd_utils_log_task_status (log_task_id, "Done.");
+    bd_utils_report_finished (prog_id, "Completed");
+
+    return TRUE;
+}
+
+/**
+ * get_lv_object_paths: (skip)
+ * @objects: snapshot of the lvmdbusd objects (see get_managed_objects())
+ *
+ * Returns: (transfer container): hashtable of "vg/lv" -> object path for all
+ *                                the LVs in @objects
+ */
+static GHashTable* get_lv_object_paths (GHashTable *objects) {
+    GHashTable *ret = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    GHashTableIter iter;
+    const gchar *obj_path = NULL;
+    GVariant *props = NULL;
+    GVariant *vg_name = NULL;
+    const gchar *lv_name = NULL;
+    const gchar *vg_path = NULL;
+
+    g_hash_table_iter_init (&iter, objects);
+    while (g_hash_table_iter_next (&iter, (gpointer *) &obj_path, NULL)) {
+        props = lookup_object_properties (objects, obj_path, LV_CMN_INTF, NULL);
+        if (!props)
+            continue;
+        if (g_variant_lookup (props, "Name", "&s", &lv_name) && g_variant_lookup (props, "Vg", "&o", &vg_path)) {
+            vg_name = lookup_object_property (objects, vg_path, VG_INTF, "Name", NULL);
+            if (vg_name) {
+                g_hash_table_insert (ret, g_strdup_printf ("%s/%s", g_variant_get_string (vg_name, NULL), lv_name),
+                                     (gpointer) obj_path);
+                g_variant_unref (vg_name);
+            }
+        }
+        g_variant_unref (props);
+    }
+
+    return ret;
+}
+
+static BDLVMLVOpResult** get_batch_results (LVMBatchCall *calls, const gchar **lv_names, guint n_calls) {
+    BDLVMLVOpResult **ret = g_new0 (BDLVMLVOpResult*, n_calls + 1);
+    guint i = 0;
+
+    for (i=0; i < n_calls; i++) {
+        /* takes over the error (if any) */
+        ret[i] = lv_op_result_new (lv_names[i], calls[i].error);
+        calls[i].error = NULL;
+        lvm_batch_call_clear (&(calls[i]));
+    }
+    g_free (calls);
+
+    return ret;
+}
+
+/* runs the @method method with the same parameters on all the @lv_names LVs */
+static BDLVMLVOpResult** call_lvs_method_batch (const gchar *vg_name, const gchar **lv_names, const gchar *method,
+                                                GVariant *params, GVariant *extra_params, const BDExtraArg **extra,
+                                                GError **error) {
+    GHashTable *objects = NULL;
+    GHashTable *lv_paths = NULL;
+    LVMBatchCall *calls = NULL;
+    GVariant *all_params = NULL;
+    const gchar *obj_path = NULL;
+    gchar *lv_spec = NULL;
+    guint n_calls = lv_names ? g_strv_length ((gchar **) lv_names) : 0;
+    guint i = 0;
+
+    /* look up all the LVs in one go */
+    objects = get_managed_objects (error);
+    if (!objects)
+        return NULL;
+    lv_paths = get_lv_object_paths (objects);
+
+    all_params = g_variant_ref_sink (build_method_params (params, extra_params, extra, TRUE));
+    if (params)
+        g_variant_unref (g_variant_ref_sink (params));
+
+    calls = g_new0 (LVMBatchCall, n_calls);
+    for (i=0; i < n_calls; i++) {
+        lv_spec = g_strdup_printf ("%s/%s", vg_name, lv_names[i]);
+        obj_path = g_hash_table_lookup (lv_paths, lv_spec);
+        if (!obj_path) {
+            g_set_error (&(calls[i].error), BD_LVM_ERROR, BD_LVM_ERROR_NOEXIST,
+                         "The object with LVM ID '%s' doesn't exist", lv_spec);
+            calls[i].done = TRUE;
+        } else {
+            calls[i].obj = g_strdup (obj_path);
+            calls[i].intf = LV_INTF;
+            calls[i].method = method;
+            calls[i].params = g_variant_ref (all_params);
+        }
+        g_free (lv_spec);
+    }
+    g_variant_unref (all_params);
+    g_hash_table_destroy (lv_paths);
+    g_hash_table_destroy (objects);
+
+    if (!call_lvm_methods_batch (calls, n_calls, error)) {
+        for (i=0; i < n_calls; i++)
+            lvm_batch_call_clear (&(calls[i]));
+        g_free (calls);
+        return NULL;
+    }
+
+    return get_batch_results (calls, lv_names, n_calls);
+}
+
+static GVariant* build_lvcreate_params (const gchar *lv_name, guint64 size, const gchar *type, const gchar **pv_list, GVariant **extra_params, GError **error) {
     GVariantBuilder builder;
     gchar *path = NULL;
     const gchar **pv = NULL;
     GVariant *pvs = NULL;
     GVariantType *var_type = NULL;
     GVariant *params = NULL;
-    GVariant *extra_params = NULL;
 
     /* build the array of PVs (object paths) */
     if (pv_list && *pv_list) {
@@ -2266,7 +2935,7 @@ gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 si
             path = get_object_path (*pv, error);
             if (!path) {
                 g_variant_builder_clear (&builder);
-                return FALSE;
+                return NULL;
             }
             g_variant_builder_add_value (&builder, g_variant_new ("(ott)", path, (guint64) 0, (guint64) 0));
             g_free (path);
@@ -2287,6 +2956,7 @@ gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 si
     params = g_variant_builder_end (&builder);
     g_variant_builder_clear (&builder);
 
+    *extra_params = NULL;
     if (type) {
         /* and now the extra_params params */
         g_variant_builder_init (&builder, G_VARIANT_TYPE_DICTIONARY);
@@ -2294,10 +2964,73 @@ gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 si
             g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "stripes", g_variant_new ("i", g_strv_length ((gchar **) pv_list))));
         else
             g_variant_builder_add_value (&builder, g_variant_new ("{sv}", "type", g_variant_new ("s", type)));
-        extra_params = g_variant_builder_end (&builder);
+        *extra_params = g_variant_builder_end (&builder);
+        g_variant_builder_clear (&builder);
+    }
+
+    return params;
+}
+
+static GVariant* build_lvremove_extra_params (gboolean force) {
+    GVariantBuilder builder;
+    GVariant *extra_params = NULL;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE_DICTIONARY);
+    /* '--yes' is needed if DISCARD is enabled */
+    g_variant_builder_add (&builder, "{sv}", "--yes", g_variant_new ("s", ""));
+    if (force) {
+        g_variant_builder_add (&builder, "{sv}", "--force", g_variant_new ("s", ""));
+    }
+    extra_params = g_variant_builder_end (&builder);
+    g_variant_builder_clear (&builder);
+
+    return extra_params;
+}
+
+static GVariant* build_lvactivate_params (gboolean ignore_skip, gboolean shared, GVariant **extra_params) {
+    GVariant *params = NULL;
+    GVariantBuilder builder;
+
+    if (shared)
+        params = g_variant_new ("(t)", (guint64) 1 << 6);
+    else
+        params = g_variant_new ("(t)", (guint64) 0);
+
+    *extra_params = NULL;
+    if (ignore_skip) {
+        g_variant_builder_init (&builder, G_VARIANT_TYPE_DICTIONARY);
+        g_variant_builder_add (&builder, "{sv}", "-K", g_variant_new ("s", ""));
+        *extra_params = g_variant_builder_end (&builder);
         g_variant_builder_clear (&builder);
     }
 
+    return params;
+}
+
+/**
+ * bd_lvm_lvcreate:
+ * @vg_name: name of the VG to create a new LV in
+ * @lv_name: name of the to-be-created LV
+ * @size: requested size of the new LV
+ * @type: (nullable): type of the new LV ("striped", "raid1",..., see lvcreate (8))
+ * @pv_list: (nullable) (array zero-terminated=1): list of PVs the newly created LV should use or %NULL
+ * if not specified
+ * @extra: (nullable) (array zero-terminated=1): extra options for the LV creation
+ *                                                 (just passed to LVM as is)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: whether the given @vg_name/@lv_name LV was successfully created or not
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_CREATE
+ */
+gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 size, const gchar *type, const gchar **pv_list, const BDExtraArg **extra, GError **error) {
+    GVariant *params = NULL;
+    GVariant *extra_params = NULL;
+
+    params = build_lvcreate_params (lv_name, size, type, pv_list, &extra_params, error);
+    if (!params)
+        return FALSE;
+
     return call_lvm_obj_method_sync (vg_name, VG_INTF, "LvCreate", params, extra_params, extra, TRUE, error);
 }
 
@@ -2315,19 +3048,98 @@ gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 si
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_REMOVE
  */
 gboolean bd_lvm_lvremove (const gchar *vg_name, const gchar *lv_name, gboolean force, const BDExtraArg **extra, GError **error) {
-    GVariantBuilder builder;
+    GVariant *extra_params = build_lvremove_extra_params (force);
+
+    return call_lv_method_sync (vg_name, lv_name, "Remove", NULL, extra_params, extra, TRUE, error);
+}
+
+/**
+ * bd_lvm_lvcreate_many:
+ * @vg_name: name of the VG to create the new LVs in
+ * @specs: (array zero-terminated=1): specifications of the to-be-created LVs
+ * @extra: (nullable) (array zero-terminated=1): extra options for the LV creation
+ *                                                 (just passed to LVM as is, for every LV)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Creates multiple LVs in the @vg_name VG. Failure to create one of the LVs
+ * doesn't stop the creation of the others, the results are reported for every
+ * LV separately. All the LvCreate calls are sent to lvmdbusd at once and the
+ * jobs they start are waited for together.
+ *
+ * Returns: (array zero-terminated=1): results for all the @specs (in the same
+ *          order) or %NULL in case the batch couldn't be run at all
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_CREATE
+ */
+BDLVMLVOpResult** bd_lvm_lvcreate_many (const gchar *vg_name, BDLVMLVCreateSpec **specs, const BDExtraArg **extra, GError **error) {
+    g_autofree gchar *vg_path = NULL;
+    LVMBatchCall *calls = NULL;
+    GVariant *params = NULL;
     GVariant *extra_params = NULL;
+    const gchar **lv_names = NULL;
+    BDLVMLVOpResult **ret = NULL;
+    guint n_calls = 0;
+    guint i = 0;
 
-    g_variant_builder_init (&builder, G_VARIANT_TYPE_DICTIONARY);
-    /* '--yes' is needed if DISCARD is enabled */
-    g_variant_builder_add (&builder, "{sv}", "--yes", g_variant_new ("s", ""));
-    if (force) {
-        g_variant_builder_add (&builder, "{sv}", "--force", g_variant_new ("s", ""));
+    vg_path = get_object_path (vg_name, error);
+    if (!vg_path)
+        return NULL;
+
+    while (specs && specs[n_calls])
+        n_calls++;
+
+    calls = g_new0 (LVMBatchCall, n_calls);
+    lv_names = g_new0 (const gchar*, n_calls + 1);
+    for (i=0; i < n_calls; i++) {
+        lv_names[i] = specs[i]->lv_name;
+        params = build_lvcreate_params (specs[i]->lv_name, specs[i]->size, specs[i]->type,
+                                        (const gchar **) specs[i]->pv_list, &extra_params, &(calls[i].error));
+        if (!params) {
+            calls[i].done = TRUE;
+            continue;
+        }
+        calls[i].obj = g_strdup (vg_path);
+        calls[i].intf = VG_INTF;
+        calls[i].method = "LvCreate";
+        calls[i].params = g_variant_ref_sink (build_method_params (params, extra_params, extra, TRUE));
+        g_variant_unref (g_variant_ref_sink (params));
     }
-    extra_params = g_variant_builder_end (&builder);
-    g_variant_builder_clear (&builder);
 
-    return call_lv_method_sync (vg_name, lv_name, "Remove", NULL, extra_params, extra, TRUE, error);
+    if (!call_lvm_methods_batch (calls, n_calls, error)) {
+        for (i=0; i < n_calls; i++)
+            lvm_batch_call_clear (&(calls[i]));
+        g_free (calls);
+        g_free (lv_names);
+        return NULL;
+    }
+
+    ret = get_batch_results (calls, lv_names, n_calls);
+    g_free (lv_names);
+
+    return ret;
+}
+
+/**
+ * bd_lvm_lvremove_many:
+ * @vg_name: name of the VG containing the to-be-removed LVs
+ * @lv_names: (array zero-terminated=1): names of the to-be-removed LVs
+ * @force: whether to force removal or not
+ * @extra: (nullable) (array zero-terminated=1): extra options for the LV removal
+ *                                                 (just passed to LVM as is, for every LV)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Removes multiple LVs from the @vg_name VG, see @bd_lvm_lvcreate_many for
+ * details about the batch operations.
+ *
+ * Returns: (array zero-terminated=1): results for all the @lv_names (in the same
+ *          order) or %NULL in case the batch couldn't be run at all
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_REMOVE
+ */
+BDLVMLVOpResult** bd_lvm_lvremove_many (const gchar *vg_name, const gchar **lv_names, gboolean force, const BDExtraArg **extra, GError **error) {
+    GVariant *extra_params = build_lvremove_extra_params (force);
+
+    return call_lvs_method_batch (vg_name, lv_names, "Remove", NULL, extra_params, extra, error);
 }
 
 /**
@@ -2442,34 +3254,51 @@ gboolean bd_lvm_lvrepair (const gchar *vg_name, const gchar *lv_name, const gcha
  * @vg_name: name of the VG containing the to-be-activated LV
  * @lv_name: name of the to-be-activated LV
  * @ignore_skip: whether to ignore the skip flag or not
- * @shared: whether to activate the LV in shared mode (used for shared LVM setups with lvmlockd,
+ * @shared: whether to activate the LV in shared mode (used for shared LVM setups with lvmlockd,
+ *          use %FALSE if not sure)
+ * @extra: (nullable) (array zero-terminated=1): extra options for the LV activation
+ *                                                 (just passed to LVM as is)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: whether the @vg_name/@lv_name LV was successfully activated or not
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_MODIFY
+ */
+gboolean bd_lvm_lvactivate (const gchar *vg_name, const gchar *lv_name, gboolean ignore_skip, gboolean shared, const BDExtraArg **extra, GError **error) {
+    GVariant *params = NULL;
+    GVariant *extra_params = NULL;
+
+    params = build_lvactivate_params (ignore_skip, shared, &extra_params);
+
+    return call_lv_method_sync (vg_name, lv_name, "Activate", params, extra_params, extra, TRUE, error);
+}
+
+/**
+ * bd_lvm_lvactivate_many:
+ * @vg_name: name of the VG containing the to-be-activated LVs
+ * @lv_names: (array zero-terminated=1): names of the to-be-activated LVs
+ * @ignore_skip: whether to ignore the skip flag or not
+ * @shared: whether to activate the LVs in shared mode (used for shared LVM setups with lvmlockd,
  *          use %FALSE if not sure)
  * @extra: (nullable) (array zero-terminated=1): extra options for the LV activation
- *                                                 (just passed to LVM as is)
+ *                                                 (just passed to LVM as is, for every LV)
  * @error: (out) (optional): place to store error (if any)
  *
- * Returns: whether the @vg_name/@lv_name LV was successfully activated or not
+ * Activates multiple LVs from the @vg_name VG, see @bd_lvm_lvcreate_many for
+ * details about the batch operations.
+ *
+ * Returns: (array zero-terminated=1): results for all the @lv_names (in the same
+ *          order) or %NULL in case the batch couldn't be run at all
  *
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_MODIFY
  */
-gboolean bd_lvm_lvactivate (const gchar *vg_name, const gchar *lv_name, gboolean ignore_skip, gboolean shared, const BDExtraArg **extra, GError **error) {
+BDLVMLVOpResult** bd_lvm_lvactivate_many (const gchar *vg_name, const gchar **lv_names, gboolean ignore_skip, gboolean shared, const BDExtraArg **extra, GError **error) {
     GVariant *params = NULL;
-    GVariantBuilder builder;
     GVariant *extra_params = NULL;
 
-    if (shared)
-        params = g_variant_new ("(t)", (guint64) 1 << 6);
-    else
-        params = g_variant_new ("(t)", (guint64) 0);
-
-    if (ignore_skip) {
-        g_variant_builder_init (&builder, G_VARIANT_TYPE_DICTIONARY);
-        g_variant_builder_add (&builder, "{sv}", "-K", g_variant_new ("s", ""));
-        extra_params = g_variant_builder_end (&builder);
-        g_variant_builder_clear (&builder);
-    }
+    params = build_lvactivate_params (ignore_skip, shared, &extra_params);
 
-    return call_lv_method_sync (vg_name, lv_name, "Activate", params, extra_params, extra, TRUE, error);
+    return call_lvs_method_batch (vg_name, lv_names, "Activate", params, extra_params, extra, error);
 }
 
 /**
@@ -2591,123 +3420,116 @@ gboolean bd_lvm_delete_lv_tags (const gchar *vg_name, const gchar *lv_name, cons
     return _manage_lvm_tags (obj_path, NULL, LV_INTF, tags, "TagsDel", error);
 }
 
-/**
- * bd_lvm_lvinfo:
- * @vg_name: name of the VG that contains the LV to get information about
- * @lv_name: name of the LV to get information about
- * @error: (out) (optional): place to store error (if any)
- *
- * Returns: (transfer full): information about the @vg_name/@lv_name LV or %NULL in case
- * of error (the @error) gets populated in those cases)
- *
- * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
- */
-BDLVMLVdata* bd_lvm_lvinfo (const gchar *vg_name, const gchar *lv_name, GError **error) {
+static BDLVMLVdata* get_lv_info (const gchar *vg_name, const gchar *lv_name, gboolean tree, GError **error) {
+    g_autofree gchar *lv_spec = NULL;
+    g_autofree gchar *obj_path = NULL;
     GVariant *props = NULL;
     BDLVMLVdata* ret = NULL;
 
-    props = get_lv_properties (vg_name, lv_name, error);
-    if (!props)
+    lv_spec = g_strdup_printf ("%s/%s", vg_name, lv_name);
+    obj_path = get_object_path (lv_spec, error);
+    if (!obj_path)
         /* the error is already populated */
         return NULL;
 
-    ret = get_lv_data_from_props (props, error);
-    if (!ret)
-        return NULL;
-
-    if (g_strcmp0 (ret->segtype, "thin-pool") == 0 ||
-        g_strcmp0 (ret->segtype, "cache-pool") == 0) {
-        ret->data_lv = _lvm_data_lv_name (vg_name, lv_name, NULL);
-        ret->metadata_lv = _lvm_metadata_lv_name (vg_name, lv_name, NULL);
-    }
-    if (g_strcmp0 (ret->segtype, "vdo-pool") == 0) {
-        ret->data_lv = _lvm_data_lv_name (vg_name, lv_name, NULL);
-    }
-
-    return ret;
-}
-
-BDLVMLVdata* bd_lvm_lvinfo_tree (const gchar *vg_name, const gchar *lv_name, GError **error) {
-    GVariant *props = NULL;
-    BDLVMLVdata* ret = NULL;
-
-    props = get_lv_properties (vg_name, lv_name, error);
+    props = get_object_properties (obj_path, LV_CMN_INTF, error);
     if (!props)
         /* the error is already populated */
         return NULL;
 
-    ret = get_lv_data_from_props (props, error);
+    ret = get_lv_data_from_props (props, NULL, error);
     if (!ret)
         return NULL;
 
-    if (g_strcmp0 (ret->segtype, "thin-pool") == 0 ||
-        g_strcmp0 (ret->segtype, "cache-pool") == 0) {
-        ret->data_lv = _lvm_data_lv_name (vg_name, lv_name, NULL);
-        ret->metadata_lv = _lvm_metadata_lv_name (vg_name, lv_name, NULL);
-    }
-    if (g_strcmp0 (ret->segtype, "vdo-pool") == 0) {
-        ret->data_lv = _lvm_data_lv_name (vg_name, lv_name, NULL);
-    }
-    ret->segs = _lvm_segs (vg_name, lv_name, NULL);
-    _lvm_data_and_metadata_lvs (vg_name, lv_name, &ret->data_lvs, &ret->metadata_lvs, NULL);
+    /* errors about the related LVs are not fatal for a single LV */
+    get_lv_related_data (NULL, obj_path, ret, tree, NULL);
 
     return ret;
 }
 
-static gchar* get_lv_vg_name (const gchar *lv_obj_path, GError **error) {
-    GVariant *value = NULL;
-    gchar *vg_obj_path = NULL;
-    gchar *ret = NULL;
-
-    value = get_object_property (lv_obj_path, LV_CMN_INTF, "Vg", error);
-    g_variant_get (value, "o", &vg_obj_path);
-    g_variant_unref (value);
-
-    value = get_object_property (vg_obj_path, VG_INTF, "Name", error);
-    g_variant_get (value, "s", &ret);
-    g_free (vg_obj_path);
-    g_variant_unref (value);
+/**
+ * bd_lvm_lvinfo:
+ * @vg_name: name of the VG that contains the LV to get information about
+ * @lv_name: name of the LV to get information about
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (transfer full): information about the @vg_name/@lv_name LV or %NULL in case
+ * of error (the @error) gets populated in those cases)
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMLVdata* bd_lvm_lvinfo (const gchar *vg_name, const gchar *lv_name, GError **error) {
+    return get_lv_info (vg_name, lv_name, FALSE, error);
+}
 
-    return ret;
+BDLVMLVdata* bd_lvm_lvinfo_tree (const gchar *vg_name, const gchar *lv_name, GError **error) {
+    return get_lv_info (vg_name, lv_name, TRUE, error);
 }
 
 /**
- * filter_lvs_by_vg: (skip)
+ * get_lvs: (skip)
+ * @objects: (nullable): snapshot of the lvmdbusd objects (see get_managed_objects())
+ * @vg_name: (nullable): name of the VG to get information about LVs from
+ * @tree: whether to also get the segments and the data and metadata sub-LVs
+ * @error: (out) (optional): place to store error (if any)
  *
- * Filter LVs by VG name and prepend the matching ones to the @out list.
+ * Assembles the LVs from @objects in memory. If @objects is %NULL, all the
+ * objects are first got from lvmdbusd in one call.
  */
-static gboolean filter_lvs_by_vg (gchar **lvs, const gchar *vg_name, GSList **out, guint64 *n_lvs, GError **error) {
-    gchar **lv_p = NULL;
-    gchar *lv_vg_name = NULL;
-    gboolean success = TRUE;
+static BDLVMLVdata** get_lvs (GHashTable *objects, const gchar *vg_name, gboolean tree, GError **error) {
+    const gchar *prefixes[] = {LV_OBJ_PREFIX, THIN_POOL_OBJ_PREFIX, CACHE_POOL_OBJ_PREFIX,
+                               VDO_POOL_OBJ_PREFIX, HIDDEN_LV_OBJ_PREFIX, NULL};
+    const gchar **prefix = NULL;
+    GHashTable *own_objects = NULL;
+    GPtrArray *paths = NULL;
+    GVariant *props = NULL;
+    BDLVMLVdata *lvdata = NULL;
+    GPtrArray *ret = NULL;
+    guint i = 0;
+    GError *l_error = NULL;
 
-    if (!lvs)
-        /* nothing to do */
-        return TRUE;
+    if (!objects) {
+        objects = own_objects = get_managed_objects (error);
+        if (!objects)
+            return NULL;
+    }
 
-    for (lv_p=lvs; *lv_p; lv_p++) {
-        if (vg_name) {
-            lv_vg_name = get_lv_vg_name (*lv_p, error);
-            if (!lv_vg_name) {
-                g_free (*lv_p);
-                success = FALSE;
+    ret = g_ptr_array_new_with_free_func ((GDestroyNotify) bd_lvm_lvdata_free);
+    for (prefix=prefixes; *prefix && !l_error; prefix++) {
+        paths = get_objects_by_prefix (objects, *prefix);
+        for (i=0; i < paths->len; i++) {
+            props = lookup_object_properties (objects, paths->pdata[i], LV_CMN_INTF, &l_error);
+            if (!props)
+                break;
+
+            /* consumes (frees) the 'props' parameter */
+            lvdata = get_lv_data_from_props (props, objects, &l_error);
+            if (!lvdata)
+                break;
+
+            if (vg_name && g_strcmp0 (lvdata->vg_name, vg_name) != 0) {
+                bd_lvm_lvdata_free (lvdata);
                 continue;
             }
+            g_ptr_array_add (ret, lvdata);
 
-            if (g_strcmp0 (lv_vg_name, vg_name) == 0) {
-                *out = g_slist_prepend (*out, *lv_p);
-                (*n_lvs)++;
-            } else {
-                g_free (*lv_p);
-            }
-
-            g_free (lv_vg_name);
-        } else {
-            *out = g_slist_prepend (*out, *lv_p);
-            (*n_lvs)++;
+            if (!get_lv_related_data (objects, paths->pdata[i], lvdata, tree, &l_error))
+                break;
         }
+        g_ptr_array_free (paths, TRUE);
     }
-    return success;
+    if (own_objects)
+        g_hash_table_destroy (own_objects);
+
+    if (l_error) {
+        g_propagate_error (error, l_error);
+        g_ptr_array_free (ret, TRUE);
+        return NULL;
+    }
+
+    g_ptr_array_set_free_func (ret, NULL);
+    g_ptr_array_add (ret, NULL);
+    return (BDLVMLVdata **) g_ptr_array_free (ret, FALSE);
 }
 
 /**
@@ -2721,267 +3543,96 @@ static gboolean filter_lvs_by_vg (gchar **lvs, const gchar *vg_name, GSList **ou
  * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
  */
 BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error) {
-    gchar **lvs = NULL;
-    guint64 n_lvs = 0;
-    GVariant *props = NULL;
-    BDLVMLVdata **ret = NULL;
-    guint64 j = 0;
-    GSList *matched_lvs = NULL;
-    GSList *lv = NULL;
-    gboolean success = FALSE;
-    GError *l_error = NULL;
-
-    lvs = get_existing_objects (LV_OBJ_PREFIX, &l_error);
-    if (!lvs && l_error) {
-        g_propagate_error (error, l_error);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-
-    lvs = get_existing_objects (THIN_POOL_OBJ_PREFIX, &l_error);
-    if (!lvs && l_error) {
-        g_propagate_error (error, l_error);
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-
-    lvs = get_existing_objects (CACHE_POOL_OBJ_PREFIX, &l_error);
-    if (!lvs && l_error) {
-        g_propagate_error (error, l_error);
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
+    return get_lvs (NULL, vg_name, FALSE, error);
+}
 
-    lvs = get_existing_objects (VDO_POOL_OBJ_PREFIX, &l_error);
-    if (!lvs && l_error) {
-        g_propagate_error (error, l_error);
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
+BDLVMLVdata** bd_lvm_lvs_tree (const gchar *vg_name, GError **error) {
+    return get_lvs (NULL, vg_name, TRUE, error);
+}
 
-    lvs = get_existing_objects (HIDDEN_LV_OBJ_PREFIX, &l_error);
-    if (!lvs && l_error) {
-        g_propagate_error (error, l_error);
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
+/**
+ * bd_lvm_lvs_select:
+ * @vg_name: (nullable): name of the VG to get information about LVs from
+ * @select_expr: (nullable): LVM selection criteria (see lvmreport(7)) the LVs
+ *                           have to match or %NULL to get all LVs
+ * @fields: fields of the #BDLVMLVdata to fill (the @lv_name and @vg_name
+ *          fields are always filled)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * A cheaper version of bd_lvm_lvs() for callers that only need some of the
+ * information about LVs. The filtering is done by LVM and only the columns
+ * needed for @fields are reported, the other fields are left empty.
+ *
+ * Note: LVM selection criteria are not supported by the LVM DBus plugin and
+ *       lvmdbusd always provides all the information about the LVs so @fields
+ *       is ignored and all the fields are filled.
+ *
+ * Returns: (array zero-terminated=1): information about LVs matching
+ * @select_expr found in the given @vg_name VG or in system if @vg_name is %NULL
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMLVdata** bd_lvm_lvs_select (const gchar *vg_name, const gchar *select_expr, BDLVMLVdataField fields G_GNUC_UNUSED, GError **error) {
+    if (select_expr) {
+        g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                             "LVM selection criteria are not supported by the LVM DBus plugin");
         return NULL;
     }
 
-    if (n_lvs == 0) {
-        /* no LVs */
-        ret = g_new0 (BDLVMLVdata*, 1);
-        ret[0] = NULL;
-        g_slist_free_full (matched_lvs, g_free);
-        return ret;
-    }
-
-    /* we have been prepending to the list so far, but it will be nicer if we
-       reverse it (to get back the original order) */
-    matched_lvs = g_slist_reverse (matched_lvs);
-
-    /* now create the return value -- NULL-terminated array of BDLVMLVdata */
-    ret = g_new0 (BDLVMLVdata*, n_lvs + 1);
-
-    lv = matched_lvs;
-    while (lv) {
-        props = get_object_properties (lv->data, LV_CMN_INTF, &l_error);
-        if (!props) {
-            g_slist_free_full (matched_lvs, g_free);
-            g_free (ret);
-            g_propagate_error (error, l_error);
-            return NULL;
-        }
-        ret[j] = get_lv_data_from_props (props, &l_error);
-        if (!(ret[j])) {
-            g_slist_free_full (matched_lvs, g_free);
-            for (guint64 i = 0; i < j; i++)
-                bd_lvm_lvdata_free (ret[i]);
-            g_free (ret);
-            g_propagate_error (error, l_error);
-            return NULL;
-        } else if ((g_strcmp0 (ret[j]->segtype, "thin-pool") == 0) ||
-                   (g_strcmp0 (ret[j]->segtype, "cache-pool") == 0)) {
-            ret[j]->data_lv = _lvm_data_lv_name (ret[j]->vg_name, ret[j]->lv_name, &l_error);
-            ret[j]->metadata_lv = _lvm_metadata_lv_name (ret[j]->vg_name, ret[j]->lv_name, &l_error);
-        } else if (g_strcmp0 (ret[j]->segtype, "vdo-pool") == 0) {
-            ret[j]->data_lv = _lvm_data_lv_name (ret[j]->vg_name, ret[j]->lv_name, &l_error);
-        }
-        if (l_error) {
-            g_slist_free_full (matched_lvs, g_free);
-            for (guint64 i = 0; i <= j; i++)
-                bd_lvm_lvdata_free (ret[i]);
-            g_free (ret);
-            g_propagate_error (error, l_error);
-            return NULL;
-        }
-        j++;
-        lv = g_slist_next (lv);
-    }
-    g_slist_free_full (matched_lvs, g_free);
-
-    ret[j] = NULL;
-    return ret;
+    return get_lvs (NULL, vg_name, FALSE, error);
 }
 
-BDLVMLVdata** bd_lvm_lvs_tree (const gchar *vg_name, GError **error) {
-    gchar **lvs = NULL;
-    guint64 n_lvs = 0;
-    GVariant *props = NULL;
-    BDLVMLVdata **ret = NULL;
-    guint64 j = 0;
-    GSList *matched_lvs = NULL;
-    GSList *lv = NULL;
-    gboolean success = FALSE;
-    GError *l_error = NULL;
-
-    lvs = get_existing_objects (LV_OBJ_PREFIX, &l_error);
-    if (!lvs && l_error) {
-        g_propagate_error (error, l_error);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
+/**
+ * bd_lvm_fullreport:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Gets information about all PVs, VGs and LVs (including their segments) in
+ * the system at once.
+ *
+ * With the lvmdbusd backend, no LVM command is run for this. lvmdbusd keeps
+ * the state of the whole system itself and the whole report is built from one
+ * snapshot of the objects it exports (one `GetManagedObjects` call), the same
+ * way as in bd_lvm_pvs(), bd_lvm_vgs() and bd_lvm_lvs_tree().
+ *
+ * Returns: (transfer full): information about all PVs, VGs and LVs in the
+ * system or %NULL in case of error (the @error) gets populated in those cases)
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMFullReport* bd_lvm_fullreport (GError **error) {
+    GHashTable *objects = NULL;
+    BDLVMFullReport *ret = NULL;
+
+    /* lvmdbusd keeps the state of the whole system so there are no extra
+       scans to save here, just gather the objects it already knows (all of
+       them at once so that the parts of the report match each other) */
+    objects = get_managed_objects (error);
+    if (!objects)
         return NULL;
-    }
 
-    lvs = get_existing_objects (THIN_POOL_OBJ_PREFIX, &l_error);
-    if (!lvs && l_error) {
-        g_propagate_error (error, l_error);
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
+    ret = g_new0 (BDLVMFullReport, 1);
 
-    lvs = get_existing_objects (CACHE_POOL_OBJ_PREFIX, &l_error);
-    if (!lvs && l_error) {
-        g_propagate_error (error, l_error);
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
+    ret->pvs = get_pvs (objects, error);
+    if (!ret->pvs) {
+        g_hash_table_destroy (objects);
+        bd_lvm_full_report_free (ret);
         return NULL;
     }
 
-    lvs = get_existing_objects (VDO_POOL_OBJ_PREFIX, &l_error);
-    if (!lvs && l_error) {
-        g_propagate_error (error, l_error);
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
+    ret->vgs = get_vgs (objects, error);
+    if (!ret->vgs) {
+        g_hash_table_destroy (objects);
+        bd_lvm_full_report_free (ret);
         return NULL;
     }
 
-    lvs = get_existing_objects (HIDDEN_LV_OBJ_PREFIX, &l_error);
-    if (!lvs && l_error) {
-        g_propagate_error (error, l_error);
-        g_slist_free_full (matched_lvs, g_free);
-        return NULL;
-    }
-    success = filter_lvs_by_vg (lvs, vg_name, &matched_lvs, &n_lvs, error);
-    g_free (lvs);
-    if (!success) {
-        g_slist_free_full (matched_lvs, g_free);
+    ret->lvs = get_lvs (objects, NULL, TRUE, error);
+    g_hash_table_destroy (objects);
+    if (!ret->lvs) {
+        bd_lvm_full_report_free (ret);
         return NULL;
     }
 
-    if (n_lvs == 0) {
-        /* no LVs */
-        ret = g_new0 (BDLVMLVdata*, 1);
-        ret[0] = NULL;
-        g_slist_free_full (matched_lvs, g_free);
-        return ret;
-    }
-
-    /* we have been prepending to the list so far, but it will be nicer if we
-       reverse it (to get back the original order) */
-    matched_lvs = g_slist_reverse (matched_lvs);
-
-    /* now create the return value -- NULL-terminated array of BDLVMLVdata */
-    ret = g_new0 (BDLVMLVdata*, n_lvs + 1);
-
-    lv = matched_lvs;
-    while (lv) {
-        props = get_object_properties (lv->data, LV_CMN_INTF, &l_error);
-        if (!props) {
-            g_slist_free_full (matched_lvs, g_free);
-            g_free (ret);
-            g_propagate_error (error, l_error);
-            return NULL;
-        }
-        ret[j] = get_lv_data_from_props (props, &l_error);
-        if (!(ret[j])) {
-            g_slist_free_full (matched_lvs, g_free);
-            for (guint64 i = 0; i < j; i++)
-                bd_lvm_lvdata_free (ret[i]);
-            g_free (ret);
-            g_propagate_error (error, l_error);
-            return NULL;
-        } else if ((g_strcmp0 (ret[j]->segtype, "thin-pool") == 0) ||
-                   (g_strcmp0 (ret[j]->segtype, "cache-pool") == 0)) {
-            ret[j]->data_lv = _lvm_data_lv_name (ret[j]->vg_name, ret[j]->lv_name, &l_error);
-            ret[j]->metadata_lv = _lvm_metadata_lv_name (ret[j]->vg_name, ret[j]->lv_name, &l_error);
-        } else if (g_strcmp0 (ret[j]->segtype, "vdo-pool") == 0) {
-            ret[j]->data_lv = _lvm_data_lv_name (ret[j]->vg_name, ret[j]->lv_name, &l_error);
-        }
-        ret[j]->segs = _lvm_segs (ret[j]->vg_name, ret[j]->lv_name, &l_error);
-        _lvm_data_and_metadata_lvs (ret[j]->vg_name, ret[j]->lv_name, &ret[j]->data_lvs, &ret[j]->metadata_lvs,
-                                    &l_error);
-        if (l_error) {
-            g_slist_free_full (matched_lvs, g_free);
-            for (guint64 i = 0; i <= j; i++)
-                bd_lvm_lvdata_free (ret[i]);
-            g_free (ret);
-            g_propagate_error (error, l_error);
-            return NULL;
-        }
-        j++;
-        lv = g_slist_next (lv);
-    }
-    g_slist_free_full (matched_lvs, g_free);
-
-    ret[j] = NULL;
     return ret;
 }
 
@@ -4064,15 +4715,93 @@ gchar* bd_lvm_vdolvpoolname (const gchar *vg_name, const gchar *lv_name, GError
     return ret;
 }
 
+/**
+ * bd_lvm_set_shell_mode:
+ * @enabled: whether to run LVM commands in persistent LVM shell processes or not
+ * @idle_timeout: number of seconds after which an unused LVM shell process is
+ *                terminated (0 means never)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * In the shell mode, one long-lived `lvm` process running in the shell mode
+ * is kept for every combination of the global config (see
+ * %bd_lvm_set_global_config) and the devices filter (see
+ * %bd_lvm_set_devices_filter) and the LVM commands are sent to it instead of
+ * running a new `lvm` process for every call. This avoids parsing the config,
+ * scanning the devices and reading the metadata again for every call. Shells
+ * that exit are automatically started again on the next call. Commands that
+ * report progress are always run in a new `lvm` process. Commands for
+ * different shells run in parallel, a shell that produces no output for 5
+ * minutes is considered stuck and killed and the command fails.
+ *
+ * Disabling the shell mode terminates all the running LVM shell processes.
+ *
+ * Note: The shell mode is not supported by the LVM DBus plugin, the LVM DBus
+ *       daemon manages its own LVM shell.
+ *
+ * Returns: whether the shell mode was successfully changed or not
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_set_shell_mode (gboolean enabled, guint idle_timeout G_GNUC_UNUSED, GError **error) {
+    if (!enabled)
+        return TRUE;
 
+    g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                         "LVM shell mode is not supported by the LVM DBus plugin");
+    return FALSE;
+}
 
+/**
+ * bd_lvm_set_metadata_cache:
+ * @enabled: whether to cache information about PVs, VGs and LVs or not
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Note: The metadata cache is not supported by the LVM DBus plugin, the LVM
+ *       DBus daemon keeps the information about PVs, VGs and LVs itself.
+ *
+ * Returns: whether the metadata cache was successfully enabled/disabled or not
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_set_metadata_cache (gboolean enabled, GError **error) {
+    if (!enabled)
+        return TRUE;
 
+    g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_NOT_SUPPORTED,
+                         "Metadata cache is not supported by the LVM DBus plugin");
+    return FALSE;
+}
 
+/**
+ * bd_lvm_metadata_cache_invalidate:
+ * @vg_name: (nullable): name of the VG to drop the cached information about or
+ *                       %NULL to drop all the cached information
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Note: The metadata cache is not supported by the LVM DBus plugin, there is
+ *       nothing to drop.
+ *
+ * Returns: whether the cached information was successfully dropped or not
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_metadata_cache_invalidate (const gchar *vg_name G_GNUC_UNUSED, GError **error G_GNUC_UNUSED) {
+    return TRUE;
+}
 
-
-
-
-
-
-
-
+/**
+ * bd_lvm_metadata_cache_get_stats:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Note: The metadata cache is not supported by the LVM DBus plugin, the
+ *       numbers are always zero.
+ *
+ * Returns: (transfer full): numbers of the calls answered from the metadata
+ *                           cache and the calls that had to get the information
+ *                           from LVM
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+BDLVMMetadataCacheStats* bd_lvm_metadata_cache_get_stats (GError **error G_GNUC_UNUSED) {
+    return g_new0 (BDLVMMetadataCacheStats, 1);
+}
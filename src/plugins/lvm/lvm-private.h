@@ -14,4 +14,11 @@ extern gchar *global_config_str;
 
 extern gchar *global_devices_str;
 
+/* called by the setters of the above with global_config_lock held */
+void lvm_global_config_changed (void);
+
+BDLVMLVOpResult* lv_op_result_new (const gchar *lv_name, GError *error);
+
+GHashTable* get_lvm_dm_states (GError **error);
+
 #endif /* BD_LVM_PRIVATE */
@@ -0,0 +1,785 @@
+/*
+ * Copyright (C) 2025  Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-unix.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <blockdev/utils.h>
+#include <json-glib/json-glib.h>
+
+#include "lvm.h"
+#include "lvm-shell.h"
+
+/* The shell mode keeps a long-lived 'lvm' process running in the shell mode
+ * (the 'lvm> ' prompt) for the current global --config/--devices combination
+ * and sends the commands to it instead of starting a new 'lvm' process for
+ * every call. This saves the config parsing, device scanning and metadata
+ * reading done by every new LVM process. Extra config for a single command is
+ * just added to its command line, shells for a global config or devices filter
+ * that was replaced are terminated.
+ *
+ * Reports and the command log (with the status of the command) are written
+ * by LVM as JSON to a separate pipe (LVM_REPORT_FD), the prompt on stdout is
+ * used to detect the end of the command.
+ */
+
+#define LVM_SHELL_PROMPT "lvm> "
+#define LVM_SHELL_REPORT_FD 3
+
+/* lvm shell splits the command line to at most 64 arguments */
+#define LVM_SHELL_MAX_ARGS 64
+
+/* make sure the status of the command is always part of the report */
+#define LVM_SHELL_LOG_CONFIG "log {report_command_log=1 command_log_selection=\"all\"}"
+
+/* the value LVM uses for successfully processed commands (ECMD_PROCESSED) */
+#define LVM_SHELL_CMD_PROCESSED 1
+
+/* lvm exits with the return code of the command, only ECMD_PROCESSED is
+   turned into 0 (see lvm_return_code() in LVM) */
+#define LVM_SHELL_EXIT_CODE(ret_code) ((ret_code) == LVM_SHELL_CMD_PROCESSED ? 0 : (gint) (ret_code))
+
+/* number of seconds without any output from the shell after which it is
+   considered stuck (and killed) */
+#define LVM_SHELL_TIMEOUT (5 * 60)
+
+typedef struct LVMShell {
+    /* serializes the commands sent to the shell, protects the fields below */
+    GMutex lock;
+    GPid pid;
+    gint in_fd;
+    gint out_fd;
+    gint err_fd;
+    gint report_fd;
+
+    /* protected by shell_lock */
+    gint64 last_used;
+    guint users;
+
+    gint ref_count;
+} LVMShell;
+
+/* protects all the variables below and the table of the shells, only held
+   for looking up the shells, never for the commands sent to them */
+static GMutex shell_lock;
+static GCond shell_cond;
+static GHashTable *shells = NULL;
+static gboolean shell_enabled = FALSE;
+static guint shell_idle_timeout = 0;
+/* the global config and devices filter the shells are running with */
+static gchar *shell_config = NULL;
+static gchar *shell_devices = NULL;
+static gboolean reaper_stop = FALSE;
+static GThread *reaper_thread = NULL;
+
+/* serializes the shell mode changes */
+static GMutex shell_mode_lock;
+
+
+static gboolean lvm_shell_is_alive (LVMShell *shell) {
+    if (shell->pid == 0)
+        return FALSE;
+
+    if (waitpid (shell->pid, NULL, WNOHANG) != 0) {
+        /* either reaped now or not our child anymore */
+        shell->pid = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static LVMShell* lvm_shell_new (void) {
+    LVMShell *shell = g_new0 (LVMShell, 1);
+
+    g_mutex_init (&(shell->lock));
+    shell->in_fd = -1;
+    shell->out_fd = -1;
+    shell->err_fd = -1;
+    shell->report_fd = -1;
+    shell->last_used = g_get_monotonic_time ();
+    shell->ref_count = 1;
+
+    return shell;
+}
+
+/**
+ * lvm_shell_stop: (skip)
+ * @kill_now: whether to kill the shell right away instead of letting it exit
+ *
+ * Stops the shell process (if any) and closes the pipes. The shell can be
+ * started again with lvm_shell_spawn().
+ */
+static void lvm_shell_stop (LVMShell *shell, gboolean kill_now) {
+    struct pollfd fd = { shell->out_fd, POLLIN, 0 };
+    gchar buf[256];
+
+    /* EOF on stdin makes the shell exit */
+    if (shell->in_fd >= 0)
+        close (shell->in_fd);
+
+    if (shell->pid != 0) {
+        /* give the shell some time to exit (closing its stdout) */
+        while (!kill_now && poll (&fd, 1, 1000) > 0 && read (shell->out_fd, buf, sizeof (buf)) > 0)
+            ;
+        if (waitpid (shell->pid, NULL, WNOHANG) == 0) {
+            kill (shell->pid, SIGKILL);
+            waitpid (shell->pid, NULL, 0);
+        }
+    }
+
+    if (shell->out_fd >= 0)
+        close (shell->out_fd);
+    if (shell->err_fd >= 0)
+        close (shell->err_fd);
+    if (shell->report_fd >= 0)
+        close (shell->report_fd);
+
+    shell->pid = 0;
+    shell->in_fd = -1;
+    shell->out_fd = -1;
+    shell->err_fd = -1;
+    shell->report_fd = -1;
+}
+
+static LVMShell* lvm_shell_ref (LVMShell *shell) {
+    g_atomic_int_inc (&(shell->ref_count));
+    return shell;
+}
+
+static void lvm_shell_unref (LVMShell *shell) {
+    if (!g_atomic_int_dec_and_test (&(shell->ref_count)))
+        return;
+
+    lvm_shell_stop (shell, FALSE);
+    g_mutex_clear (&(shell->lock));
+    g_free (shell);
+}
+
+static void lvm_shell_child_setup (gpointer user_data) {
+    gint fd = GPOINTER_TO_INT (user_data);
+
+    /* only async-signal-safe functions here */
+    if (fd == LVM_SHELL_REPORT_FD)
+        fcntl (fd, F_SETFD, 0);
+    else
+        dup2 (fd, LVM_SHELL_REPORT_FD);
+}
+
+static gboolean write_all (gint fd, const gchar *data, gsize len, GError **error) {
+    sigset_t pipe_set;
+    sigset_t old_set;
+    sigset_t pending;
+    gboolean was_pending = FALSE;
+    struct timespec no_wait = { 0, 0 };
+    gssize written = 0;
+    gboolean ret = TRUE;
+
+    /* the shell may die at any time, make sure we don't get killed by SIGPIPE */
+    sigemptyset (&pipe_set);
+    sigaddset (&pipe_set, SIGPIPE);
+    pthread_sigmask (SIG_BLOCK, &pipe_set, &old_set);
+    sigpending (&pending);
+    was_pending = sigismember (&pending, SIGPIPE);
+
+    while (len > 0) {
+        written = write (fd, data, len);
+        if (written < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Failed to write to the LVM shell: %m");
+            if (errno == EPIPE && !was_pending)
+                sigtimedwait (&pipe_set, NULL, &no_wait);
+            ret = FALSE;
+            break;
+        }
+        data += written;
+        len -= written;
+    }
+
+    pthread_sigmask (SIG_SETMASK, &old_set, NULL);
+
+    return ret;
+}
+
+static void drain_fd (gint fd, GString *buffer) {
+    gchar buf[4096];
+    gssize num_read = 0;
+
+    while ((num_read = read (fd, buf, sizeof (buf))) > 0 || (num_read < 0 && errno == EINTR))
+        if (num_read > 0 && buffer)
+            g_string_append_len (buffer, buf, num_read);
+}
+
+/**
+ * lvm_shell_read_response: (skip)
+ *
+ * Reads everything the shell produces until it prints the prompt again.
+ * All the three pipes need to be read at once, otherwise the shell could
+ * block on a full pipe and never get to the prompt.
+ */
+static gboolean lvm_shell_read_response (LVMShell *shell, GString *report, GString *err, GError **error) {
+    struct pollfd fds[3];
+    GString *buffers[3] = { NULL, err, report };
+    GString *out = NULL;
+    gchar buf[4096];
+    gssize num_read = 0;
+    gboolean prompt = FALSE;
+    gboolean ret = TRUE;
+    gint64 deadline = 0;
+    gint64 now = 0;
+    gint poll_ret = 0;
+    guint i = 0;
+
+    out = g_string_new (NULL);
+    buffers[0] = out;
+
+    fds[0].fd = shell->out_fd;
+    fds[1].fd = shell->err_fd;
+    fds[2].fd = shell->report_fd;
+    for (i=0; i < 3; i++)
+        fds[i].events = POLLIN;
+
+    deadline = g_get_monotonic_time () + LVM_SHELL_TIMEOUT * G_TIME_SPAN_SECOND;
+    while (!prompt && ret) {
+        now = g_get_monotonic_time ();
+        if (now >= deadline) {
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Timed out waiting for the LVM shell (no output for %d seconds)",
+                         LVM_SHELL_TIMEOUT);
+            ret = FALSE;
+            break;
+        }
+
+        poll_ret = poll (fds, 3, (gint) ((deadline - now + 999) / 1000));
+        if (poll_ret < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Failed to poll the LVM shell output: %m");
+            ret = FALSE;
+            break;
+        } else if (poll_ret == 0)
+            /* timeout, checked above */
+            continue;
+
+        for (i=0; i < 3 && ret; i++) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            num_read = read (fds[i].fd, buf, sizeof (buf));
+            if (num_read > 0) {
+                if (buffers[i])
+                    g_string_append_len (buffers[i], buf, num_read);
+                /* the shell is making progress */
+                deadline = g_get_monotonic_time () + LVM_SHELL_TIMEOUT * G_TIME_SPAN_SECOND;
+            } else if (num_read == 0 || (errno != EAGAIN && errno != EINTR)) {
+                g_set_error_literal (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                                     "The LVM shell exited unexpectedly");
+                ret = FALSE;
+            }
+        }
+
+        prompt = g_str_has_suffix (out->str, LVM_SHELL_PROMPT);
+        /* only the end of the output is interesting */
+        if (!prompt && out->len > strlen (LVM_SHELL_PROMPT))
+            g_string_erase (out, 0, out->len - strlen (LVM_SHELL_PROMPT));
+    }
+
+    if (ret) {
+        /* everything is written before the prompt, but it may still be in the pipes */
+        drain_fd (shell->err_fd, err);
+        drain_fd (shell->report_fd, report);
+    }
+
+    g_string_free (out, TRUE);
+    return ret;
+}
+
+/**
+ * lvm_shell_spawn: (skip)
+ *
+ * Starts the shell process for @shell and waits for its first prompt. Needs
+ * to be called with the shell's lock held.
+ */
+static gboolean lvm_shell_spawn (LVMShell *shell, GError **error) {
+    const gchar *argv[2] = {"lvm", NULL};
+    gint report_pipe[2] = {-1, -1};
+    gchar **envp = NULL;
+    gchar *fd_str = NULL;
+    gboolean success = FALSE;
+    guint i = 0;
+
+    if (!g_unix_open_pipe (report_pipe, FD_CLOEXEC, error))
+        return FALSE;
+
+    envp = g_get_environ ();
+    envp = g_environ_setenv (envp, "LC_ALL", "C.UTF-8", TRUE);
+    envp = g_environ_unsetenv (envp, "LANGUAGE");
+    fd_str = g_strdup_printf ("%d", LVM_SHELL_REPORT_FD);
+    envp = g_environ_setenv (envp, "LVM_REPORT_FD", fd_str, TRUE);
+    g_free (fd_str);
+
+    success = g_spawn_async_with_pipes (NULL, (gchar **) argv, envp, G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
+                                        lvm_shell_child_setup, GINT_TO_POINTER (report_pipe[1]),
+                                        &(shell->pid), &(shell->in_fd), &(shell->out_fd), &(shell->err_fd), error);
+    g_strfreev (envp);
+    close (report_pipe[1]);
+    if (!success) {
+        close (report_pipe[0]);
+        shell->pid = 0;
+        return FALSE;
+    }
+    shell->report_fd = report_pipe[0];
+
+    for (i=0; i < 3; i++)
+        g_unix_set_fd_nonblocking (i == 0 ? shell->out_fd : (i == 1 ? shell->err_fd : shell->report_fd), TRUE, NULL);
+
+    /* wait for the first prompt */
+    if (!lvm_shell_read_response (shell, NULL, NULL, error)) {
+        g_prefix_error (error, "Failed to start the LVM shell: ");
+        lvm_shell_stop (shell, TRUE);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static gpointer lvm_shell_reaper (gpointer data G_GNUC_UNUSED) {
+    GHashTableIter iter;
+    gpointer value = NULL;
+    LVMShell *shell = NULL;
+    GSList *expired = NULL;
+    gint64 now = 0;
+    gint64 next = 0;
+    gint64 expires = 0;
+
+    g_mutex_lock (&shell_lock);
+    while (!reaper_stop) {
+        now = g_get_monotonic_time ();
+        next = now + shell_idle_timeout * G_TIME_SPAN_SECOND;
+        if (shells) {
+            g_hash_table_iter_init (&iter, shells);
+            while (g_hash_table_iter_next (&iter, NULL, &value)) {
+                shell = (LVMShell *) value;
+                /* shells being used are not idle */
+                if (shell->users > 0)
+                    continue;
+                expires = shell->last_used + shell_idle_timeout * G_TIME_SPAN_SECOND;
+                if (expires <= now) {
+                    expired = g_slist_prepend (expired, shell);
+                    g_hash_table_iter_steal (&iter);
+                } else if (expires < next)
+                    next = expires;
+            }
+        }
+
+        if (expired) {
+            /* stopping the shells may take some time, don't block the callers */
+            g_mutex_unlock (&shell_lock);
+            g_slist_free_full (expired, (GDestroyNotify) lvm_shell_unref);
+            expired = NULL;
+            g_mutex_lock (&shell_lock);
+            continue;
+        }
+
+        g_cond_wait_until (&shell_cond, &shell_lock, next);
+    }
+    g_mutex_unlock (&shell_lock);
+
+    return NULL;
+}
+
+/**
+ * lvm_shell_set_mode: (skip)
+ * @enabled: whether to run the LVM commands in the persistent LVM shells or not
+ * @idle_timeout: number of seconds after which an unused shell is terminated (0 means never)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Disabling the mode terminates all the running shells.
+ */
+gboolean lvm_shell_set_mode (gboolean enabled, guint idle_timeout, GError **error) {
+    GThread *old_reaper = NULL;
+    GHashTable *old_shells = NULL;
+    gboolean ret = TRUE;
+
+    g_mutex_lock (&shell_mode_lock);
+
+    g_mutex_lock (&shell_lock);
+    old_reaper = reaper_thread;
+    reaper_thread = NULL;
+    reaper_stop = TRUE;
+    g_cond_signal (&shell_cond);
+    g_mutex_unlock (&shell_lock);
+
+    if (old_reaper)
+        g_thread_join (old_reaper);
+
+    g_mutex_lock (&shell_lock);
+    shell_enabled = enabled;
+    shell_idle_timeout = idle_timeout;
+    reaper_stop = FALSE;
+    if (!enabled && shells) {
+        old_shells = shells;
+        shells = NULL;
+    } else if (enabled && !shells)
+        shells = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) lvm_shell_unref);
+
+    if (enabled && idle_timeout > 0) {
+        reaper_thread = g_thread_try_new ("lvm-shell-reaper", lvm_shell_reaper, NULL, error);
+        if (!reaper_thread) {
+            g_prefix_error (error, "Failed to start the LVM shell idle timeout thread: ");
+            shell_enabled = FALSE;
+            old_shells = shells;
+            shells = NULL;
+            ret = FALSE;
+        }
+    }
+    g_mutex_unlock (&shell_lock);
+
+    /* shells still being used are stopped once the commands finish */
+    if (old_shells)
+        g_hash_table_destroy (old_shells);
+
+    g_mutex_unlock (&shell_mode_lock);
+
+    return ret;
+}
+
+/**
+ * lvm_shell_set_config: (skip)
+ * @config: (nullable): the new global config
+ * @devices: (nullable): the new devices filter
+ *
+ * Terminates all the shells running with a different global config or devices
+ * filter, they would never be used again. Commands started with the old values
+ * are run directly.
+ */
+void lvm_shell_set_config (const gchar *config, const gchar *devices) {
+    GHashTable *old_shells = NULL;
+
+    g_mutex_lock (&shell_lock);
+    if (g_strcmp0 (config, shell_config) == 0 && g_strcmp0 (devices, shell_devices) == 0) {
+        g_mutex_unlock (&shell_lock);
+        return;
+    }
+
+    g_free (shell_config);
+    shell_config = g_strdup (config);
+    g_free (shell_devices);
+    shell_devices = g_strdup (devices);
+
+    if (shells && g_hash_table_size (shells) > 0) {
+        old_shells = shells;
+        shells = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) lvm_shell_unref);
+    }
+    g_mutex_unlock (&shell_lock);
+
+    /* shells still being used are stopped once the commands finish */
+    if (old_shells)
+        g_hash_table_destroy (old_shells);
+}
+
+static gboolean append_arg (GString *line, const gchar *arg) {
+    gchar quote = '\'';
+
+    /* lvm shell only supports quoting whole arguments and has no escaping */
+    if (strchr (arg, '\n'))
+        return FALSE;
+    if (strchr (arg, '\'')) {
+        if (strchr (arg, '"'))
+            return FALSE;
+        quote = '"';
+    }
+
+    if (line->len > 0)
+        g_string_append_c (line, ' ');
+    g_string_append_c (line, quote);
+    g_string_append (line, arg);
+    g_string_append_c (line, quote);
+
+    return TRUE;
+}
+
+/**
+ * lvm_shell_build_command: (skip)
+ *
+ * Returns: (transfer full): the command line for the LVM shell or %NULL if
+ *                           the command cannot be represented as a shell
+ *                           command line
+ */
+static GString* lvm_shell_build_command (const gchar **args, const BDExtraArg **extra, const gchar *config,
+                                         const gchar *more_config, const gchar *devices) {
+    GString *line = NULL;
+    const gchar **arg_p = NULL;
+    const BDExtraArg **extra_p = NULL;
+    gchar *config_arg = NULL;
+    gchar *devices_arg = NULL;
+    gboolean have_reportformat = FALSE;
+    gboolean ok = TRUE;
+    guint n_args = 2;  /* --config and --reportformat */
+
+    line = g_string_new (NULL);
+    for (arg_p = args; *arg_p && ok; arg_p++) {
+        ok = append_arg (line, *arg_p);
+        have_reportformat = have_reportformat || g_strcmp0 (*arg_p, "--reportformat") == 0;
+        n_args++;
+    }
+    for (extra_p = extra; extra_p && *extra_p && ok; extra_p++) {
+        if ((*extra_p)->opt && (g_strcmp0 ((*extra_p)->opt, "") != 0)) {
+            ok = ok && append_arg (line, (*extra_p)->opt);
+            n_args++;
+        }
+        if ((*extra_p)->val && (g_strcmp0 ((*extra_p)->val, "") != 0)) {
+            ok = ok && append_arg (line, (*extra_p)->val);
+            n_args++;
+        }
+    }
+
+    config_arg = g_strdup_printf ("--config=%s %s %s", LVM_SHELL_LOG_CONFIG, config ? config : "",
+                                  more_config ? more_config : "");
+    ok = ok && append_arg (line, config_arg);
+    g_free (config_arg);
+    if (devices) {
+        devices_arg = g_strdup_printf ("--devices=%s", devices);
+        ok = ok && append_arg (line, devices_arg);
+        g_free (devices_arg);
+        n_args++;
+    }
+    /* the command log (with the status) is only reported in the JSON format */
+    if (!have_reportformat) {
+        g_string_append (line, " --reportformat json_std");
+        n_args++;
+    }
+
+    if (!ok || n_args > LVM_SHELL_MAX_ARGS) {
+        g_string_free (line, TRUE);
+        return NULL;
+    }
+
+    g_string_append_c (line, '\n');
+    return line;
+}
+
+static gint64 get_ret_code (JsonObject *obj) {
+    JsonNode *node = NULL;
+
+    node = json_object_get_member (obj, "log_ret_code");
+    if (!node || JSON_NODE_TYPE (node) != JSON_NODE_VALUE)
+        return -1;
+
+    /* json_std reports numbers, json reports strings */
+    if (json_node_get_value_type (node) == G_TYPE_STRING)
+        return g_ascii_strtoll (json_node_get_string (node), NULL, 10);
+    else
+        return json_node_get_int (node);
+}
+
+static gboolean lvm_shell_check_status (const gchar *report, const gchar *err, GError **error) {
+    JsonParser *parser = NULL;
+    JsonNode *root = NULL;
+    JsonArray *log = NULL;
+    JsonObject *entry = NULL;
+    const gchar *type = NULL;
+    const gchar *msg = NULL;
+    GString *messages = NULL;
+    gint64 ret_code = -1;
+    guint i = 0;
+    GError *l_error = NULL;
+
+    parser = json_parser_new ();
+    if (!json_parser_load_from_data (parser, report, -1, &l_error)) {
+        g_set_error (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to parse JSON report from the LVM shell: %s", l_error->message);
+        g_error_free (l_error);
+        g_object_unref (parser);
+        return FALSE;
+    }
+
+    root = json_parser_get_root (parser);
+    if (root && JSON_NODE_HOLDS_OBJECT (root) && json_object_has_member (json_node_get_object (root), "log"))
+        log = json_object_get_array_member (json_node_get_object (root), "log");
+
+    messages = g_string_new (NULL);
+    for (i=0; log && i < json_array_get_length (log); i++) {
+        entry = json_array_get_object_element (log, i);
+        if (!entry)
+            continue;
+        type = json_object_get_string_member_with_default (entry, "log_type", NULL);
+        if (g_strcmp0 (type, "status") == 0)
+            ret_code = get_ret_code (entry);
+        else if (g_strcmp0 (type, "error") == 0) {
+            msg = json_object_get_string_member_with_default (entry, "log_message", NULL);
+            if (msg)
+                g_string_append_printf (messages, "%s%s", messages->len > 0 ? "\n" : "", msg);
+        }
+    }
+    g_object_unref (parser);
+
+    if (ret_code == -1) {
+        g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                             "Failed to get the command status from the LVM shell report");
+        g_string_free (messages, TRUE);
+        return FALSE;
+    }
+
+    if (ret_code != LVM_SHELL_CMD_PROCESSED) {
+        /* report the same error as if the command was run directly */
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Process reported exit code %d: %s", LVM_SHELL_EXIT_CODE (ret_code),
+                     messages->len > 0 ? messages->str : err);
+        g_string_free (messages, TRUE);
+        return FALSE;
+    }
+
+    g_string_free (messages, TRUE);
+    return TRUE;
+}
+
+static void lvm_shell_checkin (LVMShell *shell) {
+    g_mutex_lock (&shell_lock);
+    shell->users--;
+    shell->last_used = g_get_monotonic_time ();
+    g_mutex_unlock (&shell_lock);
+
+    lvm_shell_unref (shell);
+}
+
+/**
+ * lvm_shell_call: (skip)
+ * @args: LVM command arguments (without "lvm")
+ * @extra: (nullable) (array zero-terminated=1): extra arguments
+ * @config: (nullable): global config string to use for the command
+ * @more_config: (nullable): extra config string for just this command
+ * @devices: (nullable): devices filter string to use for the command
+ * @handled: (out): whether the command was run in an LVM shell or not
+ * @output: (out) (optional): place to store the JSON report of the command
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * If @handled is set to %FALSE, the command was not run (the shell mode is not
+ * enabled, the command cannot be run in the shell, @config and @devices are
+ * not the current global values or the shell failed to start) and the caller
+ * should run it the usual way. Only commands producing
+ * a JSON report can be run if @output is requested.
+ *
+ * Commands for different shells run in parallel, commands for the same shell
+ * are serialized. A shell producing no output for %LVM_SHELL_TIMEOUT seconds
+ * is killed (and started again for the next command) and the command fails.
+ *
+ * Returns: whether the command was successfully run or not
+ */
+gboolean lvm_shell_call (const gchar **args, const BDExtraArg **extra, const gchar *config, const gchar *more_config,
+                         const gchar *devices, gboolean *handled, gchar **output, GError **error) {
+    GString *line = NULL;
+    GString *report = NULL;
+    GString *err = NULL;
+    LVMShell *shell = NULL;
+    gchar *key = NULL;
+    const gchar **arg_p = NULL;
+    gboolean json = FALSE;
+    gboolean success = FALSE;
+    GError *l_error = NULL;
+
+    *handled = FALSE;
+
+    if (output) {
+        for (arg_p = args; *arg_p && !json; arg_p++)
+            json = g_strcmp0 (*arg_p, "--reportformat") == 0;
+        if (!json)
+            return FALSE;
+    }
+
+    line = lvm_shell_build_command (args, extra, config, more_config, devices);
+    if (!line)
+        return FALSE;
+
+    /* check out the shell, the command itself runs without the global lock */
+    g_mutex_lock (&shell_lock);
+    if (!shell_enabled || g_strcmp0 (config, shell_config) != 0 || g_strcmp0 (devices, shell_devices) != 0) {
+        /* disabled or the global config changed after the caller took its copy */
+        g_mutex_unlock (&shell_lock);
+        g_string_free (line, TRUE);
+        return FALSE;
+    }
+
+    key = g_strdup_printf ("%s\n%s", config ? config : "", devices ? devices : "");
+    shell = g_hash_table_lookup (shells, key);
+    if (!shell) {
+        shell = lvm_shell_new ();
+        g_hash_table_insert (shells, key, shell);
+    } else
+        g_free (key);
+    lvm_shell_ref (shell);
+    shell->users++;
+    g_mutex_unlock (&shell_lock);
+
+    g_mutex_lock (&(shell->lock));
+    if (shell->pid != 0 && !lvm_shell_is_alive (shell)) {
+        bd_utils_log_format (BD_UTILS_LOG_INFO, "LVM shell exited, starting a new one");
+        lvm_shell_stop (shell, TRUE);
+    }
+    if (shell->pid == 0 && !lvm_shell_spawn (shell, &l_error)) {
+        bd_utils_log_format (BD_UTILS_LOG_WARNING, "%s, running LVM directly", l_error->message);
+        g_clear_error (&l_error);
+        g_mutex_unlock (&(shell->lock));
+        lvm_shell_checkin (shell);
+        g_string_free (line, TRUE);
+        return FALSE;
+    }
+
+    *handled = TRUE;
+    bd_utils_log_format (BD_UTILS_LOG_INFO, "Running in LVM shell: %.*s", (gint) line->len - 1, line->str);
+
+    report = g_string_new (NULL);
+    err = g_string_new (NULL);
+    success = write_all (shell->in_fd, line->str, line->len, &l_error) &&
+              lvm_shell_read_response (shell, report, err, &l_error);
+    if (!success)
+        /* the shell is dead or stuck, a new one will be started for the next command */
+        lvm_shell_stop (shell, TRUE);
+    g_mutex_unlock (&(shell->lock));
+    lvm_shell_checkin (shell);
+
+    if (!success) {
+        g_propagate_error (error, l_error);
+        g_string_free (report, TRUE);
+        g_string_free (err, TRUE);
+        g_string_free (line, TRUE);
+        return FALSE;
+    }
+
+    if (err->len > 0)
+        bd_utils_log_format (BD_UTILS_LOG_DEBUG, "LVM shell stderr: %s", err->str);
+
+    success = lvm_shell_check_status (report->str, err->str, error);
+    if (success && output)
+        *output = g_string_free (report, FALSE);
+    else
+        g_string_free (report, TRUE);
+
+    g_string_free (err, TRUE);
+    g_string_free (line, TRUE);
+
+    return success;
+}
@@ -0,0 +1,12 @@
+#include <glib.h>
+#include <blockdev/utils.h>
+
+#ifndef BD_LVM_SHELL
+#define BD_LVM_SHELL
+
+gboolean lvm_shell_set_mode (gboolean enabled, guint idle_timeout, GError **error);
+void lvm_shell_set_config (const gchar *config, const gchar *devices);
+gboolean lvm_shell_call (const gchar **args, const BDExtraArg **extra, const gchar *config, const gchar *more_config,
+                         const gchar *devices, gboolean *handled, gchar **output, GError **error);
+
+#endif  /* BD_LVM_SHELL */
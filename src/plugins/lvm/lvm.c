@@ -27,6 +27,7 @@
 
 #include "lvm.h"
 #include "lvm-private.h"
+#include "lvm-shell.h"
 #include "check_deps.h"
 #include "dm_logging.h"
 #include "vdo_stats.h"
@@ -112,6 +113,9 @@ gboolean bd_lvm_init (void) {
  *
  */
 void bd_lvm_close (void) {
+    /* terminate the LVM shells (if any) */
+    lvm_shell_set_mode (FALSE, 0, NULL);
+
     dm_log_with_errno_init (NULL);
     dm_log_init_verbose (0);
 
@@ -122,6 +126,24 @@ void bd_lvm_close (void) {
     g_atomic_int_set (&avail_module_deps, 0);
 }
 
+/**
+ * bd_lvm_probe_deps:
+ *
+ * Checks all the runtime dependencies of the plugin concurrently so that later
+ * availability checks don't need to run them one by one. **This function is
+ * called automatically by the library's initialization functions if
+ * dependency probing is enabled (see bd_set_deps_probing()).**
+ *
+ */
+void bd_lvm_probe_deps (void) {
+    DepsProbe *probe = deps_probe_new ();
+
+    deps_probe_add_deps (probe, &avail_deps, deps, DEPS_LAST, &deps_check_lock);
+    deps_probe_add_features (probe, &avail_features, features, FEATURES_LAST, &deps_check_lock);
+    deps_probe_add_module_deps (probe, &avail_module_deps, module_deps, MODULE_DEPS_LAST, &deps_check_lock);
+    deps_probe_run (probe);
+}
+
 /**
  * bd_lvm_is_tech_avail:
  * @tech: the queried tech
@@ -164,144 +186,267 @@ gboolean bd_lvm_is_tech_avail (BDLVMTech tech, guint64 mode, GError **error) {
     }
 }
 
-static gboolean call_lvm_and_report_error (const gchar **args, const BDExtraArg **extra, gboolean lock_config, GError **error) {
-    gboolean success = FALSE;
-    guint i = 0;
-    guint args_length = g_strv_length ((gchar **) args);
-    g_autofree gchar *config_arg = NULL;
-    g_autofree gchar *devices_arg = NULL;
-
-    if (!check_deps (&avail_deps, DEPS_LVM_MASK, deps, DEPS_LAST, &deps_check_lock, error))
+/**
+ * bd_lvm_set_shell_mode:
+ * @enabled: whether to run LVM commands in persistent LVM shell processes or not
+ * @idle_timeout: number of seconds after which an unused LVM shell process is
+ *                terminated (0 means never)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * In the shell mode, one long-lived `lvm` process running in the shell mode
+ * is kept for the current global config (see %bd_lvm_set_global_config) and
+ * devices filter (see %bd_lvm_set_devices_filter) and the LVM commands are
+ * sent to it instead of running a new `lvm` process for every call. This
+ * avoids parsing the config, scanning the devices and reading the metadata
+ * again for every call. Changing the global config or the devices filter
+ * terminates the shell. Shells that exit are automatically started again on
+ * the next call. Commands that report progress are always run in a new `lvm`
+ * process. A shell that produces no output for 5 minutes is considered stuck
+ * and killed and the command fails.
+ *
+ * Disabling the shell mode terminates all the running LVM shell processes.
+ *
+ * Returns: whether the shell mode was successfully changed or not
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_set_shell_mode (gboolean enabled, guint idle_timeout, GError **error) {
+    if (enabled && !check_deps (&avail_deps, DEPS_LVM_MASK, deps, DEPS_LAST, &deps_check_lock, error))
         return FALSE;
 
-    /* don't allow global config string changes during the run */
-    if (lock_config)
-        g_mutex_lock (&global_config_lock);
+    return lvm_shell_set_mode (enabled, idle_timeout, error);
+}
 
-    /* allocate enough space for the args plus "lvm", "--config", "--devices" and NULL */
-    const gchar **argv = g_new0 (const gchar*, args_length + 4);
+/* the metadata cache, see bd_lvm_set_metadata_cache() */
+typedef struct MetadataCacheEntry {
+    gchar *version;      /* version of the VG the data belong to, see get_vg_versions() */
+    BDLVMVGdata *vg;     /* NULL if not cached (yet) */
+    BDLVMLVdata **lvs;   /* NULL if not cached (yet) */
+} MetadataCacheEntry;
+
+static GMutex metadata_cache_lock;
+static gboolean metadata_cache_enabled = FALSE;
+static GHashTable *metadata_cache = NULL;           /* VG name -> MetadataCacheEntry */
+static BDLVMPVdata **metadata_cache_pvs = NULL;
+static GHashTable *metadata_cache_pvs_versions = NULL;  /* VG name -> version the PVs were cached with */
+static guint64 metadata_cache_hits = 0;
+static guint64 metadata_cache_misses = 0;
+static guint64 metadata_cache_generation = 0;
+
+/* versions of all the VGs from the last probe, see get_vg_versions() */
+static GHashTable *metadata_cache_probe = NULL;
+static gint64 metadata_cache_probe_time = 0;
+
+/* for how long (in microseconds) the versions from a probe are used, this is
+   the delay with which changes made outside of this library are noticed, but
+   a polling round over many LVs or VGs only needs one probe */
+#define METADATA_CACHE_PROBE_TTL (1 * G_TIME_SPAN_SECOND)
+
+static void free_lvs (BDLVMLVdata **lvs) {
+    for (BDLVMLVdata **lv_p = lvs; lv_p && *lv_p; lv_p++)
+        bd_lvm_lvdata_free (*lv_p);
+    g_free (lvs);
+}
 
-    /* construct argv from args with "lvm" prepended */
-    argv[0] = "lvm";
-    for (i=0; i < args_length; i++)
-        argv[i+1] = args[i];
-    if (global_config_str) {
-        config_arg = g_strdup_printf ("--config=%s", global_config_str);
-        argv[++args_length] = config_arg;
+static void free_pvs (BDLVMPVdata **pvs) {
+    for (BDLVMPVdata **pv_p = pvs; pv_p && *pv_p; pv_p++)
+        bd_lvm_pvdata_free (*pv_p);
+    g_free (pvs);
+}
+
+static void metadata_cache_entry_free (MetadataCacheEntry *entry) {
+    g_free (entry->version);
+    bd_lvm_vgdata_free (entry->vg);
+    free_lvs (entry->lvs);
+    g_free (entry);
+}
+
+/* must be called with metadata_cache_lock held */
+static void metadata_cache_clear_probe (void) {
+    if (metadata_cache_probe) {
+        g_hash_table_destroy (metadata_cache_probe);
+        metadata_cache_probe = NULL;
     }
-    if (global_devices_str) {
-        devices_arg = g_strdup_printf ("--devices=%s", global_devices_str);
-        argv[++args_length] = devices_arg;
+}
+
+/* must be called with metadata_cache_lock held */
+static void metadata_cache_clear_pvs (void) {
+    free_pvs (metadata_cache_pvs);
+    metadata_cache_pvs = NULL;
+    if (metadata_cache_pvs_versions) {
+        g_hash_table_destroy (metadata_cache_pvs_versions);
+        metadata_cache_pvs_versions = NULL;
     }
-    argv[++args_length] = NULL;
+}
 
-    success = bd_utils_exec_and_report_error (argv, extra, error);
-    if (lock_config)
-        g_mutex_unlock (&global_config_lock);
-    g_free (argv);
+/* @generation is used to make sure data that may predate an invalidation are not stored */
+static gboolean metadata_cache_active (guint64 *generation) {
+    gboolean ret = FALSE;
 
-    return success;
+    g_mutex_lock (&metadata_cache_lock);
+    ret = metadata_cache_enabled;
+    *generation = metadata_cache_generation;
+    g_mutex_unlock (&metadata_cache_lock);
+
+    return ret;
 }
 
-static gboolean call_lvm_and_capture_output (const gchar **args, const BDExtraArg **extra, gchar **output, GError **error) {
-    gboolean success = FALSE;
+/* drops the cached data for @vg_name or everything if @vg_name is %NULL, the
+   PVs are always dropped because they include information about their VGs */
+static void metadata_cache_invalidate (const gchar *vg_name) {
+    g_mutex_lock (&metadata_cache_lock);
+    if (metadata_cache) {
+        if (vg_name)
+            g_hash_table_remove (metadata_cache, vg_name);
+        else
+            g_hash_table_remove_all (metadata_cache);
+    }
+    metadata_cache_clear_pvs ();
+    metadata_cache_clear_probe ();
+    metadata_cache_generation++;
+    g_mutex_unlock (&metadata_cache_lock);
+}
+
+
+/* argv for a single LVM call with the global config and devices filter
+   snapshotted so that global_config_lock doesn't need to be held while the
+   command runs and independent commands can run in parallel */
+typedef struct LVMCallArgs {
+    const gchar **argv;
+    gchar *config;
+    const gchar *more_config;
+    gchar *devices;
+    gchar *config_arg;
+    gchar *devices_arg;
+} LVMCallArgs;
+
+/* @more_config (if given) is appended to the global config for this call */
+static void lvm_call_args_init (LVMCallArgs *call, const gchar **args, const gchar *more_config) {
     guint i = 0;
     guint args_length = g_strv_length ((gchar **) args);
-    g_autofree gchar *config_arg = NULL;
-    g_autofree gchar *devices_arg = NULL;
 
-    if (!check_deps (&avail_deps, DEPS_LVM_MASK, deps, DEPS_LAST, &deps_check_lock, error))
-        return FALSE;
-
-    /* don't allow global config string changes during the run */
+    /* just take a copy, config changes only affect the calls started after them */
     g_mutex_lock (&global_config_lock);
+    call->config = g_strdup (global_config_str);
+    call->devices = g_strdup (global_devices_str);
+    g_mutex_unlock (&global_config_lock);
+    call->more_config = more_config;
 
     /* allocate enough space for the args plus "lvm", "--config", "--devices" and NULL */
-    const gchar **argv = g_new0 (const gchar*, args_length + 4);
+    call->argv = g_new0 (const gchar*, args_length + 4);
 
     /* construct argv from args with "lvm" prepended */
-    argv[0] = "lvm";
+    call->argv[0] = "lvm";
     for (i=0; i < args_length; i++)
-        argv[i+1] = args[i];
-    if (global_config_str) {
-        config_arg = g_strdup_printf ("--config=%s", global_config_str);
-        argv[++args_length] = config_arg;
+        call->argv[i+1] = args[i];
+    call->config_arg = NULL;
+    if (call->config || call->more_config) {
+        call->config_arg = g_strdup_printf ("--config=%s %s", call->config ? call->config : "",
+                                            call->more_config ? call->more_config : "");
+        call->argv[++args_length] = call->config_arg;
     }
-    if (global_devices_str) {
-        devices_arg = g_strdup_printf ("--devices=%s", global_devices_str);
-        argv[++args_length] = devices_arg;
+    call->devices_arg = NULL;
+    if (call->devices) {
+        call->devices_arg = g_strdup_printf ("--devices=%s", call->devices);
+        call->argv[++args_length] = call->devices_arg;
     }
-    argv[++args_length] = NULL;
+    call->argv[++args_length] = NULL;
+}
 
-    success = bd_utils_exec_and_capture_output (argv, extra, output, error);
-    g_mutex_unlock (&global_config_lock);
-    g_free (argv);
+static void lvm_call_args_clear (LVMCallArgs *call) {
+    g_free (call->argv);
+    g_free (call->config);
+    g_free (call->devices);
+    g_free (call->config_arg);
+    g_free (call->devices_arg);
+}
+
+void lvm_global_config_changed (void) {
+    lvm_shell_set_config (global_config_str, global_devices_str);
+
+    /* LVM may report different things now */
+    metadata_cache_invalidate (NULL);
+}
+
+static gboolean call_lvm_and_report_error (const gchar **args, const BDExtraArg **extra, const gchar *more_config, GError **error) {
+    gboolean success = FALSE;
+    gboolean shell_used = FALSE;
+    LVMCallArgs call;
+
+    if (!check_deps (&avail_deps, DEPS_LVM_MASK, deps, DEPS_LAST, &deps_check_lock, error))
+        return FALSE;
+
+    lvm_call_args_init (&call, args, more_config);
+
+    success = lvm_shell_call (args, extra, call.config, call.more_config, call.devices, &shell_used, NULL, error);
+    if (!shell_used)
+        success = bd_utils_exec_and_report_error (call.argv, extra, error);
+    lvm_call_args_clear (&call);
+
+    /* commands not producing any output change things */
+    metadata_cache_invalidate (NULL);
 
     return success;
 }
 
-static gboolean call_lvm_and_report_progress (const gchar **args, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, gint *proc_status, GError **error) {
+static gboolean call_lvm_and_capture_output (const gchar **args, const BDExtraArg **extra, gchar **output, GError **error) {
     gboolean success = FALSE;
-    guint i = 0;
-    guint args_length = g_strv_length ((gchar **) args);
-    g_autofree gchar *config_arg = NULL;
-    g_autofree gchar *devices_arg = NULL;
+    gboolean shell_used = FALSE;
+    LVMCallArgs call;
 
     if (!check_deps (&avail_deps, DEPS_LVM_MASK, deps, DEPS_LAST, &deps_check_lock, error))
         return FALSE;
 
-    /* don't allow global config string changes during the run */
-    g_mutex_lock (&global_config_lock);
+    lvm_call_args_init (&call, args, NULL);
 
-    /* allocate enough space for the args plus "lvm", "--config", "--devices" and NULL */
-    const gchar **argv = g_new0 (const gchar*, args_length + 4);
+    success = lvm_shell_call (args, extra, call.config, call.more_config, call.devices, &shell_used, output, error);
+    if (!shell_used)
+        success = bd_utils_exec_and_capture_output (call.argv, extra, output, error);
+    lvm_call_args_clear (&call);
 
-    /* construct argv from args with "lvm" prepended */
-    argv[0] = "lvm";
-    for (i=0; i < args_length; i++)
-        argv[i+1] = args[i];
-    if (global_config_str) {
-        config_arg = g_strdup_printf ("--config=%s", global_config_str);
-        argv[++args_length] = config_arg;
-    }
-    if (global_devices_str) {
-        devices_arg = g_strdup_printf ("--devices=%s", global_devices_str);
-        argv[++args_length] = devices_arg;
-    }
-    argv[++args_length] = NULL;
+    return success;
+}
 
-    success = bd_utils_exec_and_report_progress (argv, extra, prog_extract, proc_status, error);
-    g_mutex_unlock (&global_config_lock);
-    g_free (argv);
+static gboolean call_lvm_and_report_progress (const gchar **args, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, gint *proc_status, GError **error) {
+    gboolean success = FALSE;
+    LVMCallArgs call;
+
+    if (!check_deps (&avail_deps, DEPS_LVM_MASK, deps, DEPS_LAST, &deps_check_lock, error))
+        return FALSE;
+
+    lvm_call_args_init (&call, args, NULL);
+
+    success = bd_utils_exec_and_report_progress (call.argv, extra, prog_extract, proc_status, error);
+    lvm_call_args_clear (&call);
+
+    /* commands reporting progress change things */
+    metadata_cache_invalidate (NULL);
 
     return success;
 }
 
 /**
- * call_lvm_and_parse_json_report:
+ * call_lvm_and_parse_json:
  * @args: LVM command arguments (must include --reportformat json_std)
- * @report_key: the key in the report object to extract (e.g., "pv", "vg", "lv")
  * @out_parser: (out): the JsonParser that owns the returned array; caller must unref
  * @allow_no_output: if %TRUE, return %NULL without error when there is no output
  * @error: (out) (optional): place to store error
  *
- * Runs an LVM command, parses its JSON output, and returns the array of objects
- * from the report section identified by @report_key.
+ * Runs an LVM command, parses its JSON output, and returns the array of report
+ * objects (one for every VG for 'lvm fullreport', just one for the other commands).
  *
- * Returns: (transfer none): the JsonArray from the report, owned by @out_parser,
+ * Returns: (transfer none): the "report" JsonArray, owned by @out_parser,
  *          or %NULL on error (or empty output if @allow_no_output is %TRUE)
  */
-static JsonArray* call_lvm_and_parse_json_report (const gchar **args,
-                                                   const gchar *report_key,
-                                                   JsonParser **out_parser,
-                                                   gboolean allow_no_output,
-                                                   GError **error) {
+static JsonArray* call_lvm_and_parse_json (const gchar **args,
+                                           JsonParser **out_parser,
+                                           gboolean allow_no_output,
+                                           GError **error) {
     gboolean success = FALSE;
     gchar *output = NULL;
     JsonParser *parser = NULL;
+    JsonNode *root = NULL;
     JsonArray *report_array = NULL;
-    JsonObject *report_obj = NULL;
-    JsonArray *data_array = NULL;
     GError *l_error = NULL;
 
     *out_parser = NULL;
@@ -327,10 +472,52 @@ static JsonArray* call_lvm_and_parse_json_report (const gchar **args,
     }
     g_free (output);
 
-    report_array = json_object_get_array_member (
-        json_node_get_object (json_parser_get_root (parser)), "report");
+    root = json_parser_get_root (parser);
+    if (root && JSON_NODE_HOLDS_OBJECT (root))
+        report_array = json_object_get_array_member (json_node_get_object (root), "report");
+
+    if (!report_array) {
+        g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                             "Failed to parse LVM report");
+        g_object_unref (parser);
+        return NULL;
+    }
+
+    *out_parser = parser;
+    return report_array;
+}
+
+/**
+ * call_lvm_and_parse_json_report:
+ * @args: LVM command arguments (must include --reportformat json_std)
+ * @report_key: the key in the report object to extract (e.g., "pv", "vg", "lv")
+ * @out_parser: (out): the JsonParser that owns the returned array; caller must unref
+ * @allow_no_output: if %TRUE, return %NULL without error when there is no output
+ * @error: (out) (optional): place to store error
+ *
+ * Runs an LVM command, parses its JSON output, and returns the array of objects
+ * from the report section identified by @report_key.
+ *
+ * Returns: (transfer none): the JsonArray from the report, owned by @out_parser,
+ *          or %NULL on error (or empty output if @allow_no_output is %TRUE)
+ */
+static JsonArray* call_lvm_and_parse_json_report (const gchar **args,
+                                                   const gchar *report_key,
+                                                   JsonParser **out_parser,
+                                                   gboolean allow_no_output,
+                                                   GError **error) {
+    JsonParser *parser = NULL;
+    JsonArray *report_array = NULL;
+    JsonObject *report_obj = NULL;
+    JsonArray *data_array = NULL;
+
+    *out_parser = NULL;
+
+    report_array = call_lvm_and_parse_json (args, &parser, allow_no_output, error);
+    if (!report_array)
+        return NULL;
 
-    if (!report_array || json_array_get_length (report_array) == 0) {
+    if (json_array_get_length (report_array) == 0) {
         g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
                              "Failed to parse LVM report");
         g_object_unref (parser);
@@ -351,6 +538,185 @@ static JsonArray* call_lvm_and_parse_json_report (const gchar **args,
     return data_array;
 }
 
+/* function called for every row of a streamed LVM report, @section is the key
+   of the report section (e.g. "pv", "vg", "lv" or "seg") the row belongs to */
+typedef void (*LVMReportRowFunc) (const gchar *section, JsonObject *row, gpointer user_data);
+
+/* state of a streamed LVM JSON report decoding, see call_lvm_and_stream_json_report() */
+typedef struct LVMReportStream {
+    LVMReportRowFunc row_func;
+    gpointer user_data;
+    JsonParser *parser;
+    gchar *section;
+    GError *error;
+} LVMReportStream;
+
+/* passes all rows of all sections of a complete report object to the row function */
+static void stream_report_object (LVMReportStream *stream, JsonObject *obj) {
+    JsonArray *report_array = NULL;
+    JsonObject *report_obj = NULL;
+    JsonNode *member = NULL;
+    GList *members = NULL;
+    GList *member_it = NULL;
+
+    if (!json_object_has_member (obj, "report")) {
+        g_set_error_literal (&stream->error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                             "Failed to parse LVM report");
+        return;
+    }
+
+    report_array = json_object_get_array_member (obj, "report");
+    for (guint i = 0; report_array && i < json_array_get_length (report_array); i++) {
+        report_obj = json_array_get_object_element (report_array, i);
+        members = json_object_get_members (report_obj);
+        for (member_it = members; member_it; member_it = member_it->next) {
+            member = json_object_get_member (report_obj, member_it->data);
+            if (!JSON_NODE_HOLDS_ARRAY (member))
+                continue;
+            for (guint j = 0; j < json_array_get_length (json_node_get_array (member)); j++)
+                stream->row_func (member_it->data, json_array_get_object_element (json_node_get_array (member), j),
+                                  stream->user_data);
+        }
+        g_list_free (members);
+    }
+}
+
+/* LVM prints every row of a JSON report as well as every section header
+   ('"lv": [') on a separate line so the rows can be decoded one by one as they
+   are read without ever having the whole report (and its DOM) in memory */
+static gboolean process_report_line (const gchar *line, gboolean is_stderr, gpointer user_data) {
+    LVMReportStream *stream = (LVMReportStream *) user_data;
+    const gchar *start = line;
+    const gchar *end = NULL;
+    const gchar *key_end = NULL;
+    JsonNode *root = NULL;
+    GError *l_error = NULL;
+
+    /* keep the error output for the error message */
+    if (is_stderr)
+        return TRUE;
+
+    /* nothing more to do after a failure */
+    if (stream->error)
+        return FALSE;
+
+    while (g_ascii_isspace (*start))
+        start++;
+    end = start + strlen (start);
+    while (end > start && g_ascii_isspace (*(end - 1)))
+        end--;
+    if (end > start && *(end - 1) == ',')
+        end--;
+    if (end == start)
+        return FALSE;
+
+    if (*start == '"' && *(end - 1) == '[') {
+        /* header of a new section */
+        key_end = strchr (start + 1, '"');
+        if (key_end) {
+            g_free (stream->section);
+            stream->section = g_strndup (start + 1, key_end - start - 1);
+        }
+        return FALSE;
+    }
+
+    if (*start == '"') {
+        /* a key-value pair on its own line, not what LVM produces */
+        g_set_error (&stream->error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to parse LVM report: unexpected line '%.*s'", (int) (end - start), start);
+        return FALSE;
+    }
+
+    /* only rows are interesting, not the lines with just the brackets */
+    if (*start != '{' || *(end - 1) != '}' || end - start < 3)
+        return FALSE;
+
+    if (!json_parser_load_from_data (stream->parser, start, end - start, &l_error)) {
+        g_set_error (&stream->error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                     "Failed to parse JSON output from LVM: %s", l_error->message);
+        g_error_free (l_error);
+        return FALSE;
+    }
+
+    root = json_parser_get_root (stream->parser);
+    if (!root || !JSON_NODE_HOLDS_OBJECT (root)) {
+        g_set_error_literal (&stream->error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
+                             "Failed to parse LVM report");
+        return FALSE;
+    }
+
+    if (!stream->section)
+        /* not a row but the whole report on a single line */
+        stream_report_object (stream, json_node_get_object (root));
+    else
+        stream->row_func (stream->section, json_node_get_object (root), stream->user_data);
+
+    return FALSE;
+}
+
+/**
+ * call_lvm_and_stream_json_report:
+ * @args: LVM command arguments (must include --reportformat json_std)
+ * @row_func: function to call for every row of the report
+ * @user_data: data to pass to @row_func
+ * @error: (out) (optional): place to store error
+ *
+ * Runs an LVM command and decodes its JSON report row by row as the output is
+ * read, passing every row to @row_func. No output means no rows, not an error.
+ *
+ * In the LVM shell mode the report is only decoded row by row after the whole
+ * of it was read (the command status is at the end of the report and has to be
+ * checked first) so there is no memory or latency benefit in that mode.
+ *
+ * Returns: whether the command was successfully run and its report decoded or not
+ */
+static gboolean call_lvm_and_stream_json_report (const gchar **args, LVMReportRowFunc row_func, gpointer user_data, GError **error) {
+    gboolean success = FALSE;
+    gboolean shell_used = FALSE;
+    LVMCallArgs call;
+    gchar *output = NULL;
+    gchar *line = NULL;
+    gchar *line_end = NULL;
+    LVMReportStream stream = { row_func, user_data, NULL, NULL, NULL };
+    GError *l_error = NULL;
+
+    if (!check_deps (&avail_deps, DEPS_LVM_MASK, deps, DEPS_LAST, &deps_check_lock, error))
+        return FALSE;
+
+    lvm_call_args_init (&call, args, NULL);
+
+    stream.parser = json_parser_new ();
+
+    success = lvm_shell_call (args, NULL, call.config, call.more_config, call.devices, &shell_used, &output, &l_error);
+    if (!shell_used)
+        success = bd_utils_exec_and_stream_lines (call.argv, NULL, process_report_line, &stream, 0, NULL, &l_error);
+    else if (success) {
+        /* the shell gives us the whole report at once, just split it */
+        for (line = output; line && *line; line = line_end ? line_end + 1 : NULL) {
+            line_end = strchr (line, '\n');
+            if (line_end)
+                *line_end = '\0';
+            process_report_line (line, FALSE, &stream);
+        }
+    }
+    lvm_call_args_clear (&call);
+    g_free (output);
+
+    if (success && stream.error) {
+        g_propagate_error (&l_error, stream.error);
+        stream.error = NULL;
+        success = FALSE;
+    }
+    if (!success)
+        g_propagate_error (error, l_error);
+
+    g_clear_error (&stream.error);
+    g_free (stream.section);
+    g_object_unref (stream.parser);
+
+    return success;
+}
+
 
 /* LVM json_std outputs "" for absent string values (e.g. vg_name for a PV
    not in any VG). Convert these to NULL for consistency with the dbus plugin. */
@@ -590,29 +956,103 @@ static BDLVMLVdata* get_lv_data_from_json (JsonObject *lv_obj) {
     return data;
 }
 
-static void merge_lv_data (BDLVMLVdata *data, BDLVMLVdata *more_data) {
+/* LVs with multiple segments are reported once for every segment, this puts
+   them back together with a hash index keyed by (VG, LV) so that the whole
+   report is processed in linear time */
+typedef struct LVsAssembly {
+    GPtrArray *lvs;         /* assembled LVs in the order of the report */
+    GPtrArray *more_segs;   /* additional segments (GPtrArray or NULL) for every LV in lvs */
+    GHashTable *index;      /* "vg/lv" -> position in lvs + 1 */
+    gboolean tree;          /* whether to merge segments or just drop duplicates */
+} LVsAssembly;
+
+static void lvs_assembly_init (LVsAssembly *assembly, gboolean tree) {
+    assembly->lvs = g_ptr_array_new ();
+    assembly->more_segs = g_ptr_array_new ();
+    assembly->index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    assembly->tree = tree;
+}
+
+static void merge_lv_data (LVsAssembly *assembly, guint pos, BDLVMLVdata *more_data) {
   /* LVM2 guarantees:
      - more_data->data_lvs is NULL
      - more_data->metadata_lvs is NULL
      - more_data->segs has zero or one entry
      - more_data->seg_type is the same as data->seg_type (after mapping "error" to "linear")
   */
+  GPtrArray *segs = NULL;
 
   if (more_data->segs && more_data->segs[0]) {
-    int i;
-    for (i = 0; data->segs && data->segs[i]; i++)
-      ;
-
-    BDLVMSEGdata **new_segs = g_new0 (BDLVMSEGdata *, i+2);
-    for (i = 0; data->segs && data->segs[i]; i++)
-      new_segs[i] = data->segs[i];
-    new_segs[i] = more_data->segs[0];
-    g_free (data->segs);
-    data->segs = new_segs;
+    segs = (GPtrArray *) g_ptr_array_index (assembly->more_segs, pos);
+    if (!segs) {
+      segs = g_ptr_array_new ();
+      assembly->more_segs->pdata[pos] = segs;
+    }
+    g_ptr_array_add (segs, more_data->segs[0]);
     more_data->segs[0] = NULL;
   }
 }
 
+/* takes over @lvdata */
+static void lvs_assembly_add (LVsAssembly *assembly, BDLVMLVdata *lvdata) {
+    gchar *key = NULL;
+    guint pos = 0;
+
+    /* '/' is not allowed in VG names so this cannot be ambiguous */
+    key = g_strdup_printf ("%s/%s", lvdata->vg_name ? lvdata->vg_name : "", lvdata->lv_name ? lvdata->lv_name : "");
+    pos = GPOINTER_TO_UINT (g_hash_table_lookup (assembly->index, key));
+    if (pos > 0) {
+        if (assembly->tree)
+            merge_lv_data (assembly, pos - 1, lvdata);
+        else
+            bd_utils_log_format (BD_UTILS_LOG_DEBUG, "Duplicate LV entry for '%s' found in lvs output", key);
+        g_free (key);
+        bd_lvm_lvdata_free (lvdata);
+        return;
+    }
+
+    g_ptr_array_add (assembly->lvs, lvdata);
+    g_ptr_array_add (assembly->more_segs, NULL);
+    g_hash_table_insert (assembly->index, key, GUINT_TO_POINTER (assembly->lvs->len));
+}
+
+/* returns a NULL-terminated array of the assembled LVs, @assembly is freed */
+static BDLVMLVdata** lvs_assembly_finish (LVsAssembly *assembly) {
+    BDLVMLVdata *data = NULL;
+    GPtrArray *segs = NULL;
+    guint n_segs = 0;
+    BDLVMSEGdata **new_segs = NULL;
+
+    for (guint i = 0; i < assembly->lvs->len; i++) {
+        segs = (GPtrArray *) g_ptr_array_index (assembly->more_segs, i);
+        if (!segs)
+            continue;
+
+        data = (BDLVMLVdata *) g_ptr_array_index (assembly->lvs, i);
+        for (n_segs = 0; data->segs && data->segs[n_segs]; n_segs++)
+            ;
+        new_segs = g_new0 (BDLVMSEGdata *, n_segs + segs->len + 1);
+        if (n_segs > 0)
+            memcpy (new_segs, data->segs, n_segs * sizeof (BDLVMSEGdata *));
+        memcpy (new_segs + n_segs, segs->pdata, segs->len * sizeof (BDLVMSEGdata *));
+        g_free (data->segs);
+        data->segs = new_segs;
+        g_ptr_array_free (segs, TRUE);
+    }
+
+    g_ptr_array_free (assembly->more_segs, TRUE);
+    g_hash_table_destroy (assembly->index);
+
+    /* returning NULL-terminated array of BDLVMLVdata */
+    g_ptr_array_add (assembly->lvs, NULL);
+    return (BDLVMLVdata **) g_ptr_array_free (assembly->lvs, FALSE);
+}
+
+/* drops everything assembled so far (e.g. on error), @assembly is freed */
+static void lvs_assembly_clear (LVsAssembly *assembly) {
+    free_lvs (lvs_assembly_finish (assembly));
+}
+
 static BDLVMVDOPooldata* get_vdo_data_from_json (JsonObject *vdo_obj) {
     BDLVMVDOPooldata *data = g_new0 (BDLVMVDOPooldata, 1);
     const gchar *value = NULL;
@@ -682,10 +1122,481 @@ static BDLVMVDOPooldata* get_vdo_data_from_json (JsonObject *vdo_obj) {
     else
         data->saving_percent = 0;
 
-    data->compression = (gboolean) json_object_get_int_member_with_default (vdo_obj, "vdo_compression", 0);
-    data->deduplication = (gboolean) json_object_get_int_member_with_default (vdo_obj, "vdo_deduplication", 0);
+    data->compression = (gboolean) json_object_get_int_member_with_default (vdo_obj, "vdo_compression", 0);
+    data->deduplication = (gboolean) json_object_get_int_member_with_default (vdo_obj, "vdo_deduplication", 0);
+
+    return data;
+}
+
+/* "vg_uuid/vg_seqno/vg_missing_pv_count" of the VG the @row is about, the
+   state of its DM maps is added by versions_add_dm_states() */
+static gchar* vg_version_from_json (JsonObject *row) {
+    return g_strdup_printf ("%s/%"G_GINT64_FORMAT"/%"G_GINT64_FORMAT,
+                            json_object_get_string_member_with_default (row, "vg_uuid", ""),
+                            json_object_get_int_member_with_default (row, "vg_seqno", 0),
+                            json_object_get_int_member_with_default (row, "vg_missing_pv_count", 0));
+}
+
+/* adds the version of the VG the @row is about to @versions (if not there yet) */
+static void versions_add_row (GHashTable *versions, JsonObject *row) {
+    const gchar *vg_name = json_object_get_string_member_with_default (row, "vg_name", "");
+
+    if (*vg_name == '\0' || g_hash_table_contains (versions, vg_name))
+        return;
+
+    g_hash_table_insert (versions, g_strdup (vg_name), vg_version_from_json (row));
+}
+
+static void add_vg_version_row (const gchar *section, JsonObject *row, gpointer user_data) {
+    if (g_strcmp0 (section, "vg") == 0)
+        versions_add_row ((GHashTable *) user_data, row);
+}
+
+static GHashTable* versions_new (void) {
+    return g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+}
+
+static GHashTable* versions_copy (GHashTable *versions, const gchar *vg_name) {
+    GHashTable *ret = versions_new ();
+    GHashTableIter iter;
+    gpointer key = NULL;
+    gpointer value = NULL;
+
+    g_hash_table_iter_init (&iter, versions);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+        if (!vg_name || g_strcmp0 (vg_name, key) == 0)
+            g_hash_table_insert (ret, g_strdup (key), g_strdup (value));
+
+    return ret;
+}
+
+/* VG name -> state of the DM maps of the VG's active LVs, see get_lvm_dm_states() */
+static GHashTable* get_vg_dm_states (void) {
+    GHashTable *dm_states = NULL;
+    GError *l_error = NULL;
+
+    dm_states = get_lvm_dm_states (&l_error);
+    if (!dm_states) {
+        /* DM not available (e.g. the dm-mod module not loaded), so there can be no active LVs */
+        bd_utils_log_format (BD_UTILS_LOG_DEBUG, "Failed to get the state of the active LVs: %s", l_error->message);
+        g_clear_error (&l_error);
+    }
+
+    return dm_states;
+}
+
+/* appends the DM state to all the versions in @versions, takes over @dm_states */
+static void versions_add_dm_states (GHashTable *versions, GHashTable *dm_states) {
+    GHashTableIter iter;
+    gpointer key = NULL;
+    gpointer value = NULL;
+    const gchar *dm_state = NULL;
+
+    g_hash_table_iter_init (&iter, versions);
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+        dm_state = dm_states ? g_hash_table_lookup (dm_states, key) : NULL;
+        g_hash_table_iter_replace (&iter, g_strdup_printf ("%s|%s", (gchar *) value, dm_state ? dm_state : ""));
+    }
+    if (dm_states)
+        g_hash_table_destroy (dm_states);
+}
+
+/**
+ * get_vg_versions:
+ * @vg_name: (nullable): VG to get the version of or %NULL for all VGs
+ * @generation: generation of the cache the caller works with
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * The VG metadata sequence number changes with every change of the VG, the
+ * UUID makes sure a VG that was recreated with the same name is not mistaken
+ * for the original one. The number of missing PVs and the state of the DM maps
+ * of the VG's active LVs (see get_lvm_dm_states()) are added because they
+ * change without any change of the metadata (e.g. when a PV disappears or an
+ * LV is activated or opened). Getting these is much cheaper than getting the
+ * full information about the LVs.
+ *
+ * The versions of all the VGs are probed at once and the result is reused for
+ * %METADATA_CACHE_PROBE_TTL (or until a change is made by this library).
+ *
+ * Returns: (transfer full): VG name -> "vg_uuid/vg_seqno/missing_pvs|dm_state"
+ *                           table or %NULL in case of error
+ */
+static GHashTable* get_vg_versions (const gchar *vg_name, guint64 generation, GError **error) {
+    const gchar *args[6] = {"vgs", "--reportformat", "json_std",
+                            "-o", "vg_name,vg_uuid,vg_seqno,vg_missing_pv_count", NULL};
+    GHashTable *versions = NULL;
+    GHashTable *dm_states = NULL;
+    GHashTable *ret = NULL;
+    gint64 probe_time = g_get_monotonic_time ();
+
+    g_mutex_lock (&metadata_cache_lock);
+    if (metadata_cache_probe && probe_time - metadata_cache_probe_time < METADATA_CACHE_PROBE_TTL)
+        ret = versions_copy (metadata_cache_probe, vg_name);
+    g_mutex_unlock (&metadata_cache_lock);
+    if (ret)
+        return ret;
+
+    dm_states = get_vg_dm_states ();
+    versions = versions_new ();
+    if (!call_lvm_and_stream_json_report (args, add_vg_version_row, versions, error)) {
+        if (dm_states)
+            g_hash_table_destroy (dm_states);
+        g_hash_table_destroy (versions);
+        return NULL;
+    }
+    versions_add_dm_states (versions, dm_states);
+
+    ret = versions_copy (versions, vg_name);
+
+    g_mutex_lock (&metadata_cache_lock);
+    if (metadata_cache_enabled && generation == metadata_cache_generation) {
+        metadata_cache_clear_probe ();
+        metadata_cache_probe = versions;
+        metadata_cache_probe_time = probe_time;
+        versions = NULL;
+    }
+    g_mutex_unlock (&metadata_cache_lock);
+    if (versions)
+        g_hash_table_destroy (versions);
+
+    return ret;
+}
+
+/* returns the cache entry for @vg_name if it matches @version, drops it if it doesn't,
+   must be called with metadata_cache_lock held */
+static MetadataCacheEntry* metadata_cache_get_entry (const gchar *vg_name, const gchar *version) {
+    MetadataCacheEntry *entry = NULL;
+
+    if (!metadata_cache)
+        return NULL;
+
+    entry = g_hash_table_lookup (metadata_cache, vg_name);
+    if (entry && g_strcmp0 (entry->version, version) != 0) {
+        g_hash_table_remove (metadata_cache, vg_name);
+        entry = NULL;
+    }
+
+    return entry;
+}
+
+/* returns the cache entry for @vg_name with @version (creating it if needed),
+   must be called with metadata_cache_lock held */
+static MetadataCacheEntry* metadata_cache_ensure_entry (const gchar *vg_name, const gchar *version) {
+    MetadataCacheEntry *entry = metadata_cache_get_entry (vg_name, version);
+
+    if (!entry) {
+        entry = g_new0 (MetadataCacheEntry, 1);
+        entry->version = g_strdup (version);
+        g_hash_table_insert (metadata_cache, g_strdup (vg_name), entry);
+    }
+
+    return entry;
+}
+
+/* must be called with metadata_cache_lock held */
+static void metadata_cache_count (gboolean hit) {
+    if (hit)
+        metadata_cache_hits++;
+    else
+        metadata_cache_misses++;
+}
+
+/* whether there is anything cached for @vg_name (LVs of any VG if %NULL) at
+   all, if not, there's no need to check the versions before querying LVM */
+static gboolean metadata_cache_has (const gchar *vg_name, gboolean lvs) {
+    MetadataCacheEntry *entry = NULL;
+    GHashTableIter iter;
+    gpointer value = NULL;
+    gboolean ret = FALSE;
+
+    g_mutex_lock (&metadata_cache_lock);
+    if (metadata_cache && vg_name) {
+        entry = g_hash_table_lookup (metadata_cache, vg_name);
+        ret = entry && (lvs ? entry->lvs != NULL : entry->vg != NULL);
+    } else if (metadata_cache) {
+        g_hash_table_iter_init (&iter, metadata_cache);
+        while (!ret && g_hash_table_iter_next (&iter, NULL, &value))
+            ret = ((MetadataCacheEntry *) value)->lvs != NULL;
+    }
+    g_mutex_unlock (&metadata_cache_lock);
+
+    return ret;
+}
+
+/* @versions may be %NULL if nothing is cached for @vg_name */
+static BDLVMVGdata* metadata_cache_get_vg (const gchar *vg_name, GHashTable *versions) {
+    MetadataCacheEntry *entry = NULL;
+    BDLVMVGdata *ret = NULL;
+
+    g_mutex_lock (&metadata_cache_lock);
+    if (versions)
+        entry = metadata_cache_get_entry (vg_name, g_hash_table_lookup (versions, vg_name));
+    if (entry && entry->vg)
+        ret = bd_lvm_vgdata_copy (entry->vg);
+    metadata_cache_count (ret != NULL);
+    g_mutex_unlock (&metadata_cache_lock);
+
+    return ret;
+}
+
+static void metadata_cache_store_vg (guint64 generation, const gchar *vg_name, GHashTable *versions, BDLVMVGdata *vg) {
+    MetadataCacheEntry *entry = NULL;
+    const gchar *version = g_hash_table_lookup (versions, vg_name);
+
+    g_mutex_lock (&metadata_cache_lock);
+    if (metadata_cache && version && generation == metadata_cache_generation) {
+        entry = metadata_cache_ensure_entry (vg_name, version);
+        bd_lvm_vgdata_free (entry->vg);
+        entry->vg = bd_lvm_vgdata_copy (vg);
+    }
+    g_mutex_unlock (&metadata_cache_lock);
+}
+
+/* returns LVs of all the VGs in @versions if they are all cached, LVM sorts
+   them by the VG name so the same is done here, @versions may be %NULL if
+   nothing is cached */
+static BDLVMLVdata** metadata_cache_get_lvs (GHashTable *versions) {
+    MetadataCacheEntry *entry = NULL;
+    GPtrArray *lvs = NULL;
+    GList *vg_names = NULL;
+    GList *name_it = NULL;
+    gboolean hit = TRUE;
+
+    if (!versions) {
+        g_mutex_lock (&metadata_cache_lock);
+        metadata_cache_count (FALSE);
+        g_mutex_unlock (&metadata_cache_lock);
+        return NULL;
+    }
+
+    g_mutex_lock (&metadata_cache_lock);
+    vg_names = g_list_sort (g_hash_table_get_keys (versions), (GCompareFunc) g_strcmp0);
+    lvs = g_ptr_array_new ();
+    for (name_it = vg_names; name_it; name_it = name_it->next) {
+        entry = metadata_cache_get_entry (name_it->data, g_hash_table_lookup (versions, name_it->data));
+        if (!entry || !entry->lvs) {
+            hit = FALSE;
+            break;
+        }
+        for (BDLVMLVdata **lv_p = entry->lvs; *lv_p; lv_p++)
+            g_ptr_array_add (lvs, bd_lvm_lvdata_copy (*lv_p));
+    }
+    metadata_cache_count (hit);
+    g_mutex_unlock (&metadata_cache_lock);
+    g_list_free (vg_names);
+
+    g_ptr_array_add (lvs, NULL);
+    if (!hit) {
+        free_lvs ((BDLVMLVdata **) g_ptr_array_free (lvs, FALSE));
+        return NULL;
+    }
+
+    return (BDLVMLVdata **) g_ptr_array_free (lvs, FALSE);
+}
+
+/* @lvs must be all the LVs of all the VGs in @versions */
+static void metadata_cache_store_lvs (guint64 generation, GHashTable *versions, BDLVMLVdata **lvs) {
+    GHashTableIter iter;
+    gpointer vg_name = NULL;
+    gpointer version = NULL;
+    MetadataCacheEntry *entry = NULL;
+    GHashTable *vg_lvs = NULL;
+    GPtrArray *lv_array = NULL;
+
+    /* split the LVs by VGs */
+    vg_lvs = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+    g_hash_table_iter_init (&iter, versions);
+    while (g_hash_table_iter_next (&iter, &vg_name, &version))
+        g_hash_table_insert (vg_lvs, vg_name, g_ptr_array_new ());
+    for (BDLVMLVdata **lv_p = lvs; *lv_p; lv_p++) {
+        lv_array = g_hash_table_lookup (vg_lvs, (*lv_p)->vg_name ? (*lv_p)->vg_name : "");
+        /* VG created in the meantime, not known in this version */
+        if (lv_array)
+            g_ptr_array_add (lv_array, *lv_p);
+    }
+
+    g_mutex_lock (&metadata_cache_lock);
+    g_hash_table_iter_init (&iter, versions);
+    while (metadata_cache && generation == metadata_cache_generation &&
+           g_hash_table_iter_next (&iter, &vg_name, &version)) {
+        entry = metadata_cache_ensure_entry (vg_name, version);
+        lv_array = g_hash_table_lookup (vg_lvs, vg_name);
+        free_lvs (entry->lvs);
+        entry->lvs = g_new0 (BDLVMLVdata *, lv_array->len + 1);
+        for (guint i = 0; i < lv_array->len; i++)
+            entry->lvs[i] = bd_lvm_lvdata_copy (g_ptr_array_index (lv_array, i));
+    }
+    g_mutex_unlock (&metadata_cache_lock);
+
+    g_hash_table_destroy (vg_lvs);
+}
+
+/* PVs not in any VG have no sequence number, changes of these made outside
+   of this library cannot be detected */
+static gboolean versions_equal (GHashTable *versions1, GHashTable *versions2) {
+    GHashTableIter iter;
+    gpointer vg_name = NULL;
+    gpointer version = NULL;
+
+    if (g_hash_table_size (versions1) != g_hash_table_size (versions2))
+        return FALSE;
+
+    g_hash_table_iter_init (&iter, versions1);
+    while (g_hash_table_iter_next (&iter, &vg_name, &version))
+        if (g_strcmp0 (version, g_hash_table_lookup (versions2, vg_name)) != 0)
+            return FALSE;
+
+    return TRUE;
+}
+
+/* @versions may be %NULL if no PVs are cached */
+static BDLVMPVdata** metadata_cache_get_pvs (GHashTable *versions) {
+    BDLVMPVdata **ret = NULL;
+    guint len = 0;
+
+    g_mutex_lock (&metadata_cache_lock);
+    if (metadata_cache_pvs && (!versions || !versions_equal (versions, metadata_cache_pvs_versions)))
+        metadata_cache_clear_pvs ();
+    if (metadata_cache_pvs) {
+        for (len = 0; metadata_cache_pvs[len]; len++)
+            ;
+        ret = g_new0 (BDLVMPVdata *, len + 1);
+        for (guint i = 0; i < len; i++)
+            ret[i] = bd_lvm_pvdata_copy (metadata_cache_pvs[i]);
+    }
+    metadata_cache_count (ret != NULL);
+    g_mutex_unlock (&metadata_cache_lock);
+
+    return ret;
+}
+
+static gboolean metadata_cache_has_pvs (void) {
+    gboolean ret = FALSE;
+
+    g_mutex_lock (&metadata_cache_lock);
+    ret = metadata_cache_pvs != NULL;
+    g_mutex_unlock (&metadata_cache_lock);
+
+    return ret;
+}
+
+/* takes over @versions */
+static void metadata_cache_store_pvs (guint64 generation, GHashTable *versions, BDLVMPVdata **pvs) {
+    guint len = 0;
+
+    g_mutex_lock (&metadata_cache_lock);
+    if (!metadata_cache_enabled || generation != metadata_cache_generation) {
+        g_mutex_unlock (&metadata_cache_lock);
+        g_hash_table_destroy (versions);
+        return;
+    }
+    metadata_cache_clear_pvs ();
+    for (len = 0; pvs[len]; len++)
+        ;
+    metadata_cache_pvs = g_new0 (BDLVMPVdata *, len + 1);
+    for (guint i = 0; i < len; i++)
+        metadata_cache_pvs[i] = bd_lvm_pvdata_copy (pvs[i]);
+    metadata_cache_pvs_versions = versions;
+    g_mutex_unlock (&metadata_cache_lock);
+}
+
+/**
+ * bd_lvm_set_metadata_cache:
+ * @enabled: whether to cache information about PVs, VGs and LVs or not
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * With the metadata cache enabled, bd_lvm_pvs(), bd_lvm_vginfo(), bd_lvm_lvs()
+ * and bd_lvm_lvinfo() keep the information they got from LVM for every VG and
+ * the next calls return it as long as the metadata of the VG stays the
+ * same. This is checked by getting the sequence numbers of the VGs' metadata
+ * which is much cheaper than getting all the information again. The sequence
+ * numbers of all the VGs are checked at once and the result is reused for one
+ * second, so polling many LVs or VGs only needs one check, but changes made
+ * outside of this library may take up to a second to be noticed. Changes made
+ * by this library or of the global config (see bd_lvm_set_global_config()) or
+ * the devices filter (see bd_lvm_set_devices_filter()) drop all the cached
+ * information.
+ *
+ * The number of missing PVs of the VGs and the state of the device mapper
+ * devices of the active LVs (existence, open count, suspended and read-only
+ * flags, the loaded tables and the DM event counter) are checked too, so
+ * activating, deactivating, opening or closing an LV and PVs going missing
+ * outside of this library are detected (the active and open bits of the LVs'
+ * attr and the PVs' missing flag are up to date).
+ *
+ * Note that the values that can change without any of the above changing are
+ * the values from the time the information was cached. These are the
+ * data_percent, metadata_percent and copy_percent of the LVs and the volume
+ * health bit of the LVs' attr (the 9th character) unless a PV went missing or
+ * a DM event was reported for the LV. Changes of PVs not in any VG made
+ * outside of this library are not detected either. Use
+ * bd_lvm_metadata_cache_invalidate() to drop the cached information in such
+ * cases.
+ *
+ * Enabling the cache resets the hit and miss counters (see
+ * bd_lvm_metadata_cache_get_stats()), disabling it drops all the cached
+ * information.
+ *
+ * Returns: whether the metadata cache was successfully enabled/disabled or not
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_set_metadata_cache (gboolean enabled, GError **error G_GNUC_UNUSED) {
+    g_mutex_lock (&metadata_cache_lock);
+    if (enabled && !metadata_cache_enabled) {
+        metadata_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) metadata_cache_entry_free);
+        metadata_cache_hits = 0;
+        metadata_cache_misses = 0;
+    } else if (!enabled && metadata_cache_enabled) {
+        g_hash_table_destroy (metadata_cache);
+        metadata_cache = NULL;
+        metadata_cache_clear_pvs ();
+        metadata_cache_clear_probe ();
+    }
+    metadata_cache_enabled = enabled;
+    g_mutex_unlock (&metadata_cache_lock);
+
+    return TRUE;
+}
+
+/**
+ * bd_lvm_metadata_cache_invalidate:
+ * @vg_name: (nullable): name of the VG to drop the cached information about or
+ *                       %NULL to drop all the cached information
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Information about PVs is always dropped because it includes information
+ * about their VGs. See bd_lvm_set_metadata_cache() for more information.
+ *
+ * Returns: whether the cached information was successfully dropped or not
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+gboolean bd_lvm_metadata_cache_invalidate (const gchar *vg_name, GError **error G_GNUC_UNUSED) {
+    metadata_cache_invalidate (vg_name);
+    return TRUE;
+}
+
+/**
+ * bd_lvm_metadata_cache_get_stats:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (transfer full): numbers of the calls answered from the metadata
+ *                           cache and the calls that had to get the information
+ *                           from LVM since the cache was enabled (see
+ *                           bd_lvm_set_metadata_cache())
+ *
+ * Tech category: %BD_LVM_TECH_GLOB_CONF no mode (it is ignored)
+ */
+BDLVMMetadataCacheStats* bd_lvm_metadata_cache_get_stats (GError **error G_GNUC_UNUSED) {
+    BDLVMMetadataCacheStats *ret = g_new0 (BDLVMMetadataCacheStats, 1);
 
-    return data;
+    g_mutex_lock (&metadata_cache_lock);
+    ret->hits = metadata_cache_hits;
+    ret->misses = metadata_cache_misses;
+    g_mutex_unlock (&metadata_cache_lock);
+
+    return ret;
 }
 
 /**
@@ -718,7 +1629,7 @@ gboolean bd_lvm_pvcreate (const gchar *device, guint64 data_alignment, guint64 m
         args[next_arg++] = metadata_str;
     }
 
-    ret = call_lvm_and_report_error (args, extra, TRUE, error);
+    ret = call_lvm_and_report_error (args, extra, NULL, error);
     g_free (dataalign_str);
     g_free (metadata_str);
 
@@ -759,7 +1670,7 @@ gboolean bd_lvm_pvresize (const gchar *device, guint64 size, const BDExtraArg **
 
     args[next_pos] = device;
 
-    ret = call_lvm_and_report_error (args, extra, TRUE, error);
+    ret = call_lvm_and_report_error (args, extra, NULL, error);
     if (to_free_pos > 0)
         g_free ((gchar *) args[to_free_pos]);
 
@@ -782,7 +1693,7 @@ gboolean bd_lvm_pvremove (const gchar *device, const BDExtraArg **extra, GError
        bug, at least not in this code) */
     const gchar *args[6] = {"pvremove", "--force", "--force", "--yes", device, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, NULL, error);
 }
 
 static gboolean extract_pvmove_progress (const gchar *line, guint8 *completion) {
@@ -851,7 +1762,7 @@ gboolean bd_lvm_pvscan (const gchar *device, gboolean update_cache, const BDExtr
         if (device)
             bd_utils_log_format (BD_UTILS_LOG_WARNING, "Ignoring the device argument in pvscan (cache update not requested)");
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, NULL, error);
 }
 
 static gboolean _manage_lvm_tags (const gchar *devspec, const gchar **tags, const gchar *action, const gchar *cmd, GError **error) {
@@ -868,7 +1779,7 @@ static gboolean _manage_lvm_tags (const gchar *devspec, const gchar **tags, cons
     argv[next_arg++] = devspec;
     argv[next_arg] = NULL;
 
-    success = call_lvm_and_report_error (argv, NULL, TRUE, error);
+    success = call_lvm_and_report_error (argv, NULL, NULL, error);
     g_free (argv);
     return success;
 }
@@ -938,53 +1849,113 @@ BDLVMPVdata* bd_lvm_pvinfo (const gchar *device, GError **error) {
     return ret;
 }
 
+/* collects PVs from a streamed report */
+static void add_pv_row (const gchar *section, JsonObject *row, gpointer user_data) {
+    if (g_strcmp0 (section, "pv") == 0)
+        g_ptr_array_add ((GPtrArray *) user_data, get_pv_data_from_json (row));
+}
+
+/* collects PVs and the versions of their VGs from a streamed report */
+static void add_pv_version_row (const gchar *section, JsonObject *row, gpointer user_data) {
+    gpointer *data = (gpointer *) user_data;
+
+    if (g_strcmp0 (section, "pv") == 0) {
+        g_ptr_array_add ((GPtrArray *) data[0], get_pv_data_from_json (row));
+        versions_add_row ((GHashTable *) data[1], row);
+    }
+}
+
 /**
- * bd_lvm_pvs:
+ * pvs_query:
+ * @versions: (nullable): table to add the versions of the PVs' VGs to (without
+ *                        the DM state, see get_vg_versions())
  * @error: (out) (optional): place to store error (if any)
  *
- * Returns: (array zero-terminated=1): information about PVs found in the system
- *
- * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ * Gets information about all PVs from LVM, bypassing the metadata cache.
  */
-BDLVMPVdata** bd_lvm_pvs (GError **error) {
+static BDLVMPVdata** pvs_query (GHashTable *versions, GError **error) {
     const gchar *args[9] = {"pvs", "--units=b", "--nosuffix",
                        "--reportformat", "json_std",
                        "-o", "pv_name,pv_uuid,pv_free,pv_size,pe_start,vg_name,vg_uuid,vg_size," \
                        "vg_free,vg_extent_size,vg_extent_count,vg_free_count,pv_count,pv_tags,pv_missing",
                        NULL};
-    JsonParser *parser = NULL;
-    JsonArray *pv_array = NULL;
     GPtrArray *pvs;
-    GError *l_error = NULL;
+    gpointer data[2];
+    gboolean success = FALSE;
 
-    pvs = g_ptr_array_new ();
+    if (versions)
+        /* the versions come from the same LVM call */
+        args[6] = "pv_name,pv_uuid,pv_free,pv_size,pe_start,vg_name,vg_uuid,vg_size," \
+                  "vg_free,vg_extent_size,vg_extent_count,vg_free_count,pv_count,pv_tags,pv_missing," \
+                  "vg_seqno,vg_missing_pv_count";
 
-    pv_array = call_lvm_and_parse_json_report (args, "pv", &parser, TRUE, &l_error);
-    if (!pv_array) {
-        if (l_error) {
-            g_propagate_error (error, l_error);
-            g_ptr_array_free (pvs, TRUE);
-            return NULL;
-        }
-        /* no output => no PVs, not an error */
-        g_ptr_array_add (pvs, NULL);
-        return (BDLVMPVdata **) g_ptr_array_free (pvs, FALSE);
-    }
+    pvs = g_ptr_array_new_with_free_func ((GDestroyNotify) bd_lvm_pvdata_free);
+    data[0] = pvs;
+    data[1] = versions;
 
-    for (guint i = 0; i < json_array_get_length (pv_array); i++) {
-        JsonObject *pv_obj = json_array_get_object_element (pv_array, i);
-        BDLVMPVdata *pvdata = get_pv_data_from_json (pv_obj);
-        if (pvdata)
-            g_ptr_array_add (pvs, pvdata);
+    /* no output => no PVs, not an error */
+    if (versions)
+        success = call_lvm_and_stream_json_report (args, add_pv_version_row, data, error);
+    else
+        success = call_lvm_and_stream_json_report (args, add_pv_row, pvs, error);
+    if (!success) {
+        g_ptr_array_free (pvs, TRUE);
+        return NULL;
     }
 
-    g_object_unref (parser);
-
     /* returning NULL-terminated array of BDLVMPVdata */
+    g_ptr_array_set_free_func (pvs, NULL);
     g_ptr_array_add (pvs, NULL);
     return (BDLVMPVdata **) g_ptr_array_free (pvs, FALSE);
 }
 
+/**
+ * bd_lvm_pvs:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): information about PVs found in the system
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMPVdata** bd_lvm_pvs (GError **error) {
+    guint64 generation = 0;
+    GHashTable *versions = NULL;
+    GHashTable *dm_states = NULL;
+    BDLVMPVdata **ret = NULL;
+
+    if (!metadata_cache_active (&generation))
+        return pvs_query (NULL, error);
+
+    /* nothing cached means there's no need to check the versions, the query
+       below reports them */
+    if (metadata_cache_has_pvs ()) {
+        versions = get_vg_versions (NULL, generation, error);
+        if (!versions)
+            return NULL;
+    }
+
+    ret = metadata_cache_get_pvs (versions);
+    if (versions)
+        g_hash_table_destroy (versions);
+    if (ret)
+        return ret;
+
+    /* the DM state from before the query, a change in between only means a miss next time */
+    dm_states = get_vg_dm_states ();
+    versions = versions_new ();
+    ret = pvs_query (versions, error);
+    if (ret) {
+        versions_add_dm_states (versions, dm_states);
+        metadata_cache_store_pvs (generation, versions, ret);
+    } else {
+        if (dm_states)
+            g_hash_table_destroy (dm_states);
+        g_hash_table_destroy (versions);
+    }
+
+    return ret;
+}
+
 /**
  * bd_lvm_vgcreate:
  * @name: name of the newly created VG
@@ -1014,7 +1985,7 @@ gboolean bd_lvm_vgcreate (const gchar *name, const gchar **pv_list, guint64 pe_s
     }
     argv[i] = NULL;
 
-    success = call_lvm_and_report_error (argv, extra, TRUE, error);
+    success = call_lvm_and_report_error (argv, extra, NULL, error);
     g_free ((gchar *) argv[2]);
     g_free (argv);
 
@@ -1035,7 +2006,7 @@ gboolean bd_lvm_vgcreate (const gchar *name, const gchar **pv_list, guint64 pe_s
 gboolean bd_lvm_vgremove (const gchar *vg_name, const BDExtraArg **extra, GError **error) {
     const gchar *args[4] = {"vgremove", "--force", vg_name, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, NULL, error);
 }
 
 /**
@@ -1053,7 +2024,7 @@ gboolean bd_lvm_vgremove (const gchar *vg_name, const BDExtraArg **extra, GError
 gboolean bd_lvm_vgrename (const gchar *old_vg_name, const gchar *new_vg_name, const BDExtraArg **extra, GError **error) {
     const gchar *args[4] = {"vgrename", old_vg_name, new_vg_name, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, NULL, error);
 }
 
 /**
@@ -1070,7 +2041,7 @@ gboolean bd_lvm_vgrename (const gchar *old_vg_name, const gchar *new_vg_name, co
 gboolean bd_lvm_vgactivate (const gchar *vg_name, const BDExtraArg **extra, GError **error) {
     const gchar *args[4] = {"vgchange", "-ay", vg_name, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, NULL, error);
 }
 
 /**
@@ -1087,7 +2058,7 @@ gboolean bd_lvm_vgactivate (const gchar *vg_name, const BDExtraArg **extra, GErr
 gboolean bd_lvm_vgdeactivate (const gchar *vg_name, const BDExtraArg **extra, GError **error) {
     const gchar *args[4] = {"vgchange", "-an", vg_name, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, NULL, error);
 }
 
 /**
@@ -1105,7 +2076,7 @@ gboolean bd_lvm_vgdeactivate (const gchar *vg_name, const BDExtraArg **extra, GE
 gboolean bd_lvm_vgextend (const gchar *vg_name, const gchar *device, const BDExtraArg **extra, GError **error) {
     const gchar *args[4] = {"vgextend", vg_name, device, NULL};
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, NULL, error);
 }
 
 /**
@@ -1136,7 +2107,7 @@ gboolean bd_lvm_vgreduce (const gchar *vg_name, const gchar *device, const BDExt
         args[2] = device;
     }
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, NULL, error);
 }
 
 /**
@@ -1175,7 +2146,7 @@ static gboolean _vglock_start_stop (const gchar *vg_name, gboolean start, const
     else
         args[1] = "--lockstop";
 
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, NULL, error);
 }
 
 /**
@@ -1209,16 +2180,15 @@ gboolean bd_lvm_vglock_stop (const gchar *vg_name, const BDExtraArg **extra, GEr
 }
 
 /**
- * bd_lvm_vginfo:
+ * vginfo_query:
  * @vg_name: a VG to get information about
+ * @versions: (nullable): table to add the version of the VG to (without the DM
+ *                        state, see get_vg_versions())
  * @error: (out) (optional): place to store error (if any)
  *
- * Returns: (transfer full): information about the @vg_name VG or %NULL in case
- * of error (the @error) gets populated in those cases)
- *
- * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ * Gets information about the VG from LVM, bypassing the metadata cache.
  */
-BDLVMVGdata* bd_lvm_vginfo (const gchar *vg_name, GError **error) {
+static BDLVMVGdata* vginfo_query (const gchar *vg_name, GHashTable *versions, GError **error) {
     const gchar *args[10] = {"vgs", "--nosuffix", "--units=b",
                        "--reportformat", "json_std",
                        "-o", "name,uuid,size,free,extent_size,extent_count,free_count,pv_count,vg_exported,vg_tags",
@@ -1227,6 +2197,11 @@ BDLVMVGdata* bd_lvm_vginfo (const gchar *vg_name, GError **error) {
     JsonArray *vg_array = NULL;
     BDLVMVGdata *ret = NULL;
 
+    if (versions)
+        /* the version comes from the same LVM call */
+        args[6] = "name,uuid,size,free,extent_size,extent_count,free_count,pv_count,vg_exported,vg_tags," \
+                  "vg_seqno,vg_missing_pv_count";
+
     vg_array = call_lvm_and_parse_json_report (args, "vg", &parser, FALSE, error);
     if (!vg_array)
         return NULL;
@@ -1239,11 +2214,66 @@ BDLVMVGdata* bd_lvm_vginfo (const gchar *vg_name, GError **error) {
     }
 
     ret = get_vg_data_from_json (json_array_get_object_element (vg_array, 0));
+    if (versions)
+        versions_add_row (versions, json_array_get_object_element (vg_array, 0));
 
     g_object_unref (parser);
     return ret;
 }
 
+/**
+ * bd_lvm_vginfo:
+ * @vg_name: a VG to get information about
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (transfer full): information about the @vg_name VG or %NULL in case
+ * of error (the @error) gets populated in those cases)
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMVGdata* bd_lvm_vginfo (const gchar *vg_name, GError **error) {
+    guint64 generation = 0;
+    GHashTable *versions = NULL;
+    GHashTable *dm_states = NULL;
+    BDLVMVGdata *ret = NULL;
+
+    if (!metadata_cache_active (&generation))
+        return vginfo_query (vg_name, NULL, error);
+
+    /* nothing cached means there's no need to check the version, the query
+       below reports it */
+    if (metadata_cache_has (vg_name, FALSE)) {
+        versions = get_vg_versions (vg_name, generation, error);
+        if (!versions)
+            return NULL;
+    }
+
+    ret = metadata_cache_get_vg (vg_name, versions);
+    if (versions)
+        g_hash_table_destroy (versions);
+    if (ret)
+        return ret;
+
+    /* the DM state from before the query, a change in between only means a miss next time */
+    dm_states = get_vg_dm_states ();
+    versions = versions_new ();
+    ret = vginfo_query (vg_name, versions, error);
+    if (ret) {
+        versions_add_dm_states (versions, dm_states);
+        metadata_cache_store_vg (generation, vg_name, versions, ret);
+    } else if (dm_states)
+        g_hash_table_destroy (dm_states);
+    g_hash_table_destroy (versions);
+
+    return ret;
+}
+
+/* collects VGs from a streamed report */
+static void add_vg_row (const gchar *section, JsonObject *row, gpointer user_data) {
+    if (g_strcmp0 (section, "vg") == 0)
+        g_ptr_array_add ((GPtrArray *) user_data, get_vg_data_from_json (row));
+}
+
 /**
  * bd_lvm_vgs:
  * @error: (out) (optional): place to store error (if any)
@@ -1257,35 +2287,18 @@ BDLVMVGdata** bd_lvm_vgs (GError **error) {
                       "--reportformat", "json_std",
                       "-o", "name,uuid,size,free,extent_size,extent_count,free_count,pv_count,vg_exported,vg_tags",
                       NULL};
-    JsonParser *parser = NULL;
-    JsonArray *vg_array = NULL;
     GPtrArray *vgs;
-    GError *l_error = NULL;
-
-    vgs = g_ptr_array_new ();
 
-    vg_array = call_lvm_and_parse_json_report (args, "vg", &parser, TRUE, &l_error);
-    if (!vg_array) {
-        if (l_error) {
-            g_propagate_error (error, l_error);
-            g_ptr_array_free (vgs, TRUE);
-            return NULL;
-        }
-        /* no output => no VGs, not an error */
-        g_ptr_array_add (vgs, NULL);
-        return (BDLVMVGdata **) g_ptr_array_free (vgs, FALSE);
-    }
+    vgs = g_ptr_array_new_with_free_func ((GDestroyNotify) bd_lvm_vgdata_free);
 
-    for (guint i = 0; i < json_array_get_length (vg_array); i++) {
-        JsonObject *vg_obj = json_array_get_object_element (vg_array, i);
-        BDLVMVGdata *vgdata = get_vg_data_from_json (vg_obj);
-        if (vgdata)
-            g_ptr_array_add (vgs, vgdata);
+    /* no output => no VGs, not an error */
+    if (!call_lvm_and_stream_json_report (args, add_vg_row, vgs, error)) {
+        g_ptr_array_free (vgs, TRUE);
+        return NULL;
     }
 
-    g_object_unref (parser);
-
     /* returning NULL-terminated array of BDLVMVGdata */
+    g_ptr_array_set_free_func (vgs, NULL);
     g_ptr_array_add (vgs, NULL);
     return (BDLVMVGdata **) g_ptr_array_free (vgs, FALSE);
 }
@@ -1366,7 +2379,7 @@ gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 si
 
     args[i] = NULL;
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free (size_str);
     g_free (type_str);
     g_free (args);
@@ -1400,12 +2413,79 @@ gboolean bd_lvm_lvremove (const gchar *vg_name, const gchar *lv_name, gboolean f
 
     args[next_arg] = g_strdup_printf ("%s/%s", vg_name, lv_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[next_arg]);
 
     return success;
 }
 
+/**
+ * bd_lvm_lvcreate_many:
+ * @vg_name: name of the VG to create the new LVs in
+ * @specs: (array zero-terminated=1): specifications of the to-be-created LVs
+ * @extra: (nullable) (array zero-terminated=1): extra options for the LV creation
+ *                                                 (just passed to LVM as is, for every LV)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Creates multiple LVs in the @vg_name VG. Failure to create one of the LVs
+ * doesn't stop the creation of the others, the results are reported for every
+ * LV separately. LVM takes the VG lock for every lvcreate run so this plugin
+ * creates the LVs one by one.
+ *
+ * Returns: (array zero-terminated=1): results for all the @specs (in the same
+ *          order) or %NULL in case the batch couldn't be run at all
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_CREATE
+ */
+BDLVMLVOpResult** bd_lvm_lvcreate_many (const gchar *vg_name, BDLVMLVCreateSpec **specs, const BDExtraArg **extra, GError **error G_GNUC_UNUSED) {
+    BDLVMLVCreateSpec **spec = NULL;
+    GPtrArray *ret = g_ptr_array_new ();
+    GError *l_error = NULL;
+
+    for (spec=specs; spec && *spec; spec++) {
+        bd_lvm_lvcreate (vg_name, (*spec)->lv_name, (*spec)->size, (*spec)->type,
+                         (const gchar **) (*spec)->pv_list, extra, &l_error);
+        /* takes over the error (if any) */
+        g_ptr_array_add (ret, lv_op_result_new ((*spec)->lv_name, l_error));
+        l_error = NULL;
+    }
+    g_ptr_array_add (ret, NULL);
+
+    return (BDLVMLVOpResult **) g_ptr_array_free (ret, FALSE);
+}
+
+/**
+ * bd_lvm_lvremove_many:
+ * @vg_name: name of the VG containing the to-be-removed LVs
+ * @lv_names: (array zero-terminated=1): names of the to-be-removed LVs
+ * @force: whether to force removal or not
+ * @extra: (nullable) (array zero-terminated=1): extra options for the LV removal
+ *                                                 (just passed to LVM as is, for every LV)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Removes multiple LVs from the @vg_name VG, see @bd_lvm_lvcreate_many for
+ * details about the batch operations.
+ *
+ * Returns: (array zero-terminated=1): results for all the @lv_names (in the same
+ *          order) or %NULL in case the batch couldn't be run at all
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_REMOVE
+ */
+BDLVMLVOpResult** bd_lvm_lvremove_many (const gchar *vg_name, const gchar **lv_names, gboolean force, const BDExtraArg **extra, GError **error G_GNUC_UNUSED) {
+    const gchar **lv_name = NULL;
+    GPtrArray *ret = g_ptr_array_new ();
+    GError *l_error = NULL;
+
+    for (lv_name=lv_names; lv_name && *lv_name; lv_name++) {
+        bd_lvm_lvremove (vg_name, *lv_name, force, extra, &l_error);
+        g_ptr_array_add (ret, lv_op_result_new (*lv_name, l_error));
+        l_error = NULL;
+    }
+    g_ptr_array_add (ret, NULL);
+
+    return (BDLVMLVOpResult **) g_ptr_array_free (ret, FALSE);
+}
+
 /**
  * bd_lvm_lvrename:
  * @vg_name: name of the VG containing the to-be-renamed LV
@@ -1422,7 +2502,7 @@ gboolean bd_lvm_lvremove (const gchar *vg_name, const gchar *lv_name, gboolean f
  */
 gboolean bd_lvm_lvrename (const gchar *vg_name, const gchar *lv_name, const gchar *new_name, const BDExtraArg **extra, GError **error) {
     const gchar *args[5] = {"lvrename", vg_name, lv_name, new_name, NULL};
-    return call_lvm_and_report_error (args, extra, TRUE, error);
+    return call_lvm_and_report_error (args, extra, NULL, error);
 }
 
 
@@ -1460,7 +2540,7 @@ gboolean bd_lvm_lvresize (const gchar *vg_name, const gchar *lv_name, guint64 si
     lvspec = g_strdup_printf ("%s/%s", vg_name, lv_name);
     args[next_arg++] = lvspec;
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[3]);
 
     return success;
@@ -1494,7 +2574,7 @@ gboolean bd_lvm_lvrepair (const gchar *vg_name, const gchar *lv_name, const gcha
     }
     argv[i] = NULL;
 
-    success = call_lvm_and_report_error (argv, extra, TRUE, error);
+    success = call_lvm_and_report_error (argv, extra, NULL, error);
     g_free ((gchar *) argv[3]);
     g_free (argv);
 
@@ -1532,12 +2612,46 @@ gboolean bd_lvm_lvactivate (const gchar *vg_name, const gchar *lv_name, gboolean
     }
     args[next_arg] = g_strdup_printf ("%s/%s", vg_name, lv_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[next_arg]);
 
     return success;
 }
 
+/**
+ * bd_lvm_lvactivate_many:
+ * @vg_name: name of the VG containing the to-be-activated LVs
+ * @lv_names: (array zero-terminated=1): names of the to-be-activated LVs
+ * @ignore_skip: whether to ignore the skip flag or not
+ * @shared: whether to activate the LVs in shared mode (used for shared LVM setups with lvmlockd,
+ *          use %FALSE if not sure)
+ * @extra: (nullable) (array zero-terminated=1): extra options for the LV activation
+ *                                                 (just passed to LVM as is, for every LV)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Activates multiple LVs from the @vg_name VG, see @bd_lvm_lvcreate_many for
+ * details about the batch operations.
+ *
+ * Returns: (array zero-terminated=1): results for all the @lv_names (in the same
+ *          order) or %NULL in case the batch couldn't be run at all
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_MODIFY
+ */
+BDLVMLVOpResult** bd_lvm_lvactivate_many (const gchar *vg_name, const gchar **lv_names, gboolean ignore_skip, gboolean shared, const BDExtraArg **extra, GError **error G_GNUC_UNUSED) {
+    const gchar **lv_name = NULL;
+    GPtrArray *ret = g_ptr_array_new ();
+    GError *l_error = NULL;
+
+    for (lv_name=lv_names; lv_name && *lv_name; lv_name++) {
+        bd_lvm_lvactivate (vg_name, *lv_name, ignore_skip, shared, extra, &l_error);
+        g_ptr_array_add (ret, lv_op_result_new (*lv_name, l_error));
+        l_error = NULL;
+    }
+    g_ptr_array_add (ret, NULL);
+
+    return (BDLVMLVOpResult **) g_ptr_array_free (ret, FALSE);
+}
+
 /**
  * bd_lvm_lvdeactivate:
  * @vg_name: name of the VG containing the to-be-deactivated LV
@@ -1556,7 +2670,7 @@ gboolean bd_lvm_lvdeactivate (const gchar *vg_name, const gchar *lv_name, const
 
     args[2] = g_strdup_printf ("%s/%s", vg_name, lv_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[2]);
 
     return success;
@@ -1584,7 +2698,7 @@ gboolean bd_lvm_lvsnapshotcreate (const gchar *vg_name, const gchar *origin_name
     args[3] = g_strdup_printf ("%"G_GUINT64_FORMAT"K", size / 1024);
     args[6] = g_strdup_printf ("%s/%s", vg_name, origin_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[3]);
     g_free ((gchar *) args[6]);
 
@@ -1609,7 +2723,7 @@ gboolean bd_lvm_lvsnapshotmerge (const gchar *vg_name, const gchar *snapshot_nam
 
     args[2] = g_strdup_printf ("%s/%s", vg_name, snapshot_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[2]);
 
     return success;
@@ -1666,6 +2780,22 @@ BDLVMLVdata* bd_lvm_lvinfo (const gchar *vg_name, const gchar *lv_name, GError *
     JsonParser *parser = NULL;
     JsonArray *lv_array = NULL;
     BDLVMLVdata *ret = NULL;
+    BDLVMLVdata **lvs = NULL;
+    guint64 generation = 0;
+
+    if (metadata_cache_active (&generation)) {
+        /* all the LVs of a VG are cached together */
+        lvs = bd_lvm_lvs (vg_name, error);
+        if (!lvs)
+            return NULL;
+        for (BDLVMLVdata **lv_p = lvs; !ret && *lv_p; lv_p++)
+            if (g_strcmp0 ((*lv_p)->lv_name, lv_name) == 0)
+                ret = bd_lvm_lvdata_copy (*lv_p);
+        free_lvs (lvs);
+        if (ret)
+            return ret;
+        /* not found, let LVM report the error */
+    }
 
     args[8] = g_strdup_printf ("%s/%s", vg_name, lv_name);
 
@@ -1708,6 +2838,8 @@ BDLVMLVdata* bd_lvm_lvinfo_tree (const gchar *vg_name, const gchar *lv_name, GEr
                        NULL, NULL};
     JsonParser *parser = NULL;
     JsonArray *lv_array = NULL;
+    LVsAssembly assembly;
+    BDLVMLVdata **lvs = NULL;
     BDLVMLVdata *result = NULL;
 
     args[8] = g_strdup_printf ("%s/%s", vg_name, lv_name);
@@ -1725,88 +2857,151 @@ BDLVMLVdata* bd_lvm_lvinfo_tree (const gchar *vg_name, const gchar *lv_name, GEr
         return NULL;
     }
 
+    lvs_assembly_init (&assembly, TRUE);
     for (guint i = 0; i < json_array_get_length (lv_array); i++) {
         JsonObject *lv_obj = json_array_get_object_element (lv_array, i);
-        BDLVMLVdata *lvdata = get_lv_data_from_json (lv_obj);
-        if (result) {
-            merge_lv_data (result, lvdata);
-            bd_lvm_lvdata_free (lvdata);
-        } else
-            result = lvdata;
+        lvs_assembly_add (&assembly, get_lv_data_from_json (lv_obj));
     }
+    lvs = lvs_assembly_finish (&assembly);
 
     g_object_unref (parser);
 
+    /* all the entries are segments of the same LV */
+    result = lvs[0];
+    for (guint i = 1; lvs[i]; i++)
+        bd_lvm_lvdata_free (lvs[i]);
+    g_free (lvs);
+
     if (result == NULL)
         g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_PARSE,
                              "Failed to parse information about the LV");
     return result;
 }
 
+/* collects LVs from a streamed report */
+static void add_lv_row (const gchar *section, JsonObject *row, gpointer user_data) {
+    if (g_strcmp0 (section, "lv") == 0)
+        lvs_assembly_add ((LVsAssembly *) user_data, get_lv_data_from_json (row));
+}
+
+/* collects LVs and the versions of their VGs from a streamed report */
+static void add_lv_version_row (const gchar *section, JsonObject *row, gpointer user_data) {
+    gpointer *data = (gpointer *) user_data;
+
+    if (g_strcmp0 (section, "lv") == 0) {
+        lvs_assembly_add ((LVsAssembly *) data[0], get_lv_data_from_json (row));
+        versions_add_row ((GHashTable *) data[1], row);
+    }
+}
+
 /**
- * bd_lvm_lvs:
+ * lvs_query:
  * @vg_name: (nullable): name of the VG to get information about LVs from
+ * @versions: (nullable): table to add the versions of the LVs' VGs to (without
+ *                        the DM state, see get_vg_versions())
  * @error: (out) (optional): place to store error (if any)
  *
- * Returns: (array zero-terminated=1): information about LVs found in the given
- * @vg_name VG or in system if @vg_name is %NULL
- *
- * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ * Gets information about the LVs from LVM, bypassing the metadata cache.
  */
-BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error) {
+static BDLVMLVdata** lvs_query (const gchar *vg_name, GHashTable *versions, GError **error) {
     const gchar *args[11] = {"lvs", "--nosuffix", "--units=b",
                        "--reportformat", "json_std", "-a",
                        "-o", "vg_name,lv_name,lv_uuid,lv_size,lv_attr,segtype,origin,pool_lv,data_lv,metadata_lv,lv_role,move_pv,data_percent,metadata_percent,copy_percent,lv_tags",
                        NULL, NULL};
-    JsonParser *parser = NULL;
-    JsonArray *lv_array = NULL;
-    GPtrArray *lvs;
-    GError *l_error = NULL;
-
-    lvs = g_ptr_array_new ();
+    LVsAssembly assembly;
+    gpointer data[2];
+    gboolean success = FALSE;
 
+    if (versions)
+        /* the versions come from the same LVM call */
+        args[7] = "vg_name,lv_name,lv_uuid,lv_size,lv_attr,segtype,origin,pool_lv,data_lv,metadata_lv,lv_role,move_pv,data_percent,metadata_percent,copy_percent,lv_tags," \
+                  "vg_uuid,vg_seqno,vg_missing_pv_count";
     if (vg_name)
         args[8] = vg_name;
 
-    lv_array = call_lvm_and_parse_json_report (args, "lv", &parser, TRUE, &l_error);
-    if (!lv_array) {
-        if (l_error) {
-            g_propagate_error (error, l_error);
-            g_ptr_array_free (lvs, TRUE);
+    /* ignore duplicate entries in lvs output, these are caused by multi segments LVs */
+    lvs_assembly_init (&assembly, FALSE);
+    data[0] = &assembly;
+    data[1] = versions;
+
+    /* no output => no LVs, not an error */
+    if (versions)
+        success = call_lvm_and_stream_json_report (args, add_lv_version_row, data, error);
+    else
+        success = call_lvm_and_stream_json_report (args, add_lv_row, &assembly, error);
+    if (!success) {
+        lvs_assembly_clear (&assembly);
+        return NULL;
+    }
+
+    return lvs_assembly_finish (&assembly);
+}
+
+/**
+ * bd_lvm_lvs:
+ * @vg_name: (nullable): name of the VG to get information about LVs from
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: (array zero-terminated=1): information about LVs found in the given
+ * @vg_name VG or in system if @vg_name is %NULL
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error) {
+    guint64 generation = 0;
+    GHashTable *versions = NULL;
+    GHashTable *probed = NULL;
+    GHashTable *dm_states = NULL;
+    GHashTableIter iter;
+    gpointer key = NULL;
+    gpointer value = NULL;
+    BDLVMLVdata **ret = NULL;
+
+    if (!metadata_cache_active (&generation))
+        return lvs_query (vg_name, NULL, error);
+
+    /* nothing cached means there's no need to check the versions, the query
+       below reports them */
+    if (metadata_cache_has (vg_name, TRUE)) {
+        probed = get_vg_versions (vg_name, generation, error);
+        if (!probed)
             return NULL;
+        if (vg_name && !g_hash_table_contains (probed, vg_name)) {
+            /* the VG is gone, let LVM report the error */
+            g_hash_table_destroy (probed);
+            probed = NULL;
         }
-        /* no output => no LVs, not an error */
-        g_ptr_array_add (lvs, NULL);
-        return (BDLVMLVdata **) g_ptr_array_free (lvs, FALSE);
     }
 
-    for (guint i = 0; i < json_array_get_length (lv_array); i++) {
-        JsonObject *lv_obj = json_array_get_object_element (lv_array, i);
-        BDLVMLVdata *lvdata = get_lv_data_from_json (lv_obj);
-        if (lvdata) {
-            /* ignore duplicate entries in lvs output, these are caused by multi segments LVs */
-            gboolean duplicate = FALSE;
-            for (gsize j = 0; j < lvs->len; j++) {
-                if (g_strcmp0 (((BDLVMLVdata *) g_ptr_array_index (lvs, j))->lv_name, lvdata->lv_name) == 0) {
-                    bd_utils_log_format (BD_UTILS_LOG_DEBUG,
-                                         "Duplicate LV entry for '%s' found in lvs output",
-                                         lvdata->lv_name);
-                    bd_lvm_lvdata_free (lvdata);
-                    duplicate = TRUE;
-                    break;
-                }
-            }
+    ret = metadata_cache_get_lvs (probed);
+    if (ret) {
+        g_hash_table_destroy (probed);
+        return ret;
+    }
 
-            if (!duplicate)
-                g_ptr_array_add (lvs, lvdata);
+    /* the DM state from before the query, a change in between only means a miss next time */
+    dm_states = get_vg_dm_states ();
+    versions = versions_new ();
+    ret = lvs_query (vg_name, versions, error);
+    if (ret) {
+        versions_add_dm_states (versions, dm_states);
+        /* VGs without any LVs are not in the report, but their (empty) lists
+           of LVs can be cached too if they were probed */
+        if (probed) {
+            g_hash_table_iter_init (&iter, probed);
+            while (g_hash_table_iter_next (&iter, &key, &value))
+                if (!g_hash_table_contains (versions, key))
+                    g_hash_table_insert (versions, g_strdup (key), g_strdup (value));
         }
-    }
+        metadata_cache_store_lvs (generation, versions, ret);
+    } else if (dm_states)
+        g_hash_table_destroy (dm_states);
 
-    g_object_unref (parser);
+    g_hash_table_destroy (versions);
+    if (probed)
+        g_hash_table_destroy (probed);
 
-    /* returning NULL-terminated array of BDLVMLVdata */
-    g_ptr_array_add (lvs, NULL);
-    return (BDLVMLVdata **) g_ptr_array_free (lvs, FALSE);
+    return ret;
 }
 
 /**
@@ -1826,53 +3021,174 @@ BDLVMLVdata** bd_lvm_lvs_tree (const gchar *vg_name, GError **error) {
                        "--reportformat", "json_std", "-a",
                        "-o", "vg_name,lv_name,lv_uuid,lv_size,lv_attr,segtype,origin,pool_lv,data_lv,metadata_lv,lv_role,move_pv,data_percent,metadata_percent,copy_percent,lv_tags,devices,metadata_devices,seg_size_pe",
                        NULL, NULL};
-    JsonParser *parser = NULL;
-    JsonArray *lv_array = NULL;
-    GPtrArray *lvs;
-    GError *l_error = NULL;
-
-    lvs = g_ptr_array_new ();
+    LVsAssembly assembly;
 
     if (vg_name)
         args[8] = vg_name;
 
-    lv_array = call_lvm_and_parse_json_report (args, "lv", &parser, TRUE, &l_error);
-    if (!lv_array) {
-        if (l_error) {
-            g_propagate_error (error, l_error);
-            g_ptr_array_free (lvs, TRUE);
-            return NULL;
-        }
-        /* no output => no LVs, not an error */
-        g_ptr_array_add (lvs, NULL);
-        return (BDLVMLVdata **) g_ptr_array_free (lvs, FALSE);
+    lvs_assembly_init (&assembly, TRUE);
+
+    /* no output => no LVs, not an error */
+    if (!call_lvm_and_stream_json_report (args, add_lv_row, &assembly, error)) {
+        lvs_assembly_clear (&assembly);
+        return NULL;
     }
 
-    for (guint i = 0; i < json_array_get_length (lv_array); i++) {
-        JsonObject *lv_obj = json_array_get_object_element (lv_array, i);
-        BDLVMLVdata *lvdata = get_lv_data_from_json (lv_obj);
-        if (lvdata) {
-            gboolean merged = FALSE;
-            for (gsize j = 0; j < lvs->len; j++) {
-                BDLVMLVdata *other = (BDLVMLVdata *) g_ptr_array_index (lvs, j);
-                if (g_strcmp0 (other->lv_name, lvdata->lv_name) == 0) {
-                    merge_lv_data (other, lvdata);
-                    bd_lvm_lvdata_free (lvdata);
-                    merged = TRUE;
-                    break;
-                }
-            }
+    return lvs_assembly_finish (&assembly);
+}
 
-            if (!merged)
-                g_ptr_array_add (lvs, lvdata);
-        }
+/* lvs columns needed for the individual BDLVMLVdata fields */
+static const struct {
+    BDLVMLVdataField field;
+    const gchar *columns;
+} lv_field_columns[] = {
+    {BD_LVM_LV_FIELD_UUID, "lv_uuid"},
+    {BD_LVM_LV_FIELD_SIZE, "lv_size"},
+    {BD_LVM_LV_FIELD_ATTR, "lv_attr"},
+    {BD_LVM_LV_FIELD_SEGTYPE, "segtype"},
+    {BD_LVM_LV_FIELD_ORIGIN, "origin"},
+    {BD_LVM_LV_FIELD_POOL_LV, "pool_lv"},
+    {BD_LVM_LV_FIELD_DATA_LV, "data_lv"},
+    {BD_LVM_LV_FIELD_METADATA_LV, "metadata_lv"},
+    {BD_LVM_LV_FIELD_ROLES, "lv_role"},
+    {BD_LVM_LV_FIELD_MOVE_PV, "move_pv"},
+    {BD_LVM_LV_FIELD_DATA_PERCENT, "data_percent"},
+    {BD_LVM_LV_FIELD_METADATA_PERCENT, "metadata_percent"},
+    {BD_LVM_LV_FIELD_COPY_PERCENT, "copy_percent"},
+    {BD_LVM_LV_FIELD_TAGS, "lv_tags"},
+};
+
+/**
+ * bd_lvm_lvs_select:
+ * @vg_name: (nullable): name of the VG to get information about LVs from
+ * @select_expr: (nullable): LVM selection criteria (see lvmreport(7)) the LVs
+ *                           have to match or %NULL to get all LVs
+ * @fields: fields of the #BDLVMLVdata to fill (the @lv_name and @vg_name
+ *          fields are always filled)
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * A cheaper version of bd_lvm_lvs() for callers that only need some of the
+ * information about LVs. The filtering is done by LVM and only the columns
+ * needed for @fields are reported, the other fields are left empty.
+ *
+ * Note: The metadata cache (see bd_lvm_set_metadata_cache()) is not used by
+ *       this function.
+ *
+ * Returns: (array zero-terminated=1): information about LVs matching
+ * @select_expr found in the given @vg_name VG or in system if @vg_name is %NULL
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMLVdata** bd_lvm_lvs_select (const gchar *vg_name, const gchar *select_expr, BDLVMLVdataField fields, GError **error) {
+    const gchar *args[12] = {"lvs", "--nosuffix", "--units=b",
+                       "--reportformat", "json_std", "-a",
+                       "-o", NULL, NULL, NULL, NULL, NULL};
+    GString *columns = g_string_new ("vg_name,lv_name");
+    guint next_arg = 8;
+    LVsAssembly assembly;
+    gboolean success = FALSE;
+
+    for (guint i = 0; i < G_N_ELEMENTS (lv_field_columns); i++)
+        if (fields & lv_field_columns[i].field)
+            g_string_append_printf (columns, ",%s", lv_field_columns[i].columns);
+    args[7] = columns->str;
+
+    if (select_expr) {
+        args[next_arg++] = "-S";
+        args[next_arg++] = select_expr;
     }
+    if (vg_name)
+        args[next_arg++] = vg_name;
 
-    g_object_unref (parser);
+    /* segtype makes LVM report every segment, drop the duplicates */
+    lvs_assembly_init (&assembly, FALSE);
 
-    /* returning NULL-terminated array of BDLVMLVdata */
-    g_ptr_array_add (lvs, NULL);
-    return (BDLVMLVdata **) g_ptr_array_free (lvs, FALSE);
+    /* no output => no (matching) LVs, not an error */
+    success = call_lvm_and_stream_json_report (args, add_lv_row, &assembly, error);
+    g_string_free (columns, TRUE);
+    if (!success) {
+        lvs_assembly_clear (&assembly);
+        return NULL;
+    }
+
+    return lvs_assembly_finish (&assembly);
+}
+
+/* what is being collected from a streamed full report */
+typedef struct FullReportAssembly {
+    GPtrArray *pvs;
+    GPtrArray *vgs;
+    LVsAssembly lvs;
+} FullReportAssembly;
+
+/* collects PVs, VGs and LVs from a streamed full report, there is one report
+   per VG (plus one for the orphan PVs) and the LV data come from the segments
+   section */
+static void add_full_report_row (const gchar *section, JsonObject *row, gpointer user_data) {
+    FullReportAssembly *assembly = (FullReportAssembly *) user_data;
+
+    if (g_strcmp0 (section, "pv") == 0)
+        g_ptr_array_add (assembly->pvs, get_pv_data_from_json (row));
+    else if (g_strcmp0 (section, "vg") == 0)
+        g_ptr_array_add (assembly->vgs, get_vg_data_from_json (row));
+    else if (g_strcmp0 (section, "seg") == 0)
+        lvs_assembly_add (&(assembly->lvs), get_lv_data_from_json (row));
+}
+
+/**
+ * bd_lvm_fullreport:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Gets information about all PVs, VGs and LVs (including their segments) in
+ * the system at once. This is much cheaper than calling bd_lvm_pvs(),
+ * bd_lvm_vgs() and bd_lvm_lvs_tree() because LVM only scans the devices and
+ * reads the metadata once.
+ *
+ * Returns: (transfer full): information about all PVs, VGs and LVs in the
+ * system or %NULL in case of error (the @error) gets populated in those cases)
+ *
+ * Tech category: %BD_LVM_TECH_BASIC-%BD_LVM_TECH_MODE_QUERY
+ */
+BDLVMFullReport* bd_lvm_fullreport (GError **error) {
+    /* every section of the full report has to be configured separately, the
+       LV data (including the tree fields) are taken from the segments section
+       where multi-segment LVs are reported once for every segment */
+    const gchar *args[22] = {"fullreport", "--nosuffix", "--units=b",
+                       "--reportformat", "json_std", "-a",
+                       "--configreport", "pv", "-o", "pv_name,pv_uuid,pv_free,pv_size,pe_start,vg_name,vg_uuid,vg_size," \
+                       "vg_free,vg_extent_size,vg_extent_count,vg_free_count,pv_count,pv_tags,pv_missing",
+                       "--configreport", "vg", "-o", "name,uuid,size,free,extent_size,extent_count,free_count,pv_count,vg_exported,vg_tags",
+                       "--configreport", "lv", "-o", "lv_uuid",
+                       "--configreport", "pvseg", "-o", "pvseg_start",
+                       "--configreport", "seg", "-o", "vg_name,lv_name,lv_uuid,lv_size,lv_attr,segtype,origin,pool_lv,data_lv,metadata_lv,lv_role,move_pv,data_percent,metadata_percent,copy_percent,lv_tags,devices,metadata_devices,seg_size_pe",
+                       NULL};
+    FullReportAssembly assembly;
+    BDLVMFullReport *ret = NULL;
+
+    assembly.pvs = g_ptr_array_new_with_free_func ((GDestroyNotify) bd_lvm_pvdata_free);
+    assembly.vgs = g_ptr_array_new_with_free_func ((GDestroyNotify) bd_lvm_vgdata_free);
+    lvs_assembly_init (&(assembly.lvs), TRUE);
+
+    /* no output => no PVs, VGs nor LVs, not an error */
+    if (!call_lvm_and_stream_json_report (args, add_full_report_row, &assembly, error)) {
+        g_ptr_array_free (assembly.pvs, TRUE);
+        g_ptr_array_free (assembly.vgs, TRUE);
+        lvs_assembly_clear (&(assembly.lvs));
+        return NULL;
+    }
+
+    ret = g_new0 (BDLVMFullReport, 1);
+
+    /* NULL-terminated arrays */
+    g_ptr_array_set_free_func (assembly.pvs, NULL);
+    g_ptr_array_add (assembly.pvs, NULL);
+    ret->pvs = (BDLVMPVdata **) g_ptr_array_free (assembly.pvs, FALSE);
+    g_ptr_array_set_free_func (assembly.vgs, NULL);
+    g_ptr_array_add (assembly.vgs, NULL);
+    ret->vgs = (BDLVMVGdata **) g_ptr_array_free (assembly.vgs, FALSE);
+    ret->lvs = lvs_assembly_finish (&(assembly.lvs));
+
+    return ret;
 }
 
 /**
@@ -1916,7 +3232,7 @@ gboolean bd_lvm_thpoolcreate (const gchar *vg_name, const gchar *lv_name, guint6
 
     args[next_arg] = g_strdup_printf ("%s/%s", vg_name, lv_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[3]);
     g_free ((gchar *) args[4]);
     g_free ((gchar *) args[5]);
@@ -1947,7 +3263,7 @@ gboolean bd_lvm_thlvcreate (const gchar *vg_name, const gchar *pool_name, const
     args[2] = g_strdup_printf ("%s/%s", vg_name, pool_name);
     args[4] = g_strdup_printf ("%"G_GUINT64_FORMAT"K", size / 1024);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[2]);
     g_free ((gchar *) args[4]);
 
@@ -2010,7 +3326,7 @@ gboolean bd_lvm_thsnapshotcreate (const gchar *vg_name, const gchar *origin_name
 
     args[next_arg] = g_strdup_printf ("%s/%s", vg_name, origin_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[next_arg]);
 
     return success;
@@ -2131,7 +3447,7 @@ gboolean bd_lvm_cache_create_pool (const gchar *vg_name, const gchar *pool_name,
     }
     name = g_strdup_printf ("%s/%s", vg_name, pool_name);
     args[8] = name;
-    success = call_lvm_and_report_error (args, NULL, TRUE, &l_error);
+    success = call_lvm_and_report_error (args, NULL, NULL, &l_error);
     g_free ((gchar *) args[5]);
     g_free ((gchar *) args[8]);
 
@@ -2169,7 +3485,7 @@ gboolean bd_lvm_cache_attach (const gchar *vg_name, const gchar *data_lv, const
 
     args[5] = g_strdup_printf ("%s/%s", vg_name, cache_pool_lv);
     args[6] = g_strdup_printf ("%s/%s", vg_name, data_lv);
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
 
     g_free ((gchar *) args[5]);
     g_free ((gchar *) args[6]);
@@ -2199,7 +3515,7 @@ gboolean bd_lvm_cache_detach (const gchar *vg_name, const gchar *cached_lv, gboo
 
     args[3] = destroy ? "--uncache" : "--splitcache";
     args[4] = g_strdup_printf ("%s/%s", vg_name, cached_lv);
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
 
     g_free ((gchar *) args[4]);
     return success;
@@ -2301,7 +3617,7 @@ gboolean bd_lvm_writecache_attach (const gchar *vg_name, const gchar *data_lv, c
 
     args[5] = g_strdup_printf ("%s/%s", vg_name, cache_lv);
     args[6] = g_strdup_printf ("%s/%s", vg_name, data_lv);
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
 
     g_free ((gchar *) args[5]);
     g_free ((gchar *) args[6]);
@@ -2460,7 +3776,7 @@ gboolean bd_lvm_thpool_convert (const gchar *vg_name, const gchar *data_lv, cons
 
     args[6] = g_strdup_printf ("%s/%s", vg_name, data_lv);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[6]);
 
     if (success && name)
@@ -2493,7 +3809,7 @@ gboolean bd_lvm_cache_pool_convert (const gchar *vg_name, const gchar *data_lv,
 
     args[6] = g_strdup_printf ("%s/%s", vg_name, data_lv);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[6]);
 
     if (success && name)
@@ -2527,7 +3843,7 @@ gboolean bd_lvm_vdo_pool_create (const gchar *vg_name, const gchar *lv_name, con
                              "--deduplication", deduplication ? "y" : "n",
                              "-y", NULL, NULL};
     gboolean success = FALSE;
-    gchar *old_config = NULL;
+    g_autofree gchar *vdo_config = NULL;
     const gchar *write_policy_str = NULL;
 
     write_policy_str = bd_lvm_get_vdo_write_policy_str (write_policy, error);
@@ -2543,21 +3859,13 @@ gboolean bd_lvm_vdo_pool_create (const gchar *vg_name, const gchar *lv_name, con
         args[14] = vg_name;
 
     /* index_memory and write_policy can be specified only using the config */
-    g_mutex_lock (&global_config_lock);
-    old_config = global_config_str;
     if (index_memory != 0)
-        global_config_str = g_strdup_printf ("%s allocation {vdo_index_memory_size_mb=%"G_GUINT64_FORMAT" vdo_write_policy=\"%s\"}", old_config ? old_config : "",
-                                                                                                                                     index_memory / (1024 * 1024),
-                                                                                                                                     write_policy_str);
+        vdo_config = g_strdup_printf ("allocation {vdo_index_memory_size_mb=%"G_GUINT64_FORMAT" vdo_write_policy=\"%s\"}",
+                                      index_memory / (1024 * 1024), write_policy_str);
     else
-        global_config_str = g_strdup_printf ("%s allocation {vdo_write_policy=\"%s\"}", old_config ? old_config : "",
-                                                                                        write_policy_str);
-
-    success = call_lvm_and_report_error (args, extra, FALSE, error);
+        vdo_config = g_strdup_printf ("allocation {vdo_write_policy=\"%s\"}", write_policy_str);
 
-    g_free (global_config_str);
-    global_config_str = old_config;
-    g_mutex_unlock (&global_config_lock);
+    success = call_lvm_and_report_error (args, extra, vdo_config, error);
 
     g_free ((gchar *) args[6]);
     g_free ((gchar *) args[8]);
@@ -2574,7 +3882,7 @@ static gboolean _vdo_set_compression_deduplication (const gchar *vg_name, const
 
     args[3] = g_strdup_printf ("%s/%s", vg_name, pool_name);
 
-    success = call_lvm_and_report_error (args, extra, TRUE, error);
+    success = call_lvm_and_report_error (args, extra, NULL, error);
     g_free ((gchar *) args[3]);
 
     return success;
@@ -2771,7 +4079,7 @@ gboolean bd_lvm_vdo_pool_convert (const gchar *vg_name, const gchar *pool_lv, co
     guint next_arg = 8;
     gchar *size_str = NULL;
     gchar *lv_spec = NULL;
-    gchar *old_config = NULL;
+    g_autofree gchar *vdo_config = NULL;
     const gchar *write_policy_str = NULL;
 
     write_policy_str = bd_lvm_get_vdo_write_policy_str (write_policy, error);
@@ -2790,21 +4098,13 @@ gboolean bd_lvm_vdo_pool_convert (const gchar *vg_name, const gchar *pool_lv, co
     args[next_arg++] = lv_spec;
 
     /* index_memory and write_policy can be specified only using the config */
-    g_mutex_lock (&global_config_lock);
-    old_config = global_config_str;
     if (index_memory != 0)
-        global_config_str = g_strdup_printf ("%s allocation {vdo_index_memory_size_mb=%"G_GUINT64_FORMAT" vdo_write_policy=\"%s\"}", old_config ? old_config : "",
-                                                                                                                                     index_memory / (1024 * 1024),
-                                                                                                                                     write_policy_str);
+        vdo_config = g_strdup_printf ("allocation {vdo_index_memory_size_mb=%"G_GUINT64_FORMAT" vdo_write_policy=\"%s\"}",
+                                      index_memory / (1024 * 1024), write_policy_str);
     else
-        global_config_str = g_strdup_printf ("%s allocation {vdo_write_policy=\"%s\"}", old_config ? old_config : "",
-                                                                                        write_policy_str);
+        vdo_config = g_strdup_printf ("allocation {vdo_write_policy=\"%s\"}", write_policy_str);
 
-    success = call_lvm_and_report_error (args, extra, FALSE, error);
-
-    g_free (global_config_str);
-    global_config_str = old_config;
-    g_mutex_unlock (&global_config_lock);
+    success = call_lvm_and_report_error (args, extra, vdo_config, error);
 
     g_free (size_str);
     g_free (lv_spec);
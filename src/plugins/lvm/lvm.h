@@ -70,6 +70,25 @@ typedef enum {
     BD_LVM_VDO_WRITE_POLICY_ASYNC,
 } BDLVMVDOWritePolicy;
 
+typedef enum {
+    BD_LVM_LV_FIELD_UUID =             1 << 0,
+    BD_LVM_LV_FIELD_SIZE =             1 << 1,
+    BD_LVM_LV_FIELD_ATTR =             1 << 2,
+    BD_LVM_LV_FIELD_SEGTYPE =          1 << 3,
+    BD_LVM_LV_FIELD_ORIGIN =           1 << 4,
+    BD_LVM_LV_FIELD_POOL_LV =          1 << 5,
+    BD_LVM_LV_FIELD_DATA_LV =          1 << 6,
+    BD_LVM_LV_FIELD_METADATA_LV =      1 << 7,
+    BD_LVM_LV_FIELD_ROLES =            1 << 8,
+    BD_LVM_LV_FIELD_MOVE_PV =          1 << 9,
+    BD_LVM_LV_FIELD_DATA_PERCENT =     1 << 10,
+    BD_LVM_LV_FIELD_METADATA_PERCENT = 1 << 11,
+    BD_LVM_LV_FIELD_COPY_PERCENT =     1 << 12,
+    BD_LVM_LV_FIELD_TAGS =             1 << 13,
+
+    BD_LVM_LV_FIELD_ALL =              (1 << 14) - 1,
+} BDLVMLVdataField;
+
 typedef struct BDLVMPVdata {
     gchar *pv_name;
     gchar *pv_uuid;
@@ -171,6 +190,38 @@ typedef struct BDLVMVDOStats {
 void bd_lvm_vdo_stats_free (BDLVMVDOStats *stats);
 BDLVMVDOStats* bd_lvm_vdo_stats_copy (BDLVMVDOStats *stats);
 
+typedef struct BDLVMVDOSample {
+    gchar *vg_name;
+    gchar *pool_name;
+    gint64 timestamp;
+    guint64 bios_in_read;
+    guint64 bios_in_write;
+    guint64 bios_out_read;
+    guint64 bios_out_write;
+    guint64 bios_meta_write;
+    guint64 dedupe_posts_found;
+    guint64 dedupe_posts_not_found;
+    guint64 journal_disk_full;
+    guint64 slab_journal_blocked;
+} BDLVMVDOSample;
+
+void bd_lvm_vdo_sample_free (BDLVMVDOSample *sample);
+BDLVMVDOSample* bd_lvm_vdo_sample_copy (BDLVMVDOSample *sample);
+
+typedef struct BDLVMVDORates {
+    gchar *vg_name;
+    gchar *pool_name;
+    gdouble interval;
+    gdouble write_amplification;
+    gdouble dedupe_hit_rate;
+    gdouble bios_in_per_sec;
+    gdouble bios_out_per_sec;
+    gdouble journal_blocked_per_sec;
+} BDLVMVDORates;
+
+void bd_lvm_vdo_rates_free (BDLVMVDORates *rates);
+BDLVMVDORates* bd_lvm_vdo_rates_copy (BDLVMVDORates *rates);
+
 typedef struct BDLVMCacheStats {
     guint64 block_size;
     guint64 cache_size;
@@ -183,11 +234,80 @@ typedef struct BDLVMCacheStats {
     guint64 write_hits;
     guint64 write_misses;
     BDLVMCacheMode mode;
+    guint64 promotions;
+    guint64 demotions;
+    guint64 dirty;
 } BDLVMCacheStats;
 
 void bd_lvm_cache_stats_free (BDLVMCacheStats *data);
 BDLVMCacheStats* bd_lvm_cache_stats_copy (BDLVMCacheStats *data);
 
+typedef struct BDLVMCachedLVStats {
+    gchar *vg_name;
+    gchar *lv_name;
+    BDLVMCacheStats *stats;
+} BDLVMCachedLVStats;
+
+void bd_lvm_cached_lv_stats_free (BDLVMCachedLVStats *data);
+BDLVMCachedLVStats* bd_lvm_cached_lv_stats_copy (BDLVMCachedLVStats *data);
+
+typedef struct BDLVMThPoolStats {
+    gchar *vg_name;
+    gchar *pool_name;
+    guint64 data_used;
+    guint64 data_size;
+    guint64 metadata_used;
+    guint64 metadata_size;
+    gdouble data_percent;
+    gdouble metadata_percent;
+    gboolean read_only;
+    gboolean out_of_data_space;
+    gboolean needs_check;
+    gboolean failed;
+} BDLVMThPoolStats;
+
+void bd_lvm_thpool_stats_free (BDLVMThPoolStats *stats);
+BDLVMThPoolStats* bd_lvm_thpool_stats_copy (BDLVMThPoolStats *stats);
+
+typedef gboolean (*BDLVMThPoolMonitorFunc) (BDLVMThPoolStats *stats, gpointer user_data);
+
+typedef struct BDLVMLVCreateSpec {
+    gchar *lv_name;
+    guint64 size;
+    gchar *type;
+    gchar **pv_list;
+} BDLVMLVCreateSpec;
+
+void bd_lvm_lv_create_spec_free (BDLVMLVCreateSpec *spec);
+BDLVMLVCreateSpec* bd_lvm_lv_create_spec_copy (BDLVMLVCreateSpec *spec);
+BDLVMLVCreateSpec* bd_lvm_lv_create_spec_new (const gchar *lv_name, guint64 size, const gchar *type, const gchar **pv_list);
+
+typedef struct BDLVMLVOpResult {
+    gchar *lv_name;
+    gboolean success;
+    gchar *error_message;
+} BDLVMLVOpResult;
+
+void bd_lvm_lv_op_result_free (BDLVMLVOpResult *result);
+BDLVMLVOpResult* bd_lvm_lv_op_result_copy (BDLVMLVOpResult *result);
+
+typedef struct BDLVMFullReport {
+    BDLVMPVdata **pvs;
+    BDLVMVGdata **vgs;
+    BDLVMLVdata **lvs;
+} BDLVMFullReport;
+
+void bd_lvm_full_report_free (BDLVMFullReport *data);
+BDLVMFullReport* bd_lvm_full_report_copy (BDLVMFullReport *data);
+
+typedef struct BDLVMMetadataCacheStats {
+    guint64 hits;
+    guint64 misses;
+} BDLVMMetadataCacheStats;
+
+void bd_lvm_metadata_cache_stats_free (BDLVMMetadataCacheStats *data);
+BDLVMMetadataCacheStats* bd_lvm_metadata_cache_stats_copy (BDLVMMetadataCacheStats *data);
+
 typedef enum {
     BD_LVM_TECH_BASIC = 0,
     BD_LVM_TECH_BASIC_SNAP,
@@ -223,6 +343,7 @@ typedef enum {
  */
 gboolean bd_lvm_init (void);
 void bd_lvm_close (void);
+void bd_lvm_probe_deps (void);
 
 gboolean bd_lvm_is_tech_avail (BDLVMTech tech, guint64 mode, GError **error);
 
@@ -265,10 +386,13 @@ BDLVMVGdata** bd_lvm_vgs (GError **error);
 gchar* bd_lvm_lvorigin (const gchar *vg_name, const gchar *lv_name, GError **error);
 gboolean bd_lvm_lvcreate (const gchar *vg_name, const gchar *lv_name, guint64 size, const gchar *type, const gchar **pv_list, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_lvremove (const gchar *vg_name, const gchar *lv_name, gboolean force, const BDExtraArg **extra, GError **error);
+BDLVMLVOpResult** bd_lvm_lvcreate_many (const gchar *vg_name, BDLVMLVCreateSpec **specs, const BDExtraArg **extra, GError **error);
+BDLVMLVOpResult** bd_lvm_lvremove_many (const gchar *vg_name, const gchar **lv_names, gboolean force, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_lvrename (const gchar *vg_name, const gchar *lv_name, const gchar *new_name, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_lvresize (const gchar *vg_name, const gchar *lv_name, guint64 size, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_lvrepair (const gchar *vg_name, const gchar *lv_name, const gchar **pv_list, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_lvactivate (const gchar *vg_name, const gchar *lv_name, gboolean ignore_skip, gboolean shared, const BDExtraArg **extra, GError **error);
+BDLVMLVOpResult** bd_lvm_lvactivate_many (const gchar *vg_name, const gchar **lv_names, gboolean ignore_skip, gboolean shared, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_lvdeactivate (const gchar *vg_name, const gchar *lv_name, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_lvsnapshotcreate (const gchar *vg_name, const gchar *origin_name, const gchar *snapshot_name, guint64 size, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_lvsnapshotmerge (const gchar *vg_name, const gchar *snapshot_name, const BDExtraArg **extra, GError **error);
@@ -278,10 +402,14 @@ BDLVMLVdata* bd_lvm_lvinfo (const gchar *vg_name, const gchar *lv_name, GError *
 BDLVMLVdata* bd_lvm_lvinfo_tree (const gchar *vg_name, const gchar *lv_name, GError **error);
 BDLVMLVdata** bd_lvm_lvs (const gchar *vg_name, GError **error);
 BDLVMLVdata** bd_lvm_lvs_tree (const gchar *vg_name, GError **error);
+BDLVMLVdata** bd_lvm_lvs_select (const gchar *vg_name, const gchar *select_expr, BDLVMLVdataField fields, GError **error);
+BDLVMFullReport* bd_lvm_fullreport (GError **error);
 
 gboolean bd_lvm_thpoolcreate (const gchar *vg_name, const gchar *lv_name, guint64 size, guint64 md_size, guint64 chunk_size, const gchar *profile, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_thlvcreate (const gchar *vg_name, const gchar *pool_name, const gchar *lv_name, guint64 size, const BDExtraArg **extra, GError **error);
 gchar* bd_lvm_thlvpoolname (const gchar *vg_name, const gchar *lv_name, GError **error);
+BDLVMThPoolStats** bd_lvm_thpool_stats_all (GError **error);
+gboolean bd_lvm_thpool_monitor (gdouble data_threshold, gdouble metadata_threshold, guint interval, guint count, GCancellable *cancellable, BDLVMThPoolMonitorFunc callback, gpointer user_data, GError **error);
 gboolean bd_lvm_thsnapshotcreate (const gchar *vg_name, const gchar *origin_name, const gchar *snapshot_name, const gchar *pool_name, const BDExtraArg **extra, GError **error);
 
 gboolean bd_lvm_set_global_config (const gchar *new_config, GError **error);
@@ -290,6 +418,12 @@ gchar* bd_lvm_get_global_config (GError **error);
 gboolean bd_lvm_set_devices_filter (const gchar **devices, GError **error);
 gchar** bd_lvm_get_devices_filter (GError **error);
 
+gboolean bd_lvm_set_shell_mode (gboolean enabled, guint idle_timeout, GError **error);
+
+gboolean bd_lvm_set_metadata_cache (gboolean enabled, GError **error);
+gboolean bd_lvm_metadata_cache_invalidate (const gchar *vg_name, GError **error);
+BDLVMMetadataCacheStats* bd_lvm_metadata_cache_get_stats (GError **error);
+
 guint64 bd_lvm_cache_get_default_md_size (guint64 cache_size, GError **error);
 const gchar* bd_lvm_cache_get_mode_str (BDLVMCacheMode mode, GError **error);
 BDLVMCacheMode bd_lvm_cache_get_mode_from_str (const gchar *mode_str, GError **error);
@@ -300,6 +434,7 @@ gboolean bd_lvm_cache_create_cached_lv (const gchar *vg_name, const gchar *lv_na
                                         const gchar **slow_pvs, const gchar **fast_pvs, GError **error);
 gchar* bd_lvm_cache_pool_name (const gchar *vg_name, const gchar *cached_lv, GError **error);
 BDLVMCacheStats* bd_lvm_cache_stats (const gchar *vg_name, const gchar *cached_lv, GError **error);
+BDLVMCachedLVStats** bd_lvm_cache_stats_all (GError **error);
 
 gboolean bd_lvm_writecache_attach (const gchar *vg_name, const gchar *data_lv, const gchar *cache_lv, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_writecache_detach (const gchar *vg_name, const gchar *cached_lv, gboolean destroy, const BDExtraArg **extra, GError **error);
@@ -330,6 +465,8 @@ BDLVMVDOWritePolicy bd_lvm_get_vdo_write_policy_from_str (const gchar *policy_st
 
 BDLVMVDOStats* bd_lvm_vdo_get_stats (const gchar *vg_name, const gchar *pool_name, GError **error);
 GHashTable* bd_lvm_vdo_get_stats_full (const gchar *vg_name, const gchar *pool_name, GError **error);
+BDLVMVDOSample** bd_lvm_vdo_sample_all (GError **error);
+BDLVMVDORates* bd_lvm_vdo_sample_rates (const BDLVMVDOSample *prev, const BDLVMVDOSample *cur, GError **error);
 
 gboolean bd_lvm_devices_add (const gchar *device, const gchar *devices_file, const BDExtraArg **extra, GError **error);
 gboolean bd_lvm_devices_delete (const gchar *device, const gchar *devices_file, const BDExtraArg **extra, GError **error);
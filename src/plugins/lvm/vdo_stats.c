@@ -139,13 +139,15 @@ enum parse_flags {
   PARSE_NEXT_IGN,
 };
 
-G_GNUC_INTERNAL GHashTable *
-vdo_get_stats_full (const gchar *name, GError **error) {
+/* called for every key-value pair of the stats, takes ownership of @key */
+typedef void (*VDOStatFunc) (gchar *key, const gchar *value, gpointer user_data);
+
+static gboolean
+vdo_scan_stats (const gchar *name, VDOStatFunc stat_func, gpointer user_data, GError **error) {
     struct dm_task *dmt = NULL;
     const gchar *response = NULL;
     yaml_parser_t parser;
     yaml_token_t token;
-    GHashTable *stats = NULL;
     gchar *key = NULL;
     gsize len = 0;
     int next_token = PARSE_NEXT_IGN;
@@ -155,28 +157,28 @@ vdo_get_stats_full (const gchar *name, GError **error) {
     if (!dmt) {
         g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
                              "Failed to create DM task");
-        return NULL;
+        return FALSE;
     }
 
     if (!dm_task_set_name (dmt, name)) {
         g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
                              "Failed to set name for DM task");
         dm_task_destroy (dmt);
-        return NULL;
+        return FALSE;
     }
 
     if (!dm_task_set_message (dmt, "stats")) {
         g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
                              "Failed to set message for DM task");
         dm_task_destroy (dmt);
-        return NULL;
+        return FALSE;
     }
 
     if (!dm_task_run (dmt)) {
         g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
                              "Failed to run DM task");
         dm_task_destroy (dmt);
-        return NULL;
+        return FALSE;
     }
 
     response = dm_task_get_message_response (dmt);
@@ -184,17 +186,16 @@ vdo_get_stats_full (const gchar *name, GError **error) {
         g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
                              "Failed to get response from the DM task");
         dm_task_destroy (dmt);
-        return NULL;
+        return FALSE;
     }
 
     if (!yaml_parser_initialize (&parser)) {
         g_set_error_literal (error, BD_LVM_ERROR, BD_LVM_ERROR_DM_ERROR,
                              "Failed to get initialize YAML parser");
         dm_task_destroy (dmt);
-        return NULL;
+        return FALSE;
     }
 
-    stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
     yaml_parser_set_input_string (&parser, (guchar *) response, strlen (response));
 
     do {
@@ -240,10 +241,8 @@ vdo_get_stats_full (const gchar *name, GError **error) {
                         key[len] = g_ascii_toupper (key[len]);
                     } else
                         key = g_strdup ((const gchar *) token.data.scalar.value);
-                } else if (next_token == PARSE_NEXT_VAL) {
-                    gchar *val = g_strdup ((const gchar *) token.data.scalar.value);
-                    g_hash_table_insert (stats, key, val);
-                }
+                } else if (next_token == PARSE_NEXT_VAL)
+                    stat_func (key, (const gchar *) token.data.scalar.value, user_data);
                 break;
             default:
                 break;
@@ -256,8 +255,75 @@ vdo_get_stats_full (const gchar *name, GError **error) {
     yaml_parser_delete (&parser);
     dm_task_destroy (dmt);
 
-    if (stats != NULL)
-        add_computed_stats (stats);
+    return TRUE;
+}
+
+static void
+add_stat_to_table (gchar *key, const gchar *value, gpointer user_data) {
+    GHashTable *stats = (GHashTable *) user_data;
+
+    g_hash_table_insert (stats, key, g_strdup (value));
+}
+
+G_GNUC_INTERNAL GHashTable *
+vdo_get_stats_full (const gchar *name, GError **error) {
+    GHashTable *stats = NULL;
+
+    stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    if (!vdo_scan_stats (name, add_stat_to_table, stats, error)) {
+        g_hash_table_destroy (stats);
+        return NULL;
+    }
+
+    add_computed_stats (stats);
 
     return stats;
 }
+
+/* counters from the dm-vdo stats needed for the samples, the keys are the
+   same as in the table returned by vdo_get_stats_full() */
+static const struct {
+    const gchar *key;
+    gsize offset;
+} sample_counters[] = {
+    { "biosInRead", G_STRUCT_OFFSET (BDLVMVDOSample, bios_in_read) },
+    { "biosInWrite", G_STRUCT_OFFSET (BDLVMVDOSample, bios_in_write) },
+    { "biosOutRead", G_STRUCT_OFFSET (BDLVMVDOSample, bios_out_read) },
+    { "biosOutWrite", G_STRUCT_OFFSET (BDLVMVDOSample, bios_out_write) },
+    { "biosMetaWrite", G_STRUCT_OFFSET (BDLVMVDOSample, bios_meta_write) },
+    { "indexPostsFound", G_STRUCT_OFFSET (BDLVMVDOSample, dedupe_posts_found) },
+    { "indexPostsNotFound", G_STRUCT_OFFSET (BDLVMVDOSample, dedupe_posts_not_found) },
+    { "journalDiskFull", G_STRUCT_OFFSET (BDLVMVDOSample, journal_disk_full) },
+    { "slabJournalBlockedCount", G_STRUCT_OFFSET (BDLVMVDOSample, slab_journal_blocked) },
+};
+
+static void
+add_stat_to_sample (gchar *key, const gchar *value, gpointer user_data) {
+    BDLVMVDOSample *sample = (BDLVMVDOSample *) user_data;
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (sample_counters); i++) {
+        if (g_strcmp0 (key, sample_counters[i].key) == 0) {
+            G_STRUCT_MEMBER (guint64, sample, sample_counters[i].offset) = g_ascii_strtoull (value, NULL, 0);
+            break;
+        }
+    }
+
+    g_free (key);
+}
+
+G_GNUC_INTERNAL gboolean
+vdo_get_stats_sample (const gchar *name, BDLVMVDOSample *sample, GError **error) {
+    guint i;
+
+    /* counters missing in the stats (older dm-vdo versions) stay at 0 */
+    for (i = 0; i < G_N_ELEMENTS (sample_counters); i++)
+        G_STRUCT_MEMBER (guint64, sample, sample_counters[i].offset) = 0;
+
+    if (!vdo_scan_stats (name, add_stat_to_sample, sample, error))
+        return FALSE;
+
+    sample->timestamp = g_get_monotonic_time ();
+
+    return TRUE;
+}
@@ -19,6 +19,8 @@
 
 #include <glib.h>
 
+#include "lvm.h"
+
 #ifndef BD_VDO_STATS
 #define BD_VDO_STATS
 
@@ -27,5 +29,6 @@ gboolean get_stat_val64 (GHashTable *stats, const gchar *key, gint64 *val);
 gboolean get_stat_val64_default (GHashTable *stats, const gchar *key, gint64 *val, gint64 def);
 
 GHashTable* vdo_get_stats_full (const gchar *name, GError **error);
+gboolean vdo_get_stats_sample (const gchar *name, BDLVMVDOSample *sample, GError **error);
 
 #endif  /* BD_VDO_STATS */
@@ -84,6 +84,22 @@ void bd_mpath_close (void) {
     g_atomic_int_set (&avail_deps, 0);
 }
 
+/**
+ * bd_mpath_probe_deps:
+ *
+ * Checks all the runtime dependencies of the plugin concurrently so that later
+ * availability checks don't need to run them one by one. **This function is
+ * called automatically by the library's initialization functions if
+ * dependency probing is enabled (see bd_set_deps_probing()).**
+ *
+ */
+void bd_mpath_probe_deps (void) {
+    DepsProbe *probe = deps_probe_new ();
+
+    deps_probe_add_deps (probe, &avail_deps, deps, DEPS_LAST, &deps_check_lock);
+    deps_probe_run (probe);
+}
+
 /**
  * bd_mpath_is_tech_avail:
  * @tech: the queried tech
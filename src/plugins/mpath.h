@@ -34,6 +34,7 @@ typedef enum {
  */
 gboolean bd_mpath_init (void);
 void bd_mpath_close (void);
+void bd_mpath_probe_deps (void);
 
 gboolean bd_mpath_is_tech_avail (BDMpathTech tech, guint64 mode, GError **error);
 
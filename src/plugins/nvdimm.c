@@ -108,6 +108,22 @@ void bd_nvdimm_close (void) {
     g_atomic_int_set (&avail_deps, 0);
 }
 
+/**
+ * bd_nvdimm_probe_deps:
+ *
+ * Checks all the runtime dependencies of the plugin concurrently so that later
+ * availability checks don't need to run them one by one. **This function is
+ * called automatically by the library's initialization functions if
+ * dependency probing is enabled (see bd_set_deps_probing()).**
+ *
+ */
+void bd_nvdimm_probe_deps (void) {
+    DepsProbe *probe = deps_probe_new ();
+
+    deps_probe_add_deps (probe, &avail_deps, deps, DEPS_LAST, &deps_check_lock);
+    deps_probe_run (probe);
+}
+
 
 /**
  * bd_nvdimm_is_tech_avail:
@@ -59,6 +59,7 @@ typedef enum {
  */
 gboolean bd_nvdimm_init (void);
 void bd_nvdimm_close (void);
+void bd_nvdimm_probe_deps (void);
 
 gboolean bd_nvdimm_is_tech_avail (BDNVDIMMTech tech, guint64 mode, GError **error);
 
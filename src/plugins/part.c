@@ -229,7 +229,7 @@ static void close_context (struct fdisk_context *cxt) {
 static gboolean write_label (struct fdisk_context *cxt, struct fdisk_table *orig, const gchar *disk, gboolean force, GError **error) {
     gint ret = 0;
     gint dev_fd = 0;
-    guint num_tries = 1;
+    BDUtilsDevWait *wait = NULL;
 
     /* XXX: try to grab a lock for the device so that udev doesn't step in
        between the two operations we need to perform (see below) with its
@@ -237,12 +237,11 @@ static gboolean write_label (struct fdisk_context *cxt, struct fdisk_table *orig
        see https://systemd.io/BLOCK_DEVICE_LOCKING */
     dev_fd = open (disk, O_RDONLY|O_CLOEXEC);
     if (dev_fd >= 0) {
-        ret = flock (dev_fd, LOCK_EX|LOCK_NB);
-        while ((ret != 0) && (num_tries <= 5)) {
-            g_usleep (100 * 1000); /* microseconds */
+        wait = bd_utils_dev_wait_new (disk, BD_UTILS_DEV_SETTLE_TIMEOUT);
+        do {
             ret = flock (dev_fd, LOCK_EX|LOCK_NB);
-            num_tries++;
-        }
+        } while (ret != 0 && bd_utils_dev_wait_next (wait));
+        bd_utils_dev_wait_free (wait);
     }
 
     /* Just continue even in case we don't get the lock, there's still a
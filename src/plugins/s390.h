@@ -34,6 +34,7 @@ typedef enum {
  */
 gboolean bd_s390_init (void);
 void bd_s390_close (void);
+void bd_s390_probe_deps (void);
 
 gboolean bd_s390_is_tech_avail (BDS390Tech tech, guint64 mode, GError **error);
 
@@ -36,6 +36,11 @@ void _smart_close_plugin (void) {
     /* nothing to do here */
 }
 
+G_GNUC_INTERNAL
+void _smart_probe_deps (void) {
+    /* no runtime dependencies to check */
+}
+
 /**
  * bd_smart_check_deps:
  *
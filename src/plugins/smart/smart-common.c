@@ -198,6 +198,19 @@ void bd_smart_close (void) {
     _smart_close_plugin ();
 }
 
+/**
+ * bd_smart_probe_deps:
+ *
+ * Checks all the runtime dependencies of the plugin concurrently so that later
+ * availability checks don't need to run them one by one. **This function is
+ * called automatically by the library's initialization functions if
+ * dependency probing is enabled (see bd_set_deps_probing()).**
+ *
+ */
+void bd_smart_probe_deps (void) {
+    _smart_probe_deps ();
+}
+
 /**
  * bd_smart_ata_attribute_free: (skip)
  * @attr: (nullable): %BDSmartATAAttribute to free
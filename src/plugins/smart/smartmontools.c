@@ -50,6 +50,14 @@ static const UtilDep deps[DEPS_LAST] = {
     { "smartctl", SMARTCTL_MIN_VERSION, NULL, "smartctl ([\\d\\.]+) .*" },
 };
 
+G_GNUC_INTERNAL
+void _smart_probe_deps (void) {
+    DepsProbe *probe = deps_probe_new ();
+
+    deps_probe_add_deps (probe, &avail_deps, deps, DEPS_LAST, &deps_check_lock);
+    deps_probe_run (probe);
+}
+
 /**
  * bd_smart_check_deps:
  *
@@ -20,6 +20,7 @@
 #include <glib.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
 #include <sys/swap.h>
 #include <fcntl.h>
 #include <blkid.h>
@@ -87,6 +88,22 @@ void bd_swap_close (void) {
     g_atomic_int_set (&avail_deps, 0);
 }
 
+/**
+ * bd_swap_probe_deps:
+ *
+ * Checks all the runtime dependencies of the plugin concurrently so that later
+ * availability checks don't need to run them one by one. **This function is
+ * called automatically by the library's initialization functions if
+ * dependency probing is enabled (see bd_set_deps_probing()).**
+ *
+ */
+void bd_swap_probe_deps (void) {
+    DepsProbe *probe = deps_probe_new ();
+
+    deps_probe_add_deps (probe, &avail_deps, deps, DEPS_LAST, &deps_check_lock);
+    deps_probe_run (probe);
+}
+
 
 /**
  * bd_swap_is_tech_avail:
@@ -165,7 +182,7 @@ gboolean bd_swap_swapon (const gchar *device, gint priority, GError **error) {
     blkid_probe probe = NULL;
     gint fd = 0;
     gint status = 0;
-    guint n_try = 0;
+    BDUtilsDevWait *wait = NULL;
     const gchar *value = NULL;
     gint64 status_len = 0;
     gint64 swap_pagesize = 0;
@@ -201,13 +218,13 @@ gboolean bd_swap_swapon (const gchar *device, gint priority, GError **error) {
         return FALSE;
     }
 
-    /* we may need to try multiple times with some delays in case the device is
-       busy at the very moment */
-    for (n_try=5, status=-1; (status != 0) && (n_try > 0); n_try--) {
+    /* we may need to try multiple times in case the device is busy at the very
+       moment, wait for it to settle in between */
+    wait = bd_utils_dev_wait_new (device, BD_UTILS_DEV_SETTLE_TIMEOUT);
+    do {
         status = blkid_probe_set_device (probe, fd, 0, 0);
-        if (status != 0)
-            g_usleep (100 * 1000); /* microseconds */
-    }
+    } while (status != 0 && errno == EBUSY && bd_utils_dev_wait_next (wait));
+    bd_utils_dev_wait_free (wait);
     if (status != 0) {
         g_set_error (&l_error, BD_SWAP_ERROR, BD_SWAP_ERROR_UNKNOWN_STATE,
                      "Failed to create a probe for the device '%s'", device);
@@ -221,13 +238,14 @@ gboolean bd_swap_swapon (const gchar *device, gint priority, GError **error) {
     blkid_probe_enable_superblocks (probe, 1);
     blkid_probe_set_superblocks_flags (probe, BLKID_SUBLKS_TYPE | BLKID_SUBLKS_MAGIC);
 
-    /* we may need to try multiple times with some delays in case the device is
-       busy at the very moment */
-    for (n_try=5, status=-1; !(status == 0 || status == 1) && (n_try > 0); n_try--) {
+    /* we may need to try multiple times in case the device is busy at the very
+       moment, wait for it to settle in between (-2 means ambiguous signatures,
+       no point in trying again) */
+    wait = bd_utils_dev_wait_new (device, BD_UTILS_DEV_SETTLE_TIMEOUT);
+    do {
         status = blkid_do_safeprobe (probe);
-        if (status < 0)
-            g_usleep (100 * 1000); /* microseconds */
-    }
+    } while (status == -1 && bd_utils_dev_wait_next (wait));
+    bd_utils_dev_wait_free (wait);
     if (status < 0) {
         /* -1 or -2 = error during probing*/
         g_set_error (&l_error, BD_SWAP_ERROR, BD_SWAP_ERROR_UNKNOWN_STATE,
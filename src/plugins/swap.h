@@ -40,6 +40,7 @@ typedef enum {
  */
 gboolean bd_swap_init (void);
 void bd_swap_close (void);
+void bd_swap_probe_deps (void);
 
 gboolean bd_swap_is_tech_avail (BDSwapTech tech, guint64 mode, GError **error);
 
@@ -900,6 +900,12 @@ def lvm_lvs(vg_name=None):
     return _lvm_lvs(vg_name)
 __all__.append("lvm_lvs")
 
+_lvm_lvs_select = BlockDev.lvm_lvs_select
+@override(BlockDev.lvm_lvs_select)
+def lvm_lvs_select(vg_name=None, select_expr=None, fields=BlockDev.LVMLVdataField.ALL):
+    return _lvm_lvs_select(vg_name, select_expr, fields)
+__all__.append("lvm_lvs_select")
+
 _lvm_thpoolcreate = BlockDev.lvm_thpoolcreate
 @override(BlockDev.lvm_thpoolcreate)
 def lvm_thpoolcreate(vg_name, lv_name, size, md_size=0, chunk_size=0, profile=None, extra=None, **kwargs):
@@ -21,6 +21,7 @@
 #include <libudev.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <poll.h>
 
 #include "dev_utils.h"
 
@@ -174,3 +175,150 @@ gchar** bd_utils_get_device_symlinks (const gchar *dev_spec, GError **error) {
 
     return ret;
 }
+
+/* first and maximum delay (in microseconds) between two attempts when waiting
+   for a device to settle */
+#define DEV_WAIT_MIN_DELAY (10 * 1000)
+#define DEV_WAIT_MAX_DELAY (500 * 1000)
+
+struct BDUtilsDevWait {
+    dev_t devnum;
+    gint64 deadline;
+    gint64 delay;
+    struct udev *context;
+    struct udev_monitor *monitor;
+};
+
+/**
+ * bd_utils_dev_wait_new: (skip)
+ * @device: device to wait for
+ * @timeout: maximum time (in milliseconds) to wait for @device to settle
+ *
+ * Creates a new waiter for retrying operations on @device that may fail
+ * because the device is busy at the very moment (e.g. being probed by udev).
+ * Use it as
+ * |[<!-- language="C" -->
+ * wait = bd_utils_dev_wait_new (device, BD_UTILS_DEV_SETTLE_TIMEOUT);
+ * do {
+ *     status = try_something (device);
+ * } while (status != 0 && bd_utils_dev_wait_next (wait));
+ * bd_utils_dev_wait_free (wait);
+ * ]|
+ *
+ * Returns: (transfer full): a new waiter for @device
+ */
+BDUtilsDevWait* bd_utils_dev_wait_new (const gchar *device, guint timeout) {
+    BDUtilsDevWait *wait = g_new0 (BDUtilsDevWait, 1);
+    struct stat sb;
+
+    if (device && stat (device, &sb) == 0 && S_ISBLK (sb.st_mode))
+        wait->devnum = sb.st_rdev;
+    wait->deadline = g_get_monotonic_time () + ((gint64) timeout * 1000);
+    wait->delay = DEV_WAIT_MIN_DELAY;
+
+    return wait;
+}
+
+/* the monitor is only set up once the first attempt fails, no need to bother
+   udev if the device is not busy (which is the most common case) */
+static void dev_wait_setup_monitor (BDUtilsDevWait *wait) {
+    if (wait->devnum == 0 || wait->context)
+        return;
+
+    wait->context = udev_new ();
+    if (!wait->context)
+        return;
+
+    wait->monitor = udev_monitor_new_from_netlink (wait->context, "udev");
+    if (!wait->monitor)
+        return;
+
+    if (udev_monitor_filter_add_match_subsystem_devtype (wait->monitor, "block", NULL) < 0 ||
+        udev_monitor_enable_receiving (wait->monitor) < 0) {
+        udev_monitor_unref (wait->monitor);
+        wait->monitor = NULL;
+    }
+}
+
+/* returns whether there was an event for the device the @wait is for */
+static gboolean dev_wait_process_events (BDUtilsDevWait *wait) {
+    struct udev_device *dev = NULL;
+    gboolean ret = FALSE;
+
+    while ((dev = udev_monitor_receive_device (wait->monitor))) {
+        if (udev_device_get_devnum (dev) == wait->devnum)
+            ret = TRUE;
+        udev_device_unref (dev);
+    }
+
+    return ret;
+}
+
+/**
+ * bd_utils_dev_wait_next: (skip)
+ * @wait: waiter for the device
+ *
+ * Waits until the next attempt to use the device should be made. That is when
+ * udev finishes processing an event for the device or when the current delay
+ * (doubled with every call) passes, whichever comes first.
+ *
+ * Returns: whether another attempt should be made or not (the deadline has
+ *          passed)
+ */
+gboolean bd_utils_dev_wait_next (BDUtilsDevWait *wait) {
+    gint64 now = g_get_monotonic_time ();
+    gint64 until = 0;
+    struct pollfd pfd;
+    gint poll_ret = 0;
+
+    if (now >= wait->deadline)
+        return FALSE;
+
+    until = MIN (now + wait->delay, wait->deadline);
+    wait->delay = MIN (wait->delay * 2, DEV_WAIT_MAX_DELAY);
+
+    dev_wait_setup_monitor (wait);
+    if (!wait->monitor) {
+        g_usleep (until - now);
+        return TRUE;
+    }
+
+    pfd.fd = udev_monitor_get_fd (wait->monitor);
+    pfd.events = POLLIN;
+    while (now < until) {
+        pfd.revents = 0;
+        poll_ret = poll (&pfd, 1, (until - now + 999) / 1000);
+        if (poll_ret < 0 && errno != EINTR && errno != EAGAIN) {
+            /* shouldn't happen, but let's not spin here */
+            g_usleep (until - now);
+            break;
+        }
+        if (poll_ret > 0 && dev_wait_process_events (wait))
+            /* udev is done with the device (for now), try again right away */
+            break;
+        now = g_get_monotonic_time ();
+    }
+
+    return TRUE;
+}
+
+/**
+ * bd_utils_dev_wait_free: (skip)
+ * @wait: (nullable): waiter to free
+ *
+ * Frees @wait. Doesn't change errno so that it can still be used for reporting
+ * the error from the last attempt.
+ */
+void bd_utils_dev_wait_free (BDUtilsDevWait *wait) {
+    int errno_saved = errno;
+
+    if (!wait)
+        return;
+
+    if (wait->monitor)
+        udev_monitor_unref (wait->monitor);
+    if (wait->context)
+        udev_unref (wait->context);
+    g_free (wait);
+    errno = errno_saved;
+}
@@ -32,6 +32,16 @@ typedef enum {
     BD_UTILS_DEV_UTILS_ERROR_FAILED,
 } BDUtilsDevUtilsError;
 
+/* default time (in milliseconds) to wait for a busy device to settle, callers
+   that know the device may stay busy for longer can pass a longer timeout */
+#define BD_UTILS_DEV_SETTLE_TIMEOUT 500
+
+typedef struct BDUtilsDevWait BDUtilsDevWait;
+
+BDUtilsDevWait* bd_utils_dev_wait_new (const gchar *device, guint timeout);
+gboolean bd_utils_dev_wait_next (BDUtilsDevWait *wait);
+void bd_utils_dev_wait_free (BDUtilsDevWait *wait);
+
 gchar* bd_utils_resolve_device (const gchar *dev_spec, GError **error);
 gchar** bd_utils_get_device_symlinks (const gchar *dev_spec, GError **error);
 
@@ -18,14 +18,20 @@
  */
 
 #include <glib.h>
+#include <glib-unix.h>
+#include <glib/gstdio.h>
 #include "exec.h"
 #include "extra_arg.h"
 #include "logging.h"
 #include <stdlib.h>
+#include <string.h>
 #include <poll.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <signal.h>
+#include <spawn.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -45,6 +51,45 @@ static GMutex task_id_counter_lock;
 static guint64 task_id_counter = 0;
 static BDUtilsProgFunc prog_func = NULL;
 static __thread BDUtilsProgFunc thread_prog_func = NULL;
+static BDUtilsExecLogFunc exec_log_func = NULL;
+
+/* per-utility statistics of the executed processes, a fixed-size open
+   addressing table so that the slots can be found and updated with atomic
+   operations only */
+#define EXEC_STATS_SLOTS 256
+
+typedef struct ExecStatsSlot {
+    gchar *util;
+    guint64 count;
+    guint64 failed;
+    guint64 spawn_count;
+    guint64 spawn_time;
+    guint64 first_output_count;
+    guint64 first_output_time;
+    guint64 wall_time;
+    guint64 max_wall_time;
+    guint64 bytes;
+    guint64 histogram[BD_UTILS_EXEC_STATS_HISTOGRAM_BUCKETS];
+} ExecStatsSlot;
+
+static ExecStatsSlot exec_stats[EXEC_STATS_SLOTS];
+
+/* shared pool of threads running the asynchronous exec tasks */
+#define DEFAULT_EXEC_ASYNC_MAX_THREADS 8
+
+static GMutex exec_pool_lock;
+static GThreadPool *exec_pool = NULL;
+static gint exec_pool_max_threads = DEFAULT_EXEC_ASYNC_MAX_THREADS;
+
+typedef struct ExecAsyncData {
+    gchar **argv;
+    BDExtraArg **extra;
+    BDUtilsProgExtract prog_extract;
+    BDUtilsProgFunc prog_func;
+    gint proc_status;
+    gchar *stdout_data;
+    gchar *stderr_data;
+} ExecAsyncData;
 
 /**
  * bd_utils_exec_error_quark: (skip)
@@ -89,15 +134,14 @@ void bd_utils_log_task_status (guint64 task_id, const gchar *msg) {
 static guint64 log_running (const gchar **argv) {
     guint64 task_id = 0;
     gchar *str_argv = NULL;
-    gchar *log_msg = NULL;
 
     task_id = bd_utils_get_next_task_id ();
 
-    str_argv = g_strjoinv (" ", (gchar **) argv);
-    log_msg = g_strdup_printf ("Running [%"G_GUINT64_FORMAT"] %s ...", task_id, str_argv);
-    bd_utils_log (BD_UTILS_LOG_INFO, log_msg);
-    g_free (str_argv);
-    g_free (log_msg);
+    if (bd_utils_log_enabled (BD_UTILS_LOG_INFO)) {
+        str_argv = g_strjoinv (" ", (gchar **) argv);
+        bd_utils_log_format (BD_UTILS_LOG_INFO, "Running [%"G_GUINT64_FORMAT"] %s ...", task_id, str_argv);
+        g_free (str_argv);
+    }
 
     return task_id;
 }
@@ -107,34 +151,457 @@ static guint64 log_running (const gchar **argv) {
  *
  */
 static void log_out (guint64 task_id, const gchar *stdout, const gchar *stderr) {
-    gchar *log_msg = NULL;
+    /* the outputs may be huge, don't copy them around for nothing */
+    if (!bd_utils_log_enabled (BD_UTILS_LOG_INFO))
+        return;
 
-    log_msg = g_strdup_printf ("stdout[%"G_GUINT64_FORMAT"]: %s", task_id, stdout);
-    bd_utils_log (BD_UTILS_LOG_INFO, log_msg);
-    g_free (log_msg);
-
-    log_msg = g_strdup_printf ("stderr[%"G_GUINT64_FORMAT"]: %s", task_id, stderr);
-    bd_utils_log (BD_UTILS_LOG_INFO, log_msg);
-    g_free (log_msg);
+    bd_utils_log_format (BD_UTILS_LOG_INFO, "stdout[%"G_GUINT64_FORMAT"]: %s", task_id, stdout);
+    bd_utils_log_format (BD_UTILS_LOG_INFO, "stderr[%"G_GUINT64_FORMAT"]: %s", task_id, stderr);
 
     return;
 }
 
 /**
  * log_done: (skip)
+ * @start_time: monotonic time the process was started at
+ * @spawned_time: monotonic time the process was running at or -1 if not known
  *
  */
-static void log_done (guint64 task_id, gint exit_code) {
-    gchar *log_msg = NULL;
+static void log_done (guint64 task_id, const gchar **argv, gint exit_code, gint64 start_time, gint64 spawned_time) {
+    BDUtilsExecLogFunc func = exec_log_func;
 
-    log_msg = g_strdup_printf ("...done [%"G_GUINT64_FORMAT"] (exit code: %d)", task_id, exit_code);
-    bd_utils_log (BD_UTILS_LOG_INFO, log_msg);
-    g_free (log_msg);
+    if (func)
+        func (task_id, argv, exit_code, spawned_time >= 0 ? spawned_time - start_time : -1,
+              g_get_monotonic_time () - start_time);
+
+    bd_utils_log_format (BD_UTILS_LOG_INFO, "...done [%"G_GUINT64_FORMAT"] (exit code: %d)", task_id, exit_code);
+
+    return;
+}
+
+/**
+ * log_spawn_failed: (skip)
+ * @start_time: monotonic time the process was being started at
+ * @spawn_error: (nullable): error from the failed spawn
+ *
+ */
+static void log_spawn_failed (guint64 task_id, const gchar **argv, gint64 start_time, const GError *spawn_error) {
+    BDUtilsExecLogFunc func = exec_log_func;
 
+    if (func)
+        func (task_id, argv, -1, -1, g_get_monotonic_time () - start_time);
+
+    bd_utils_log_format (BD_UTILS_LOG_INFO, "...failed to start [%"G_GUINT64_FORMAT"]: %s", task_id,
+                         spawn_error ? spawn_error->message : "unknown error");
 
     return;
 }
 
+/**
+ * get_exec_stats_slot: (skip)
+ *
+ * Returns: (transfer none): the statistics slot for @util (created if needed)
+ *                           or %NULL if there are no free slots
+ */
+static ExecStatsSlot* get_exec_stats_slot (const gchar *util) {
+    guint hash = g_str_hash (util);
+    ExecStatsSlot *slot = NULL;
+    gchar *name = NULL;
+    gchar *new_name = NULL;
+    guint i = 0;
+
+    for (i=0; i < EXEC_STATS_SLOTS; i++) {
+        slot = &(exec_stats[(hash + i) % EXEC_STATS_SLOTS]);
+        name = g_atomic_pointer_get (&(slot->util));
+        if (!name) {
+            new_name = g_strdup (util);
+            if (g_atomic_pointer_compare_and_exchange (&(slot->util), NULL, new_name))
+                return slot;
+            /* somebody else claimed the slot in the meantime */
+            g_free (new_name);
+            name = g_atomic_pointer_get (&(slot->util));
+        }
+        if (g_strcmp0 (name, util) == 0)
+            return slot;
+    }
+
+    return NULL;
+}
+
+static void record_exec_stats (const gchar *argv0, gint exit_code, gint64 start_time, gint64 spawned_time,
+                               gint64 first_output_time, gsize bytes) {
+    ExecStatsSlot *slot = NULL;
+    const gchar *util = NULL;
+    guint64 wall_time = 0;
+    guint64 max = 0;
+    guint64 limit = 1000;
+    guint bucket = 0;
+
+    util = strrchr (argv0, '/');
+    util = util ? util + 1 : argv0;
+
+    slot = get_exec_stats_slot (util);
+    if (!slot)
+        return;
+
+    wall_time = (guint64) (g_get_monotonic_time () - start_time);
+    while (bucket < BD_UTILS_EXEC_STATS_HISTOGRAM_BUCKETS - 1 && wall_time >= limit) {
+        bucket++;
+        limit *= 2;
+    }
+
+    __atomic_add_fetch (&(slot->count), 1, __ATOMIC_RELAXED);
+    if (exit_code != 0)
+        __atomic_add_fetch (&(slot->failed), 1, __ATOMIC_RELAXED);
+    if (spawned_time >= 0) {
+        __atomic_add_fetch (&(slot->spawn_count), 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch (&(slot->spawn_time), (guint64) (spawned_time - start_time), __ATOMIC_RELAXED);
+    }
+    if (first_output_time >= 0) {
+        __atomic_add_fetch (&(slot->first_output_count), 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch (&(slot->first_output_time), (guint64) (first_output_time - start_time), __ATOMIC_RELAXED);
+    }
+    __atomic_add_fetch (&(slot->wall_time), wall_time, __ATOMIC_RELAXED);
+    __atomic_add_fetch (&(slot->bytes), (guint64) bytes, __ATOMIC_RELAXED);
+    __atomic_add_fetch (&(slot->histogram[bucket]), 1, __ATOMIC_RELAXED);
+
+    max = __atomic_load_n (&(slot->max_wall_time), __ATOMIC_RELAXED);
+    while (wall_time > max &&
+           !__atomic_compare_exchange_n (&(slot->max_wall_time), &max, wall_time, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+/**
+ * bd_utils_exec_stats_copy: (skip)
+ * @stats: (nullable): %BDUtilsExecStats to copy
+ *
+ * Creates a new copy of @stats.
+ */
+BDUtilsExecStats* bd_utils_exec_stats_copy (BDUtilsExecStats *stats) {
+    BDUtilsExecStats *ret = NULL;
+
+    if (stats == NULL)
+        return NULL;
+
+    ret = g_new0 (BDUtilsExecStats, 1);
+    *ret = *stats;
+    ret->util = g_strdup (stats->util);
+
+    return ret;
+}
+
+/**
+ * bd_utils_exec_stats_free: (skip)
+ * @stats: (nullable): %BDUtilsExecStats to free
+ *
+ * Frees @stats.
+ */
+void bd_utils_exec_stats_free (BDUtilsExecStats *stats) {
+    if (stats == NULL)
+        return;
+
+    g_free (stats->util);
+    g_free (stats);
+}
+
+GType bd_utils_exec_stats_get_type (void) {
+    static GType type = 0;
+
+    if (G_UNLIKELY (!type))
+        type = g_boxed_type_register_static ("BDUtilsExecStats",
+                                             (GBoxedCopyFunc) bd_utils_exec_stats_copy,
+                                             (GBoxedFreeFunc) bd_utils_exec_stats_free);
+
+    return type;
+}
+
+static BDExtraArg** copy_extra_args (const BDExtraArg **extra) {
+    BDExtraArg **ret = NULL;
+    guint len = 0;
+    guint i = 0;
+
+    if (!extra)
+        return NULL;
+
+    len = g_strv_length ((gchar **) extra);
+    ret = g_new0 (BDExtraArg*, len + 1);
+    for (i = 0; i < len; i++)
+        ret[i] = bd_extra_arg_copy ((BDExtraArg *) extra[i]);
+
+    return ret;
+}
+
+/**
+ * bd_utils_exec_job_new: (constructor)
+ * @argv: (array zero-terminated=1): the argv array for the process
+ * @extra: (nullable) (array zero-terminated=1): extra arguments for the process
+ *
+ * Returns: (transfer full): a new job for bd_utils_exec_batch()
+ */
+BDUtilsExecJob* bd_utils_exec_job_new (const gchar **argv, const BDExtraArg **extra) {
+    BDUtilsExecJob *ret = g_new0 (BDUtilsExecJob, 1);
+
+    ret->argv = g_strdupv ((gchar **) argv);
+    ret->extra = copy_extra_args (extra);
+    ret->status = -1;
+
+    return ret;
+}
+
+/**
+ * bd_utils_exec_job_copy: (skip)
+ * @job: (nullable): %BDUtilsExecJob to copy
+ *
+ * Creates a new copy of @job.
+ */
+BDUtilsExecJob* bd_utils_exec_job_copy (BDUtilsExecJob *job) {
+    BDUtilsExecJob *ret = NULL;
+
+    if (job == NULL)
+        return NULL;
+
+    ret = bd_utils_exec_job_new ((const gchar **) job->argv, (const BDExtraArg **) job->extra);
+    ret->success = job->success;
+    ret->status = job->status;
+    ret->stdout_data = g_strdup (job->stdout_data);
+    ret->stderr_data = g_strdup (job->stderr_data);
+    ret->error_msg = g_strdup (job->error_msg);
+
+    return ret;
+}
+
+/**
+ * bd_utils_exec_job_free: (skip)
+ * @job: (nullable): %BDUtilsExecJob to free
+ *
+ * Frees @job.
+ */
+void bd_utils_exec_job_free (BDUtilsExecJob *job) {
+    if (job == NULL)
+        return;
+
+    g_strfreev (job->argv);
+    bd_extra_arg_list_free (job->extra);
+    g_free (job->stdout_data);
+    g_free (job->stderr_data);
+    g_free (job->error_msg);
+    g_free (job);
+}
+
+GType bd_utils_exec_job_get_type (void) {
+    static GType type = 0;
+
+    if (G_UNLIKELY (!type))
+        type = g_boxed_type_register_static ("BDUtilsExecJob",
+                                             (GBoxedCopyFunc) bd_utils_exec_job_copy,
+                                             (GBoxedFreeFunc) bd_utils_exec_job_free);
+
+    return type;
+}
+
+/**
+ * bd_utils_get_exec_stats:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Statistics of the processes are collected for every utility (by the
+ * basename of the executed program) run by the exec functions since the
+ * start of the process or the last call of bd_utils_reset_exec_stats().
+ * Processes run while this function is running may or may not be included.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): statistics for all the
+ *                                                     utilities run so far
+ */
+BDUtilsExecStats** bd_utils_get_exec_stats (GError **error G_GNUC_UNUSED) {
+    GPtrArray *ret = NULL;
+    ExecStatsSlot *slot = NULL;
+    BDUtilsExecStats *stats = NULL;
+    gchar *util = NULL;
+    guint i = 0;
+    guint j = 0;
+
+    ret = g_ptr_array_new ();
+    for (i=0; i < EXEC_STATS_SLOTS; i++) {
+        slot = &(exec_stats[i]);
+        util = g_atomic_pointer_get (&(slot->util));
+        if (!util || __atomic_load_n (&(slot->count), __ATOMIC_RELAXED) == 0)
+            continue;
+
+        stats = g_new0 (BDUtilsExecStats, 1);
+        stats->util = g_strdup (util);
+        stats->count = __atomic_load_n (&(slot->count), __ATOMIC_RELAXED);
+        stats->failed = __atomic_load_n (&(slot->failed), __ATOMIC_RELAXED);
+        stats->spawn_count = __atomic_load_n (&(slot->spawn_count), __ATOMIC_RELAXED);
+        stats->spawn_time = __atomic_load_n (&(slot->spawn_time), __ATOMIC_RELAXED);
+        stats->first_output_count = __atomic_load_n (&(slot->first_output_count), __ATOMIC_RELAXED);
+        stats->first_output_time = __atomic_load_n (&(slot->first_output_time), __ATOMIC_RELAXED);
+        stats->wall_time = __atomic_load_n (&(slot->wall_time), __ATOMIC_RELAXED);
+        stats->max_wall_time = __atomic_load_n (&(slot->max_wall_time), __ATOMIC_RELAXED);
+        stats->bytes = __atomic_load_n (&(slot->bytes), __ATOMIC_RELAXED);
+        for (j=0; j < BD_UTILS_EXEC_STATS_HISTOGRAM_BUCKETS; j++)
+            stats->histogram[j] = __atomic_load_n (&(slot->histogram[j]), __ATOMIC_RELAXED);
+        g_ptr_array_add (ret, stats);
+    }
+    g_ptr_array_add (ret, NULL);
+
+    return (BDUtilsExecStats **) g_ptr_array_free (ret, FALSE);
+}
+
+/**
+ * bd_utils_reset_exec_stats:
+ *
+ * Resets the statistics of the processes run by the exec functions (see
+ * bd_utils_get_exec_stats()).
+ */
+void bd_utils_reset_exec_stats (void) {
+    ExecStatsSlot *slot = NULL;
+    guint i = 0;
+    guint j = 0;
+
+    /* the utilities keep their slots, only the values are reset */
+    for (i=0; i < EXEC_STATS_SLOTS; i++) {
+        slot = &(exec_stats[i]);
+        __atomic_store_n (&(slot->count), 0, __ATOMIC_RELAXED);
+        __atomic_store_n (&(slot->failed), 0, __ATOMIC_RELAXED);
+        __atomic_store_n (&(slot->spawn_count), 0, __ATOMIC_RELAXED);
+        __atomic_store_n (&(slot->spawn_time), 0, __ATOMIC_RELAXED);
+        __atomic_store_n (&(slot->first_output_count), 0, __ATOMIC_RELAXED);
+        __atomic_store_n (&(slot->first_output_time), 0, __ATOMIC_RELAXED);
+        __atomic_store_n (&(slot->wall_time), 0, __ATOMIC_RELAXED);
+        __atomic_store_n (&(slot->max_wall_time), 0, __ATOMIC_RELAXED);
+        __atomic_store_n (&(slot->bytes), 0, __ATOMIC_RELAXED);
+        for (j=0; j < BD_UTILS_EXEC_STATS_HISTOGRAM_BUCKETS; j++)
+            __atomic_store_n (&(slot->histogram[j]), 0, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * get_exec_env: (skip)
+ *
+ * Returns: (transfer full): the environment to use for the spawned processes
+ *                           (the current environment with C locale forced)
+ */
+static gchar** get_exec_env (void) {
+    gchar **envp = NULL;
+
+    envp = g_environ_setenv (g_get_environ (), "LC_ALL", "C.UTF-8", TRUE);
+    envp = g_environ_unsetenv (envp, "LANGUAGE");
+
+    return envp;
+}
+
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+static void close_pipe (gint fds[2]) {
+    if (fds[0] >= 0)
+        close (fds[0]);
+    if (fds[1] >= 0)
+        close (fds[1]);
+    fds[0] = fds[1] = -1;
+}
+#endif
+
+/**
+ * spawn_with_pipes: (skip)
+ * @argv: the argv array for the call (searched for in $PATH)
+ * @envp: environment for the child process
+ * @pid: (out): place to store PID of the child process
+ * @in_fd: (out) (optional): place to store the write end of child's stdin
+ *                           or %NULL to connect its stdin to /dev/null
+ * @out_fd: (out): place to store the read end of child's stdout
+ * @err_fd: (out): place to store the read end of child's stderr
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * A leaner version of g_spawn_async_with_pipes() using posix_spawn() which is
+ * implemented with vfork-like clone() and so doesn't need to copy page tables
+ * of (potentially big) calling processes. The child is not reaped.
+ *
+ * If posix_spawn() cannot close the file descriptors the child shouldn't get
+ * (no posix_spawn_file_actions_addclosefrom_np()), g_spawn_async_with_pipes()
+ * is used instead. Its child gets /dev/null as stdin too if @in_fd is %NULL
+ * (no %G_SPAWN_CHILD_INHERITS_STDIN).
+ *
+ * Returns: whether the child process was successfully spawned or not
+ */
+static gboolean spawn_with_pipes (const gchar **argv, gchar **envp, GPid *pid, gint *in_fd, gint *out_fd, gint *err_fd, GError **error) {
+#ifndef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+    /* file descriptors without FD_CLOEXEC would leak into the child */
+    return g_spawn_async_with_pipes (NULL, (gchar **) argv, envp,
+                                     G_SPAWN_DEFAULT|G_SPAWN_SEARCH_PATH|G_SPAWN_DO_NOT_REAP_CHILD,
+                                     NULL, NULL, pid, in_fd, out_fd, err_fd, error);
+#else
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t sig_mask;
+    sigset_t sig_default;
+    gint in_pipe[2] = {-1, -1};
+    gint out_pipe[2] = {-1, -1};
+    gint err_pipe[2] = {-1, -1};
+    pid_t child_pid = 0;
+    gint ret = 0;
+
+    /* all our ends of the pipes are close-on-exec so the child only gets the
+       duplicates created by the file actions below */
+    if ((in_fd && !g_unix_open_pipe (in_pipe, FD_CLOEXEC, error)) ||
+        !g_unix_open_pipe (out_pipe, FD_CLOEXEC, error) ||
+        !g_unix_open_pipe (err_pipe, FD_CLOEXEC, error)) {
+        g_prefix_error (error, "Failed to create pipes for the child process: ");
+        close_pipe (in_pipe);
+        close_pipe (out_pipe);
+        close_pipe (err_pipe);
+        return FALSE;
+    }
+
+    posix_spawn_file_actions_init (&actions);
+    if (in_fd)
+        posix_spawn_file_actions_adddup2 (&actions, in_pipe[0], STDIN_FILENO);
+    else
+        /* same as g_spawn_*() without G_SPAWN_CHILD_INHERITS_STDIN */
+        posix_spawn_file_actions_addopen (&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2 (&actions, out_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2 (&actions, err_pipe[1], STDERR_FILENO);
+    /* same as g_spawn_*() -- don't leak any other file descriptors */
+    posix_spawn_file_actions_addclosefrom_np (&actions, STDERR_FILENO + 1);
+
+    /* the child shouldn't inherit the signals blocked or ignored by the caller
+       (e.g. SIGPIPE ignored by Python) */
+    posix_spawnattr_init (&attr);
+    sigemptyset (&sig_mask);
+    sigfillset (&sig_default);
+    sigdelset (&sig_default, SIGKILL);
+    sigdelset (&sig_default, SIGSTOP);
+    posix_spawnattr_setsigmask (&attr, &sig_mask);
+    posix_spawnattr_setsigdefault (&attr, &sig_default);
+    posix_spawnattr_setflags (&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    ret = posix_spawnp (&child_pid, argv[0], &actions, &attr, (gchar * const *) argv, envp);
+    posix_spawn_file_actions_destroy (&actions);
+    posix_spawnattr_destroy (&attr);
+
+    if (in_pipe[0] >= 0)
+        close (in_pipe[0]);
+    close (out_pipe[1]);
+    close (err_pipe[1]);
+
+    if (ret != 0) {
+        g_set_error (error, G_SPAWN_ERROR,
+                     ret == ENOENT ? G_SPAWN_ERROR_NOENT : (ret == EACCES ? G_SPAWN_ERROR_ACCES : G_SPAWN_ERROR_FAILED),
+                     "Failed to execute child process \"%s\" (%s)", argv[0], g_strerror (ret));
+        if (in_pipe[1] >= 0)
+            close (in_pipe[1]);
+        close (out_pipe[0]);
+        close (err_pipe[0]);
+        return FALSE;
+    }
+
+    *pid = child_pid;
+    if (in_fd)
+        *in_fd = in_pipe[1];
+    *out_fd = out_pipe[0];
+    *err_fd = err_pipe[0];
+
+    return TRUE;
+#endif
+}
+
 static const gchar ** _append_extra_args (const gchar **argv, const BDExtraArg **extra) {
     const gchar **args = NULL;
     guint args_len = 0;
@@ -213,25 +680,25 @@ gboolean bd_utils_exec_and_capture_output_no_progress (const gchar **argv, const
     guint64 task_id = 0;
     const gchar **args = NULL;
     gint exit_status = 0;
-    gchar **old_env = NULL;
-    gchar **new_env = NULL;
+    gint64 start_time = 0;
+    gchar **envp = NULL;
     GError *l_error = NULL;
 
     args = _append_extra_args (argv, extra);
 
-    old_env = g_get_environ ();
-    new_env = g_environ_setenv (old_env, "LC_ALL", "C.UTF-8", TRUE);
-    new_env = g_environ_unsetenv (new_env, "LANGUAGE");
+    envp = get_exec_env ();
 
     task_id = log_running (args ? args : argv);
-    success = g_spawn_sync (NULL, args ? (gchar **) args : (gchar **) argv, new_env, G_SPAWN_SEARCH_PATH,
-                            NULL, NULL, &stdout_data, &stderr_data, &exit_status, error);
-    g_strfreev (new_env);
+    start_time = g_get_monotonic_time ();
+    success = g_spawn_sync (NULL, args ? (gchar **) args : (gchar **) argv, envp, G_SPAWN_SEARCH_PATH,
+                            NULL, NULL, &stdout_data, &stderr_data, &exit_status, &l_error);
+    g_strfreev (envp);
     if (!success) {
-        /* error is already populated from the call */
+        log_spawn_failed (task_id, args ? args : argv, start_time, l_error);
         g_free (stdout_data);
         g_free (stderr_data);
         g_free (args);
+        g_propagate_error (error, l_error);
         return FALSE;
     }
 
@@ -246,6 +713,11 @@ gboolean bd_utils_exec_and_capture_output_no_progress (const gchar **argv, const
     if (!g_spawn_check_wait_status (exit_status, &l_error)) {
         if (g_error_matches (l_error, G_SPAWN_ERROR, G_SPAWN_ERROR_FAILED)) {
             /* process was terminated abnormally (e.g. using a signal) */
+            *status = WIFSIGNALED (exit_status) ? 128 + WTERMSIG (exit_status) : -1;
+            log_out (task_id, stdout_data, stderr_data);
+            log_done (task_id, args ? args : argv, *status, start_time, -1);
+            record_exec_stats (argv[0], *status, start_time, -1, -1,
+                               (stdout_data ? strlen (stdout_data) : 0) + (stderr_data ? strlen (stderr_data) : 0));
             g_free (stdout_data);
             g_free (stderr_data);
             g_free (args);
@@ -259,7 +731,10 @@ gboolean bd_utils_exec_and_capture_output_no_progress (const gchar **argv, const
         *status = 0;
 
     log_out (task_id, stdout_data, stderr_data);
-    log_done (task_id, *status);
+    /* g_spawn_sync() doesn't tell us when the process was started */
+    log_done (task_id, args ? args : argv, *status, start_time, -1);
+    record_exec_stats (argv[0], *status, start_time, -1, -1,
+                       (stdout_data ? strlen (stdout_data) : 0) + (stderr_data ? strlen (stderr_data) : 0));
 
     g_free (args);
     if (output)
@@ -320,9 +795,48 @@ static gchar *bd_strchr_len_null (const gchar *haystack, gssize haystack_len, co
         return MAX (ret, ret_null);
 }
 
+/* where the lines read from the process' outputs should go to (if not just
+   collected), see bd_utils_exec_and_stream_lines() */
+typedef struct ExecLineSink {
+    BDUtilsExecLineFunc line_func;
+    gpointer user_data;
+    gsize max_retained;
+    /* whether the limit was hit for stdout and stderr (indexed by is_stderr) */
+    gboolean truncated[2];
+} ExecLineSink;
+
+#define EXEC_TRUNCATED_MARKER "[output truncated]\n"
+
+static void
+_process_line (const gchar *line, GString *filtered_buffer, gboolean is_stderr, guint64 progress_id, guint8 *progress,
+               BDUtilsProgExtract prog_extract, ExecLineSink *sink) {
+    if (prog_extract && prog_extract (line, progress)) {
+        bd_utils_report_progress (progress_id, *progress, NULL);
+        return;
+    }
+
+    if (sink && sink->line_func && !sink->line_func (line, is_stderr, sink->user_data))
+        return;
+
+    if (sink && sink->truncated[is_stderr ? 1 : 0])
+        /* over the limit already, nothing more is retained */
+        return;
+
+    if (sink && sink->max_retained > 0 && filtered_buffer->len + strlen (line) > sink->max_retained) {
+        /* over the limit, drop this line and all the following ones (so that
+           the retained output has no gaps) */
+        sink->truncated[is_stderr ? 1 : 0] = TRUE;
+        g_string_append (filtered_buffer, EXEC_TRUNCATED_MARKER);
+        return;
+    }
+
+    g_string_append (filtered_buffer, line);
+}
+
 static gboolean
 _process_fd_event (gint fd, struct pollfd *poll_fd, GString *read_buffer, GString *filtered_buffer, gsize *read_buffer_pos, gboolean *done,
-                   guint64 progress_id, guint8 *progress, BDUtilsProgExtract prog_extract, GError **error) {
+                   gboolean is_stderr, guint64 progress_id, guint8 *progress, BDUtilsProgExtract prog_extract,
+                   ExecLineSink *sink, GError **error) {
     gchar buf[_EXEC_BUF_SIZE] = { 0 };
     ssize_t num_read;
     gchar *line;
@@ -345,13 +859,14 @@ _process_fd_event (gint fd, struct pollfd *poll_fd, GString *read_buffer, GStrin
                     buf_len = read_buffer->len - *read_buffer_pos,
                     newline_pos = bd_strchr_len_null (buf_ptr, buf_len, '\n'))) {
                 line = g_strndup (buf_ptr, newline_pos - buf_ptr + 1);
-                if (prog_extract && prog_extract (line, progress))
-                    bd_utils_report_progress (progress_id, *progress, NULL);
-                else
-                    g_string_append (filtered_buffer, line);
+                _process_line (line, filtered_buffer, is_stderr, progress_id, progress, prog_extract, sink);
                 g_free (line);
                 *read_buffer_pos = newline_pos - read_buffer->str + 1;
             }
+
+            /* drop the processed lines so that the buffer only holds the incomplete one */
+            g_string_erase (read_buffer, 0, *read_buffer_pos);
+            *read_buffer_pos = 0;
         }
 
         /* read error */
@@ -374,18 +889,15 @@ _process_fd_event (gint fd, struct pollfd *poll_fd, GString *read_buffer, GStrin
         /* process the remaining buffer */
         line = read_buffer->str + *read_buffer_pos;
         /* GString guarantees the buffer is always NULL-terminated. */
-        if (strlen (line) > 0) {
-            if (prog_extract && prog_extract (line, progress))
-                bd_utils_report_progress (progress_id, *progress, NULL);
-            else
-                g_string_append (filtered_buffer, line);
-        }
+        if (strlen (line) > 0)
+            _process_line (line, filtered_buffer, is_stderr, progress_id, progress, prog_extract, sink);
     }
 
     return TRUE;
 }
 
-static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, const gchar *input, gint *proc_status, gchar **stdout, gchar **stderr, GError **error) {
+static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, const gchar *input, GCancellable *cancellable,
+                                                 ExecLineSink *sink, gint *proc_status, gchar **stdout, gchar **stderr, GError **error) {
     const gchar **args = NULL;
     gchar *args_str = NULL;
     guint64 task_id = 0;
@@ -400,7 +912,9 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
     gboolean ret = FALSE;
     gint poll_status = 0;
     guint8 completion = 0;
-    struct pollfd fds[2] = { ZERO_INIT, ZERO_INIT };
+    struct pollfd fds[3] = { ZERO_INIT, ZERO_INIT, ZERO_INIT };
+    nfds_t n_fds = 2;
+    GPollFD cancel_fd = ZERO_INIT;
     int flags;
     gboolean out_done = FALSE;
     gboolean err_done = FALSE;
@@ -410,36 +924,40 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
     GString *stderr_buffer;
     gsize stdout_buffer_pos = 0;
     gsize stderr_buffer_pos = 0;
-    gchar **old_env = NULL;
-    gchar **new_env = NULL;
+    gchar **envp = NULL;
+    gint64 start_time = 0;
+    gint64 spawned_time = 0;
+    gint64 first_output_time = -1;
     gboolean success = TRUE;
     GError *l_error = NULL;
 
+    if (g_cancellable_set_error_if_cancelled (cancellable, error))
+        return FALSE;
+
     args = _append_extra_args (argv, extra);
 
     task_id = log_running (args ? args : argv);
 
-    old_env = g_get_environ ();
-    new_env = g_environ_setenv (old_env, "LC_ALL", "C.UTF-8", TRUE);
-    new_env = g_environ_unsetenv (new_env, "LANGUAGE");
-
-    ret = g_spawn_async_with_pipes (NULL, args ? (gchar**) args : (gchar**) argv, new_env,
-                                    G_SPAWN_DEFAULT|G_SPAWN_SEARCH_PATH|G_SPAWN_DO_NOT_REAP_CHILD,
-                                    NULL, NULL, &pid, input ? &in_fd : NULL, &out_fd, &err_fd, error);
-
-    g_strfreev (new_env);
+    start_time = g_get_monotonic_time ();
+    envp = get_exec_env ();
+    ret = spawn_with_pipes (args ? args : argv, envp, &pid, input ? &in_fd : NULL, &out_fd, &err_fd, &l_error);
+    g_strfreev (envp);
 
     if (!ret) {
-        /* error is already populated */
+        log_spawn_failed (task_id, args ? args : argv, start_time, l_error);
         g_free (args);
+        g_propagate_error (error, l_error);
         return FALSE;
     }
 
-    args_str = g_strjoinv (" ", args ? (gchar **) args : (gchar **) argv);
-    msg = g_strdup_printf ("Started '%s'", args_str);
+    spawned_time = g_get_monotonic_time ();
+
+    if (bd_utils_prog_reporting_initialized ()) {
+        args_str = g_strjoinv (" ", args ? (gchar **) args : (gchar **) argv);
+        msg = g_strdup_printf ("Started '%s'", args_str);
+        g_free (args_str);
+    }
     progress_id = bd_utils_report_started (msg);
-    g_free (args_str);
-    g_free (args);
     g_free (msg);
 
     /* set both fds for non-blocking read */
@@ -470,6 +988,7 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
             close (out_fd);
             close (err_fd);
             waitpid (pid, NULL, 0);
+            g_free (args);
             return FALSE;
         }
         close (in_fd);
@@ -485,8 +1004,13 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
     fds[1].fd = err_fd;
     fds[0].events = POLLIN | POLLHUP | POLLERR;
     fds[1].events = POLLIN | POLLHUP | POLLERR;
+    if (cancellable && g_cancellable_make_pollfd (cancellable, &cancel_fd)) {
+        fds[2].fd = cancel_fd.fd;
+        fds[2].events = POLLIN;
+        n_fds = 3;
+    }
     while (! (out_done && err_done)) {
-        poll_status = poll (fds, 2, -1 /* timeout */);
+        poll_status = poll (fds, n_fds, -1 /* timeout */);
         g_warn_if_fail (poll_status != 0);  /* no timeout specified, zero should never be returned */
         if (poll_status < 0) {
             if (errno == EAGAIN || errno == EINTR)
@@ -499,8 +1023,21 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
             break;
         }
 
+        if (first_output_time < 0 && ((fds[0].revents | fds[1].revents) & POLLIN))
+            first_output_time = g_get_monotonic_time ();
+
+        if (g_cancellable_set_error_if_cancelled (cancellable, &l_error)) {
+            /* the child is reaped below */
+            kill (pid, SIGKILL);
+            *proc_status = 128 + SIGKILL;
+            bd_utils_report_finished (progress_id, l_error->message);
+            g_propagate_error (error, l_error);
+            success = FALSE;
+            break;
+        }
+
         if (!out_done) {
-            if (! _process_fd_event (out_fd, &fds[0], stdout_buffer, stdout_data, &stdout_buffer_pos, &out_done, progress_id, &completion, prog_extract, &l_error)) {
+            if (! _process_fd_event (out_fd, &fds[0], stdout_buffer, stdout_data, &stdout_buffer_pos, &out_done, FALSE, progress_id, &completion, prog_extract, sink, &l_error)) {
                 bd_utils_report_finished (progress_id, l_error->message);
                 g_propagate_error (error, l_error);
                 success = FALSE;
@@ -509,7 +1046,7 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
         }
 
         if (!err_done) {
-            if (! _process_fd_event (err_fd, &fds[1], stderr_buffer, stderr_data, &stderr_buffer_pos, &err_done, progress_id, &completion, prog_extract, &l_error)) {
+            if (! _process_fd_event (err_fd, &fds[1], stderr_buffer, stderr_data, &stderr_buffer_pos, &err_done, TRUE, progress_id, &completion, prog_extract, sink, &l_error)) {
                 bd_utils_report_finished (progress_id, l_error->message);
                 g_propagate_error (error, l_error);
                 success = FALSE;
@@ -518,6 +1055,9 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
         }
     }
 
+    if (n_fds > 2)
+        g_cancellable_release_fd (cancellable);
+
     g_string_free (stdout_buffer, TRUE);
     g_string_free (stderr_buffer, TRUE);
     close (out_fd);
@@ -561,7 +1101,10 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
             bd_utils_report_finished (progress_id, "Completed");
     }
     log_out (task_id, stdout_data->str, stderr_data->str);
-    log_done (task_id, *proc_status);
+    log_done (task_id, args ? args : argv, *proc_status, start_time, spawned_time);
+    record_exec_stats (argv[0], *proc_status, start_time, spawned_time, first_output_time,
+                       stdout_data->len + stderr_data->len);
+    g_free (args);
 
     if (success && stdout)
         *stdout = g_string_free (stdout_data, FALSE);
@@ -590,7 +1133,7 @@ static gboolean _utils_exec_and_report_progress (const gchar **argv, const BDExt
  * Returns: whether the @argv was successfully executed (no error and exit code 0) or not
  */
 gboolean bd_utils_exec_and_report_progress (const gchar **argv, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, gint *proc_status, GError **error) {
-    return _utils_exec_and_report_progress (argv, extra, prog_extract, NULL, proc_status, NULL, NULL, error);
+    return _utils_exec_and_report_progress (argv, extra, prog_extract, NULL, NULL, NULL, proc_status, NULL, NULL, error);
 }
 
 /**
@@ -606,7 +1149,7 @@ gboolean bd_utils_exec_with_input (const gchar **argv, const gchar *input, const
     gint status = 0;
     /* just use the "stronger" function providing dumb progress reporting (just
        'started' and 'finished') and throw away the returned status */
-    return _utils_exec_and_report_progress (argv, extra, NULL, input, &status, NULL, NULL, error);
+    return _utils_exec_and_report_progress (argv, extra, NULL, input, NULL, NULL, &status, NULL, NULL, error);
 }
 
 /**
@@ -627,7 +1170,7 @@ gboolean bd_utils_exec_and_capture_output (const gchar **argv, const BDExtraArg
     gchar *stderr = NULL;
     gboolean ret = FALSE;
 
-    ret = _utils_exec_and_report_progress (argv, extra, NULL, NULL, &status, &stdout, &stderr, error);
+    ret = _utils_exec_and_report_progress (argv, extra, NULL, NULL, NULL, NULL, &status, &stdout, &stderr, error);
     if (!ret)
         return ret;
 
@@ -651,6 +1194,475 @@ gboolean bd_utils_exec_and_capture_output (const gchar **argv, const BDExtraArg
     }
 }
 
+/**
+ * bd_utils_exec_and_stream_lines:
+ * @argv: (array zero-terminated=1): the argv array for the call
+ * @extra: (nullable) (array zero-terminated=1): extra arguments
+ * @line_func: (scope call) (nullable): function to call for every line of the output
+ * @user_data: (closure): data to pass to @line_func
+ * @max_retained: maximum number of bytes of the output to retain in @output
+ *                (and in the error message) or 0 for no limit
+ * @output: (out) (optional): variable to store the retained standard output to
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Runs @argv and calls @line_func for every line of its standard output and
+ * standard error output as soon as it is read. Lines for which @line_func
+ * returns %FALSE are not retained, the retained ones are collected up to
+ * @max_retained bytes (for each of the two outputs) and the rest is dropped so
+ * that commands producing huge outputs can be processed with constant memory.
+ * Once a line doesn't fit into the limit, no more lines are retained from the
+ * given output and a single "[output truncated]" line is appended to it
+ * instead. @line_func is still called for all the lines. If @line_func is
+ * %NULL, all the lines are retained (up to @max_retained bytes).
+ *
+ * Note that any NULL bytes read from standard output and standard error
+ * output will be discarded.
+ *
+ * Returns: whether the @argv was successfully executed (no error and exit code 0) or not
+ */
+gboolean bd_utils_exec_and_stream_lines (const gchar **argv, const BDExtraArg **extra, BDUtilsExecLineFunc line_func, gpointer user_data,
+                                         gsize max_retained, gchar **output, GError **error) {
+    ExecLineSink sink = { line_func, user_data, max_retained, { FALSE, FALSE } };
+    gint status = 0;
+    gchar *stdout = NULL;
+    gchar *stderr = NULL;
+    gboolean ret = FALSE;
+
+    /* non-zero exit code is reported as an error with the retained output */
+    ret = _utils_exec_and_report_progress (argv, extra, NULL, NULL, NULL, &sink, &status, &stdout, &stderr, error);
+    if (!ret)
+        return ret;
+
+    if (output)
+        *output = stdout;
+    else
+        g_free (stdout);
+    g_free (stderr);
+    return TRUE;
+}
+
+/* state of a single running process of a batch, see bd_utils_exec_batch() */
+typedef struct ExecBatchProc {
+    BDUtilsExecJob *job;
+    const gchar **args;
+    guint64 task_id;
+    GPid pid;
+    gint fds[2];
+    gboolean done[2];
+    GString *data[2];
+    GString *buffer[2];
+    gsize buffer_pos[2];
+    gint64 start_time;
+    gint64 spawned_time;
+    gint64 first_output_time;
+} ExecBatchProc;
+
+static void set_job_result (BDUtilsExecJob *job, gboolean success, gint status, gchar *stdout_data, gchar *stderr_data, gchar *error_msg) {
+    g_free (job->stdout_data);
+    g_free (job->stderr_data);
+    g_free (job->error_msg);
+
+    job->success = success;
+    job->status = status;
+    job->stdout_data = stdout_data;
+    job->stderr_data = stderr_data;
+    job->error_msg = error_msg;
+}
+
+static gboolean batch_proc_start (ExecBatchProc *proc, BDUtilsExecJob *job, GError **error) {
+    const gchar **argv = (const gchar **) job->argv;
+    gchar **envp = NULL;
+    gboolean ret = FALSE;
+    int flags;
+    guint i = 0;
+    GError *l_error = NULL;
+
+    proc->args = _append_extra_args (argv, (const BDExtraArg **) job->extra);
+    proc->task_id = log_running (proc->args ? proc->args : argv);
+
+    proc->start_time = g_get_monotonic_time ();
+    envp = get_exec_env ();
+    ret = spawn_with_pipes (proc->args ? proc->args : argv, envp, &(proc->pid), NULL, &(proc->fds[0]), &(proc->fds[1]), &l_error);
+    g_strfreev (envp);
+    if (!ret) {
+        log_spawn_failed (proc->task_id, proc->args ? proc->args : argv, proc->start_time, l_error);
+        g_propagate_error (error, l_error);
+        g_free (proc->args);
+        proc->args = NULL;
+        return FALSE;
+    }
+    proc->spawned_time = g_get_monotonic_time ();
+    proc->first_output_time = -1;
+
+    for (i = 0; i < 2; i++) {
+        flags = fcntl (proc->fds[i], F_GETFL, 0);
+        if (fcntl (proc->fds[i], F_SETFL, flags | O_NONBLOCK))
+            bd_utils_log_format (BD_UTILS_LOG_WARNING,
+                                 "bd_utils_exec_batch: Failed to set fd non-blocking: %m");
+        proc->done[i] = FALSE;
+        proc->data[i] = g_string_new (NULL);
+        proc->buffer[i] = g_string_new (NULL);
+        proc->buffer_pos[i] = 0;
+    }
+    proc->job = job;
+
+    return TRUE;
+}
+
+/* @read_error is the message of the error that happened while reading the
+   outputs of the process (if any), the process is already killed in such case */
+static gboolean batch_proc_finish (ExecBatchProc *proc, const gchar *read_error) {
+    const gchar **argv = (const gchar **) proc->job->argv;
+    gint child_ret = -1;
+    gint status = 0;
+    gint proc_status = -1;
+    gchar *error_msg = NULL;
+    const gchar *msg = NULL;
+    guint i = 0;
+
+    for (i = 0; i < 2; i++) {
+        close (proc->fds[i]);
+        g_string_free (proc->buffer[i], TRUE);
+    }
+
+    child_ret = waitpid (proc->pid, &status, 0);
+    if (child_ret > 0) {
+        if (WIFSIGNALED (status)) {
+            proc_status = 128 + WTERMSIG (status);
+            error_msg = g_strdup (read_error ? read_error : "Process killed with a signal");
+        } else if (WIFEXITED (status) && WEXITSTATUS (status) != 0) {
+            proc_status = WEXITSTATUS (status);
+            msg = proc->data[1]->len > 0 ? proc->data[1]->str : proc->data[0]->str;
+            error_msg = g_strdup_printf ("Process reported exit code %d: %s", proc_status, msg);
+        } else
+            proc_status = WIFEXITED (status) ? WEXITSTATUS (status) : 0;
+    } else if (child_ret == -1 && errno != ECHILD)
+        error_msg = g_strdup ("Failed to wait for the process");
+    else
+        /* no such process (the child exited before we tried to wait for it) */
+        proc_status = 0;
+
+    if (!error_msg && read_error)
+        error_msg = g_strdup (read_error);
+    errno = 0;
+
+    log_out (proc->task_id, proc->data[0]->str, proc->data[1]->str);
+    log_done (proc->task_id, proc->args ? proc->args : argv, proc_status, proc->start_time, proc->spawned_time);
+    record_exec_stats (argv[0], proc_status, proc->start_time, proc->spawned_time, proc->first_output_time,
+                       proc->data[0]->len + proc->data[1]->len);
+    g_free (proc->args);
+
+    set_job_result (proc->job, error_msg == NULL, proc_status,
+                    g_string_free (proc->data[0], FALSE), g_string_free (proc->data[1], FALSE),
+                    error_msg);
+    memset (proc, 0, sizeof (ExecBatchProc));
+
+    return error_msg == NULL;
+}
+
+/**
+ * bd_utils_exec_batch:
+ * @jobs: (array zero-terminated=1): processes to run
+ * @max_parallel: maximum number of processes to run at the same time or 0 to
+ *                use the number of available CPUs
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Runs all the @jobs with at most @max_parallel of them running at the same
+ * time, processing the outputs of all the running processes in a single poll
+ * loop. The result of every job is stored in its @success, @status,
+ * @stdout_data, @stderr_data and @error_msg fields so the results of all the
+ * jobs are available even if some of them fail.
+ *
+ * Note that any NULL bytes read from standard output and standard error
+ * output will be discarded.
+ *
+ * Returns: whether all the @jobs were successfully executed (no error and exit code 0) or not
+ */
+gboolean bd_utils_exec_batch (BDUtilsExecJob **jobs, guint max_parallel, GError **error) {
+    ExecBatchProc *procs = NULL;
+    struct pollfd *fds = NULL;
+    guint n_jobs = 0;
+    guint next = 0;
+    guint n_finished = 0;
+    guint n_failed = 0;
+    guint64 progress_id = 0;
+    guint8 completion = 0;
+    gchar *msg = NULL;
+    gint poll_status = 0;
+    ExecBatchProc *proc = NULL;
+    gboolean proc_ok = TRUE;
+    guint i = 0;
+    guint j = 0;
+    GError *l_error = NULL;
+
+    if (!jobs || !jobs[0])
+        return TRUE;
+
+    n_jobs = g_strv_length ((gchar **) jobs);
+    if (max_parallel == 0)
+        max_parallel = g_get_num_processors ();
+    max_parallel = MIN (max_parallel, n_jobs);
+
+    if (bd_utils_prog_reporting_initialized ()) {
+        msg = g_strdup_printf ("Started a batch of %u processes", n_jobs);
+        progress_id = bd_utils_report_started (msg);
+        g_free (msg);
+    } else
+        progress_id = bd_utils_report_started (NULL);
+
+    procs = g_new0 (ExecBatchProc, max_parallel);
+    fds = g_new0 (struct pollfd, 2 * max_parallel);
+
+    while (n_finished < n_jobs) {
+        /* fill the free slots with new processes */
+        for (i = 0; i < max_parallel; i++) {
+            while (!procs[i].job && next < n_jobs) {
+                if (!batch_proc_start (&(procs[i]), jobs[next], &l_error)) {
+                    set_job_result (jobs[next], FALSE, -1, NULL, NULL, g_strdup (l_error->message));
+                    g_clear_error (&l_error);
+                    n_finished++;
+                    n_failed++;
+                }
+                next++;
+            }
+        }
+        if (n_finished == n_jobs)
+            break;
+
+        /* negative fds are ignored by poll() */
+        for (i = 0; i < 2 * max_parallel; i++) {
+            fds[i].fd = (procs[i / 2].job && !procs[i / 2].done[i % 2]) ? procs[i / 2].fds[i % 2] : -1;
+            fds[i].events = POLLIN | POLLHUP | POLLERR;
+            fds[i].revents = 0;
+        }
+
+        poll_status = poll (fds, 2 * max_parallel, -1 /* timeout */);
+        if (poll_status < 0) {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            /* nothing we can do about the running processes, kill them */
+            msg = g_strdup_printf ("Failed to poll output FDs: %m");
+            for (i = 0; i < max_parallel; i++) {
+                if (procs[i].job) {
+                    kill (procs[i].pid, SIGKILL);
+                    batch_proc_finish (&(procs[i]), msg);
+                    n_finished++;
+                    n_failed++;
+                }
+            }
+            for (; next < n_jobs; next++) {
+                set_job_result (jobs[next], FALSE, -1, NULL, NULL, g_strdup (msg));
+                n_finished++;
+                n_failed++;
+            }
+            g_free (msg);
+            break;
+        }
+
+        for (i = 0; i < max_parallel; i++) {
+            proc = &(procs[i]);
+            proc_ok = TRUE;
+
+            if (!proc->job)
+                continue;
+
+            if (proc->first_output_time < 0 && ((fds[2 * i].revents | fds[2 * i + 1].revents) & POLLIN))
+                proc->first_output_time = g_get_monotonic_time ();
+
+            for (j = 0; proc_ok && j < 2; j++) {
+                if (proc->done[j] || fds[2 * i + j].revents == 0)
+                    continue;
+                proc_ok = _process_fd_event (proc->fds[j], &(fds[2 * i + j]), proc->buffer[j], proc->data[j], &(proc->buffer_pos[j]),
+                                             &(proc->done[j]), j == 1, progress_id, &completion, NULL, NULL, &l_error);
+            }
+
+            if (!proc_ok) {
+                kill (proc->pid, SIGKILL);
+                if (!batch_proc_finish (proc, l_error->message))
+                    n_failed++;
+                g_clear_error (&l_error);
+            } else if (proc->done[0] && proc->done[1]) {
+                if (!batch_proc_finish (proc, NULL))
+                    n_failed++;
+            } else
+                continue;
+
+            n_finished++;
+            bd_utils_report_progress (progress_id, (100 * n_finished) / n_jobs, NULL);
+        }
+    }
+
+    g_free (fds);
+    g_free (procs);
+
+    if (n_failed > 0) {
+        g_set_error (&l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "%u of %u processes failed", n_failed, n_jobs);
+        bd_utils_report_finished (progress_id, l_error->message);
+        g_propagate_error (error, l_error);
+        return FALSE;
+    }
+
+    bd_utils_report_finished (progress_id, "Completed");
+    return TRUE;
+}
+
+static void exec_async_data_free (ExecAsyncData *data) {
+    g_strfreev (data->argv);
+    bd_extra_arg_list_free (data->extra);
+    g_free (data->stdout_data);
+    g_free (data->stderr_data);
+    g_free (data);
+}
+
+static void exec_async_thread (gpointer task_data, gpointer pool_data G_GNUC_UNUSED) {
+    GTask *task = G_TASK (task_data);
+    ExecAsyncData *data = g_task_get_task_data (task);
+    BDUtilsProgFunc old_prog_func = thread_prog_func;
+    GError *l_error = NULL;
+
+    /* report progress the same way the thread that started the task would */
+    thread_prog_func = data->prog_func;
+    if (_utils_exec_and_report_progress ((const gchar **) data->argv, (const BDExtraArg **) data->extra, data->prog_extract, NULL,
+                                         g_task_get_cancellable (task), NULL, &(data->proc_status),
+                                         &(data->stdout_data), &(data->stderr_data), &l_error))
+        g_task_return_boolean (task, TRUE);
+    else
+        g_task_return_error (task, l_error);
+    thread_prog_func = old_prog_func;
+
+    g_object_unref (task);
+}
+
+/**
+ * bd_utils_exec_async_set_max_threads:
+ * @max_threads: maximum number of processes run by bd_utils_exec_async() in parallel
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Tasks started with bd_utils_exec_async() above this limit are queued and run
+ * once some of the running processes finish. The default limit is 8.
+ *
+ * Returns: whether the limit was successfully set or not
+ */
+gboolean bd_utils_exec_async_set_max_threads (guint max_threads, GError **error) {
+    gboolean ret = TRUE;
+
+    if (max_threads == 0 || max_threads > G_MAXINT) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                     "Invalid number of threads: %u", max_threads);
+        return FALSE;
+    }
+
+    g_mutex_lock (&exec_pool_lock);
+    exec_pool_max_threads = (gint) max_threads;
+    if (exec_pool)
+        ret = g_thread_pool_set_max_threads (exec_pool, exec_pool_max_threads, error);
+    g_mutex_unlock (&exec_pool_lock);
+
+    return ret;
+}
+
+/**
+ * bd_utils_exec_async:
+ * @argv: (array zero-terminated=1): the argv array for the call
+ * @extra: (nullable) (array zero-terminated=1): extra arguments
+ * @prog_extract: (scope async) (nullable): function for extracting progress information
+ * @cancellable: (nullable): a #GCancellable to cancel the call (kills the process)
+ * @callback: (scope async): callback to call when the process finishes
+ * @user_data: (closure): data to pass to @callback
+ *
+ * Runs @argv the same way bd_utils_exec_and_report_progress() does, but in a
+ * shared pool of threads (see bd_utils_exec_async_set_max_threads()) without
+ * blocking the calling thread. @callback is called in the thread-default main
+ * context of the calling thread once the process finishes, use
+ * bd_utils_exec_async_finish() to get the result.
+ *
+ * The progress reporting function set up for the calling thread (if any) is
+ * used for reporting progress of the process.
+ */
+void bd_utils_exec_async (const gchar **argv, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, GCancellable *cancellable,
+                          GAsyncReadyCallback callback, gpointer user_data) {
+    GTask *task = NULL;
+    ExecAsyncData *data = NULL;
+    const BDExtraArg **extra_p = NULL;
+    guint extra_len = 0;
+    guint i = 0;
+    gboolean pushed = FALSE;
+    GError *l_error = NULL;
+
+    task = g_task_new (NULL, cancellable, callback, user_data);
+    g_task_set_source_tag (task, bd_utils_exec_async);
+
+    data = g_new0 (ExecAsyncData, 1);
+    data->argv = g_strdupv ((gchar **) argv);
+    if (extra) {
+        for (extra_p = extra; *extra_p; extra_p++)
+            extra_len++;
+        data->extra = g_new0 (BDExtraArg *, extra_len + 1);
+        for (i=0; i < extra_len; i++)
+            data->extra[i] = bd_extra_arg_copy ((BDExtraArg *) extra[i]);
+    }
+    data->prog_extract = prog_extract;
+    data->prog_func = thread_prog_func;
+    g_task_set_task_data (task, data, (GDestroyNotify) exec_async_data_free);
+
+    g_mutex_lock (&exec_pool_lock);
+    if (!exec_pool)
+        exec_pool = g_thread_pool_new (exec_async_thread, NULL, exec_pool_max_threads, FALSE, &l_error);
+    /* the pool takes over the reference to the task */
+    if (exec_pool)
+        pushed = g_thread_pool_push (exec_pool, task, &l_error);
+    g_mutex_unlock (&exec_pool_lock);
+
+    if (!pushed) {
+        g_prefix_error (&l_error, "Failed to start the process: ");
+        g_task_return_error (task, l_error);
+        g_object_unref (task);
+    }
+}
+
+/**
+ * bd_utils_exec_async_finish:
+ * @result: a #GAsyncResult passed to the callback given to bd_utils_exec_async()
+ * @proc_status: (out) (optional): place to store the process exit status
+ * @output: (out) (optional): place to store stdout of the process to
+ * @stderr: (out) (optional): place to store stderr of the process to
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Note that the outputs are only available if the process was successfully
+ * executed with exit code 0, @error is set otherwise. If the call was
+ * cancelled, @error is set to %G_IO_ERROR_CANCELLED.
+ *
+ * Returns: whether the process was successfully executed (no error and exit code 0) or not
+ */
+gboolean bd_utils_exec_async_finish (GAsyncResult *result, gint *proc_status, gchar **output, gchar **stderr, GError **error) {
+    GTask *task = NULL;
+    ExecAsyncData *data = NULL;
+
+    g_return_val_if_fail (g_task_is_valid (result, NULL), FALSE);
+    g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == bd_utils_exec_async, FALSE);
+
+    task = G_TASK (result);
+    data = g_task_get_task_data (task);
+
+    if (proc_status)
+        *proc_status = data->proc_status;
+
+    if (!g_task_propagate_boolean (task, error))
+        return FALSE;
+
+    if (output) {
+        *output = data->stdout_data;
+        data->stdout_data = NULL;
+    }
+    if (stderr) {
+        *stderr = data->stderr_data;
+        data->stderr_data = NULL;
+    }
+
+    return TRUE;
+}
+
 /**
  * bd_utils_version_cmp:
  * @ver_string1: first version string
@@ -726,6 +1738,219 @@ gint bd_utils_version_cmp (const gchar *ver_string1, const gchar *ver_string2, G
     return ret;
 }
 
+/* cache of the outputs of the '$util --version'-like calls shared by all the
+   processes of the user, see get_util_info() */
+#define UTIL_INFO_CACHE_DIR "libblockdev-utils"
+
+static gchar* get_util_info_cache_dir (void) {
+    return g_build_filename (g_get_user_runtime_dir (), UTIL_INFO_CACHE_DIR, NULL);
+}
+
+/**
+ * get_util_info_cache_key: (skip)
+ *
+ * The key identifies the particular binary (an upgrade replaces the file and
+ * thus changes the inode, size and/or mtime) and the argument used.
+ */
+static gchar* get_util_info_cache_key (const gchar *util_path, const gchar *arg) {
+    struct stat st;
+    gchar *real_path = NULL;
+    gchar *key = NULL;
+
+    real_path = realpath (util_path, NULL);
+    if (!real_path || stat (real_path, &st) != 0) {
+        free (real_path);
+        return NULL;
+    }
+
+    key = g_strdup_printf ("%s %s %" G_GUINT64_FORMAT " %" G_GINT64_FORMAT " %" G_GINT64_FORMAT ".%09ld\n",
+                           real_path, arg ? arg : "", (guint64) st.st_ino, (gint64) st.st_size,
+                           (gint64) st.st_mtim.tv_sec, (glong) st.st_mtim.tv_nsec);
+    free (real_path);
+
+    return key;
+}
+
+/**
+ * get_util_info: (skip)
+ * @util: name of the utility to run
+ * @util_path: full path of @util
+ * @arg: argument to run @util with
+ *
+ * Returns: (transfer full): output of `$util $arg` (standard error output is used
+ *                           too if there is no standard output or @util exits
+ *                           with non-zero code), either cached or from running @util
+ */
+static gchar* get_util_info (const gchar *util, const gchar *util_path, const gchar *arg, GError **error) {
+    const gchar *argv[] = {util, arg, NULL};
+    gchar *key = NULL;
+    gchar *cache_dir = NULL;
+    gchar *cache_file = NULL;
+    gchar *checksum = NULL;
+    gchar *contents = NULL;
+    gchar *output = NULL;
+    gchar *stdout_data = NULL;
+    gchar *stderr_data = NULL;
+    gint status = 0;
+    gboolean succ = FALSE;
+    gboolean written = FALSE;
+    GError *l_error = NULL;
+
+    key = get_util_info_cache_key (util_path, arg);
+    if (key) {
+        cache_dir = get_util_info_cache_dir ();
+        checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, key, -1);
+        cache_file = g_build_filename (cache_dir, checksum, NULL);
+        g_free (checksum);
+
+        /* the key is stored in the file too to rule out collisions */
+        if (g_file_get_contents (cache_file, &contents, NULL, NULL) && g_str_has_prefix (contents, key)) {
+            output = g_strdup (contents + strlen (key));
+            g_free (contents);
+            g_free (cache_file);
+            g_free (cache_dir);
+            g_free (key);
+            return output;
+        }
+        g_free (contents);
+    }
+
+    /* fails only if the util cannot be run or doesn't exit normally (e.g. is
+       killed with a signal), both may be just temporary */
+    succ = bd_utils_exec_and_capture_output_no_progress (argv, NULL, &stdout_data, &stderr_data, &status, error);
+    if (!succ) {
+        g_free (cache_file);
+        g_free (cache_dir);
+        g_free (key);
+        return NULL;
+    }
+
+    if (status != 0)
+        /* exit status != 0, try using the output anyway */
+        output = g_strconcat (stdout_data ? stdout_data : "", stderr_data, NULL);
+    else if (!stdout_data || g_strcmp0 (stdout_data, "") == 0)
+        /* if we got nothing on STDOUT, try using STDERR data */
+        output = g_strdup (stderr_data ? stderr_data : "");
+    else
+        output = g_strdup (stdout_data);
+    g_free (stdout_data);
+    g_free (stderr_data);
+
+    /* some utilities print the version to STDERR or exit with non-zero code so
+       the output of all the runs that exited normally is cached */
+    if (key) {
+        /* failing to write the cache is not an error, we just run the util next time */
+        contents = g_strconcat (key, output, NULL);
+        if (g_mkdir_with_parents (cache_dir, 0700) == 0) {
+#if GLIB_CHECK_VERSION(2, 66, 0)
+            written = g_file_set_contents_full (cache_file, contents, -1, G_FILE_SET_CONTENTS_CONSISTENT,
+                                                0600, &l_error);
+#else
+            written = g_file_set_contents (cache_file, contents, -1, &l_error) && g_chmod (cache_file, 0600) == 0;
+#endif
+        }
+        if (!written) {
+            bd_utils_log_format (BD_UTILS_LOG_DEBUG, "Failed to cache output of '%s %s': %s", util, arg ? arg : "",
+                                 l_error ? l_error->message : g_strerror (errno));
+            g_clear_error (&l_error);
+        }
+        g_free (contents);
+    }
+
+    g_free (cache_file);
+    g_free (cache_dir);
+    g_free (key);
+
+    return output;
+}
+
+/* compiled regexps used to parse the outputs of the version and feature checks,
+   the regexps come from the plugins and so there are just a few of them */
+static GMutex util_info_regex_lock;
+static GHashTable *util_info_regexes = NULL;
+
+/**
+ * get_util_info_regex: (skip)
+ *
+ * Returns: (transfer full): compiled @regexp
+ */
+static GRegex* get_util_info_regex (const gchar *regexp, GError **error) {
+    GRegex *regex = NULL;
+
+    g_mutex_lock (&util_info_regex_lock);
+    if (!util_info_regexes)
+        util_info_regexes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_regex_unref);
+
+    regex = g_hash_table_lookup (util_info_regexes, regexp);
+    if (!regex) {
+        regex = g_regex_new (regexp, G_REGEX_OPTIMIZE, 0, error);
+        if (!regex) {
+            /* error is already populated */
+            g_mutex_unlock (&util_info_regex_lock);
+            return NULL;
+        }
+        g_hash_table_insert (util_info_regexes, g_strdup (regexp), regex);
+    }
+    g_regex_ref (regex);
+    g_mutex_unlock (&util_info_regex_lock);
+
+    return regex;
+}
+
+/**
+ * bd_utils_flush_util_info_cache:
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Removes all the cached results of the utilities' version and feature checks
+ * (see bd_utils_check_util_version() and bd_utils_check_util_feature()). The
+ * cache is shared by all processes of the user and is stored in the
+ * `$XDG_RUNTIME_DIR/libblockdev-utils` directory. Entries for upgraded
+ * utilities are invalidated automatically, flushing the cache is only needed
+ * if the output of a utility changes without the utility binary being changed.
+ *
+ * Note: Availability of the utilities already checked by the plugins in this
+ *       process is not affected, use bd_reinit() to re-check it.
+ *
+ * Returns: whether the cache was successfully flushed or not
+ */
+gboolean bd_utils_flush_util_info_cache (GError **error) {
+    gchar *cache_dir = NULL;
+    gchar *path = NULL;
+    const gchar *name = NULL;
+    GDir *dir = NULL;
+    GError *l_error = NULL;
+    gboolean ret = TRUE;
+
+    cache_dir = get_util_info_cache_dir ();
+    dir = g_dir_open (cache_dir, 0, &l_error);
+    if (!dir) {
+        if (g_error_matches (l_error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+            /* nothing cached */
+            g_clear_error (&l_error);
+            g_free (cache_dir);
+            return TRUE;
+        }
+        g_propagate_prefixed_error (error, l_error, "Failed to flush the utilities cache: ");
+        g_free (cache_dir);
+        return FALSE;
+    }
+
+    while ((name = g_dir_read_name (dir))) {
+        path = g_build_filename (cache_dir, name, NULL);
+        if (unlink (path) != 0 && errno != ENOENT && ret) {
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED,
+                         "Failed to remove cache file '%s': %m", path);
+            ret = FALSE;
+        }
+        g_free (path);
+    }
+
+    g_dir_close (dir);
+    g_free (cache_dir);
+
+    return ret;
+}
+
 /**
  * bd_utils_check_util_version:
  * @util: name of the utility to check
@@ -746,7 +1971,6 @@ gint bd_utils_version_cmp (const gchar *ver_string1, const gchar *ver_string2, G
  */
 gboolean bd_utils_check_util_version (const gchar *util, const gchar *version, const gchar *version_arg, const gchar *version_regexp, GError **error) {
     gchar *util_path = NULL;
-    const gchar *argv[] = {util, version_arg ? version_arg : "--version", NULL};
     gchar *output = NULL;
     gboolean succ = FALSE;
     GRegex *regex = NULL;
@@ -760,27 +1984,21 @@ gboolean bd_utils_check_util_version (const gchar *util, const gchar *version, c
                      "The '%s' utility is not available", util);
         return FALSE;
     }
-    g_free (util_path);
 
-    if (!version)
+    if (!version) {
         /* nothing more to do here */
+        g_free (util_path);
         return TRUE;
-
-    succ = bd_utils_exec_and_capture_output (argv, NULL, &output, &l_error);
-    if (!succ) {
-        /* if we got nothing on STDOUT, try using STDERR data from error message */
-        if (g_error_matches (l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_NOOUT)) {
-            output = g_strdup (l_error->message);
-            g_clear_error (&l_error);
-        } else if (g_error_matches (l_error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_FAILED)) {
-            /* exit status != 0, try using the output anyway */
-            output = g_strdup (l_error->message);
-            g_clear_error (&l_error);
-        }
     }
 
+    output = get_util_info (util, util_path, version_arg ? version_arg : "--version", error);
+    g_free (util_path);
+    if (!output)
+        /* error is already populated */
+        return FALSE;
+
     if (version_regexp) {
-        regex = g_regex_new (version_regexp, 0, 0, error);
+        regex = get_util_info_regex (version_regexp, error);
         if (!regex) {
             g_free (output);
             /* error is already populated */
@@ -830,6 +2048,107 @@ gboolean bd_utils_check_util_version (const gchar *util, const gchar *version, c
     return TRUE;
 }
 
+/**
+ * bd_utils_check_util_feature:
+ * @util: name of the utility to check
+ * @feature: name of the feature to check for
+ * @feature_arg: (nullable): argument to use with the @util to get the supported
+ *               features or %NULL if no argument should be used
+ * @feature_regexp: (nullable): regexp to extract the list of features from the
+ *                  output or %NULL if only the features are printed by "$ @util @feature_arg"
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Returns: whether the @util is available and supports @feature or not
+ *          (@error is set in such case).
+ */
+gboolean bd_utils_check_util_feature (const gchar *util, const gchar *feature, const gchar *feature_arg, const gchar *feature_regexp, GError **error) {
+    gchar *util_path = NULL;
+    gchar *output = NULL;
+    gboolean succ = FALSE;
+    GRegex *regex = NULL;
+    GMatchInfo *match_info = NULL;
+    gchar *features_str = NULL;
+
+    util_path = g_find_program_in_path (util);
+    if (!util_path) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_UTIL_UNAVAILABLE,
+                     "The '%s' utility is not available", util);
+        return FALSE;
+    }
+
+    output = get_util_info (util, util_path, feature_arg, error);
+    g_free (util_path);
+    if (!output)
+        /* error is already populated */
+        return FALSE;
+
+    if (feature_regexp) {
+        regex = get_util_info_regex (feature_regexp, error);
+        if (!regex) {
+            g_free (output);
+            /* error is already populated */
+            return FALSE;
+        }
+
+        succ = g_regex_match (regex, output, 0, &match_info);
+        if (!succ) {
+            g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_UTIL_FEATURE_CHECK_ERROR,
+                         "Failed to determine %s's features from: %s", util, output);
+            g_free (output);
+            g_regex_unref (regex);
+            g_match_info_free (match_info);
+            return FALSE;
+        }
+        g_regex_unref (regex);
+
+        features_str = g_match_info_fetch (match_info, 1);
+        g_match_info_free (match_info);
+    }
+    else
+        features_str = g_strstrip (g_strdup (output));
+
+    if (!features_str || (g_strcmp0 (features_str, "") == 0)) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_UTIL_FEATURE_CHECK_ERROR,
+                     "Failed to determine %s's features from: %s", util, output);
+        g_free (features_str);
+        g_free (output);
+        return FALSE;
+    }
+
+    g_free (output);
+
+    if (!g_strrstr (features_str, feature)) {
+        g_set_error (error, BD_UTILS_EXEC_ERROR, BD_UTILS_EXEC_ERROR_UTIL_FEATURE_UNAVAILABLE,
+                     "Required feature %s not supported by this version of %s",
+                     feature, util);
+        g_free (features_str);
+        return FALSE;
+    }
+
+    g_free (features_str);
+    return TRUE;
+}
+
+/**
+ * bd_utils_init_exec_logging:
+ * @new_exec_log_func: (nullable) (scope forever): structured logging function
+ *                                                    to call for every finished
+ *                                                    process or %NULL to disable it
+ * @error: (out) (optional): place to store error (if any)
+ *
+ * Unlike the logging function set with bd_utils_init_logging(), @new_exec_log_func
+ * gets the information about the processes as separate values instead of
+ * preformatted messages and is called independently of the log level. It is
+ * also called (with -1 as the exit status) for processes that failed to start.
+ *
+ * Returns: whether structured logging was successfully initialized or not
+ */
+gboolean bd_utils_init_exec_logging (BDUtilsExecLogFunc new_exec_log_func, GError **error G_GNUC_UNUSED) {
+    exec_log_func = new_exec_log_func;
+
+    return TRUE;
+}
+
 /**
  * bd_utils_init_prog_reporting:
  * @new_prog_func: (nullable) (scope notified): progress reporting function to
@@ -1,4 +1,5 @@
 #include <glib.h>
+#include <gio/gio.h>
 #include "extra_arg.h"
 
 #ifndef BD_UTILS_EXEC
@@ -48,6 +49,32 @@ typedef void (*BDUtilsProgFunc) (guint64 task_id, BDUtilsProgStatus status, guin
  */
 typedef gboolean (*BDUtilsProgExtract) (const gchar *line, guint8 *completion);
 
+/**
+ * BDUtilsExecLogFunc:
+ * @task_id: ID of the task the process was run as (same as in the log messages)
+ * @argv: (array zero-terminated=1): the argv array of the process (including extra arguments)
+ * @exit_status: exit status of the process or -1 if it failed to start
+ * @spawn_time: time (in microseconds) it took to start the process or -1 if not known
+ * @wall_time: time (in microseconds) from starting the process until it finished
+ *
+ * Function type for the structured logging function called by the libblockdev's
+ * exec utils for every finished process.
+ */
+typedef void (*BDUtilsExecLogFunc) (guint64 task_id, const gchar **argv, gint exit_status, gint64 spawn_time, gint64 wall_time);
+
+/**
+ * BDUtilsExecLineFunc:
+ * @line: line read from the process' output (including the trailing newline character, if any)
+ * @is_stderr: whether @line was read from the standard error output or not
+ * @user_data: (closure): user data passed to bd_utils_exec_and_stream_lines()
+ *
+ * Function type for processing lines of a running process' output as soon as
+ * they are read.
+ *
+ * Returns: whether the line should be retained in the collected output or not
+ */
+typedef gboolean (*BDUtilsExecLineFunc) (const gchar *line, gboolean is_stderr, gpointer user_data);
+
 GQuark bd_utils_exec_error_quark (void);
 #define BD_UTILS_EXEC_ERROR bd_utils_exec_error_quark ()
 typedef enum {
@@ -62,15 +89,100 @@ typedef enum {
     BD_UTILS_EXEC_ERROR_UTIL_FEATURE_UNAVAILABLE,
 } BDUtilsExecError;
 
+#define BD_UTILS_EXEC_STATS_HISTOGRAM_BUCKETS 16
+
+#define BD_UTILS_TYPE_EXEC_STATS (bd_utils_exec_stats_get_type ())
+GType bd_utils_exec_stats_get_type (void);
+
+/**
+ * BDUtilsExecStats:
+ * @util: name of the utility (the basename of the executed program)
+ * @count: number of processes run
+ * @failed: number of processes that exited with a non-zero exit status or were killed
+ * @spawn_count: number of processes the spawn time is known for
+ * @spawn_time: total time (in microseconds) spent starting the @spawn_count processes
+ * @first_output_count: number of processes the time to the first output is known for
+ * @first_output_time: total time (in microseconds) from starting the @first_output_count
+ *                     processes to their first output
+ * @wall_time: total wall clock time (in microseconds) of the processes
+ * @max_wall_time: longest wall clock time (in microseconds) of a single process
+ * @bytes: total number of bytes captured from the standard and error outputs of the processes
+ * @histogram: wall clock time histogram, the bucket `i` contains the number of
+ *             processes that ran for less than `2^i` milliseconds (and longer
+ *             than the limit of the previous bucket), the last bucket contains
+ *             all the processes that ran longer
+ */
+typedef struct BDUtilsExecStats {
+    gchar *util;
+    guint64 count;
+    guint64 failed;
+    guint64 spawn_count;
+    guint64 spawn_time;
+    guint64 first_output_count;
+    guint64 first_output_time;
+    guint64 wall_time;
+    guint64 max_wall_time;
+    guint64 bytes;
+    guint64 histogram[BD_UTILS_EXEC_STATS_HISTOGRAM_BUCKETS];
+} BDUtilsExecStats;
+
+BDUtilsExecStats* bd_utils_exec_stats_copy (BDUtilsExecStats *stats);
+void bd_utils_exec_stats_free (BDUtilsExecStats *stats);
+
+#define BD_UTILS_TYPE_EXEC_JOB (bd_utils_exec_job_get_type ())
+GType bd_utils_exec_job_get_type (void);
+
+/**
+ * BDUtilsExecJob:
+ * @argv: (array zero-terminated=1): the argv array for the process
+ * @extra: (array zero-terminated=1): extra arguments for the process
+ * @success: whether the process was successfully executed (no error and exit code 0) or not
+ * @status: exit status of the process (or -1 if it failed to start)
+ * @stdout_data: standard output of the process
+ * @stderr_data: standard error output of the process
+ * @error_msg: error message in case the process failed
+ *
+ * A single process run by bd_utils_exec_batch(). The @success, @status,
+ * @stdout_data, @stderr_data and @error_msg fields are filled in once the
+ * process finishes.
+ */
+typedef struct BDUtilsExecJob {
+    gchar **argv;
+    BDExtraArg **extra;
+    gboolean success;
+    gint status;
+    gchar *stdout_data;
+    gchar *stderr_data;
+    gchar *error_msg;
+} BDUtilsExecJob;
+
+BDUtilsExecJob* bd_utils_exec_job_new (const gchar **argv, const BDExtraArg **extra);
+BDUtilsExecJob* bd_utils_exec_job_copy (BDUtilsExecJob *job);
+void bd_utils_exec_job_free (BDUtilsExecJob *job);
+
 gboolean bd_utils_exec_and_report_error (const gchar **argv, const BDExtraArg **extra, GError **error);
 gboolean bd_utils_exec_and_report_error_no_progress (const gchar **argv, const BDExtraArg **extra, GError **error);
 gboolean bd_utils_exec_and_report_status_error (const gchar **argv, const BDExtraArg **extra, gint *status, GError **error);
 gboolean bd_utils_exec_and_capture_output (const gchar **argv, const BDExtraArg **extra, gchar **output, GError **error);
+gboolean bd_utils_exec_and_stream_lines (const gchar **argv, const BDExtraArg **extra, BDUtilsExecLineFunc line_func, gpointer user_data,
+                                         gsize max_retained, gchar **output, GError **error);
+gboolean bd_utils_exec_batch (BDUtilsExecJob **jobs, guint max_parallel, GError **error);
 gboolean bd_utils_exec_and_capture_output_no_progress (const gchar **argv, const BDExtraArg **extra, gchar **output, gchar **stderr, gint *status, GError **error);
 gboolean bd_utils_exec_and_report_progress (const gchar **argv, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, gint *proc_status, GError **error);
 gboolean bd_utils_exec_with_input (const gchar **argv, const gchar *input, const BDExtraArg **extra, GError **error);
+void bd_utils_exec_async (const gchar **argv, const BDExtraArg **extra, BDUtilsProgExtract prog_extract, GCancellable *cancellable,
+                          GAsyncReadyCallback callback, gpointer user_data);
+gboolean bd_utils_exec_async_finish (GAsyncResult *result, gint *proc_status, gchar **output, gchar **stderr, GError **error);
+gboolean bd_utils_exec_async_set_max_threads (guint max_threads, GError **error);
 gint bd_utils_version_cmp (const gchar *ver_string1, const gchar *ver_string2, GError **error);
 gboolean bd_utils_check_util_version (const gchar *util, const gchar *version, const gchar *version_arg, const gchar *version_regexp, GError **error);
+gboolean bd_utils_check_util_feature (const gchar *util, const gchar *feature, const gchar *feature_arg, const gchar *feature_regexp, GError **error);
+gboolean bd_utils_flush_util_info_cache (GError **error);
+
+BDUtilsExecStats** bd_utils_get_exec_stats (GError **error);
+void bd_utils_reset_exec_stats (void);
+
+gboolean bd_utils_init_exec_logging (BDUtilsExecLogFunc new_exec_log_func, GError **error);
 
 gboolean bd_utils_init_prog_reporting (BDUtilsProgFunc new_prog_func, GError **error);
 gboolean bd_utils_init_prog_reporting_thread (BDUtilsProgFunc new_prog_func, GError **error);
@@ -66,13 +66,26 @@ void bd_utils_set_log_level (gint level) {
     log_level = level;
 }
 
+/**
+ * bd_utils_log_enabled:
+ * @level: log level
+ *
+ * Cheap check to be used before constructing (potentially expensive) log
+ * messages.
+ *
+ * Returns: whether messages with the @level log level would be logged or not
+ */
+gboolean bd_utils_log_enabled (gint level) {
+    return log_func && level <= log_level;
+}
+
 /**
  * bd_utils_log:
  * @level: log level
  * @msg: log message
  */
 void bd_utils_log (gint level, const gchar *msg) {
-    if (log_func && level <= log_level)
+    if (bd_utils_log_enabled (level))
         log_func (level, msg);
 }
 
@@ -87,7 +100,7 @@ void bd_utils_log_format (gint level, const gchar *format, ...) {
     va_list args;
     gint ret = 0;
 
-    if (log_func && level <= log_level) {
+    if (bd_utils_log_enabled (level)) {
         va_start (args, format);
         ret = g_vasprintf (&msg, format, args);
         va_end (args);
@@ -30,6 +30,7 @@ typedef void (*BDUtilsLogFunc) (gint level, const gchar *msg);
 gboolean bd_utils_init_logging (BDUtilsLogFunc new_log_func, GError **error);
 
 void bd_utils_set_log_level (gint level);
+gboolean bd_utils_log_enabled (gint level);
 
 void bd_utils_log (gint level, const gchar *msg);
 void bd_utils_log_format (gint level, const gchar *format, ...) G_GNUC_PRINTF (2, 3);
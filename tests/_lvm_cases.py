@@ -17,8 +17,9 @@ from utils import create_sparse_tempfile, create_lio_device, delete_lio_device,
 
 import gi
 gi.require_version('GLib', '2.0')
+gi.require_version('Gio', '2.0')
 gi.require_version('BlockDev', '3.0')
-from gi.repository import GLib, BlockDev
+from gi.repository import GLib, Gio, BlockDev
 
 
 def _get_lvm_version():
@@ -948,6 +949,40 @@ class LvmTestLVs(LvmPVVGLVTestCase):
         with self.assertRaises(GLib.GError):
             BlockDev.lvm_lvremove("testVG", "testLV", True, None)
 
+    def test_lvcreate_lvremove_many(self):
+        """Verify that it's possible to create/activate/destroy multiple LVs at once"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev], 0, None)
+        self.assertTrue(succ)
+
+        specs = [BlockDev.LVMLVCreateSpec.new("testLV", 100 * 1024**2, None, None),
+                 BlockDev.LVMLVCreateSpec.new("testLV2", 100 * 1024**2, None, [self.loop_dev]),
+                 BlockDev.LVMLVCreateSpec.new("testLV3", 100 * 1024**2, None, ["/non/existing/device"])]
+        results = BlockDev.lvm_lvcreate_many("testVG", specs, None)
+        self.assertEqual([r.lv_name for r in results], ["testLV", "testLV2", "testLV3"])
+        self.assertEqual([r.success for r in results], [True, True, False])
+        self.assertIsNone(results[0].error_message)
+        self.assertTrue(results[2].error_message)
+
+        succ = BlockDev.lvm_lvdeactivate("testVG", "testLV", None)
+        self.assertTrue(succ)
+        succ = BlockDev.lvm_lvdeactivate("testVG", "testLV2", None)
+        self.assertTrue(succ)
+
+        results = BlockDev.lvm_lvactivate_many("testVG", ["testLV", "testLV2"], True, False, None)
+        self.assertTrue(all(r.success for r in results))
+        self.assertEqual(BlockDev.lvm_lvinfo("testVG", "testLV").attr[4], "a")
+        self.assertEqual(BlockDev.lvm_lvinfo("testVG", "testLV2").attr[4], "a")
+
+        results = BlockDev.lvm_lvremove_many("testVG", ["testLV", "nonexistingLV", "testLV2"], True, None)
+        self.assertEqual([r.success for r in results], [True, False, True])
+
+        lvs = BlockDev.lvm_lvs("testVG")
+        self.assertEqual(len(lvs), 0)
+
     def test_lvremove_extra_args(self):
         """Verify that specifying extra arguments for lvremove works as expected"""
 
@@ -1277,6 +1312,55 @@ class LvmTestLVs(LvmPVVGLVTestCase):
             self.assertEqual(lv.segs[0].pvdev, self.loop_dev)
             self.assertGreater(lv.segs[0].size_pe, 0)
 
+    def test_fullreport(self):
+        """Verify that it's possible to gather info about everything at once"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev2, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 12 * 1024**2)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV2", 12 * 1024**2)
+        self.assertTrue(succ)
+        self.addCleanup(self._lvremove, "testVG", "testLV2")
+
+        # by resizing the first LV we will create two segments
+        succ = BlockDev.lvm_lvresize("testVG", "testLV", 24 * 1024**2, None)
+        self.assertTrue(succ)
+
+        report = BlockDev.lvm_fullreport()
+
+        pvs = {pv.pv_name: pv for pv in report.pvs}
+        self.assertIn(self.loop_dev, pvs)
+        self.assertIn(self.loop_dev2, pvs)
+        self.assertEqual(pvs[self.loop_dev].vg_name, "testVG")
+        self.assertIsNone(pvs[self.loop_dev2].vg_name)
+
+        vgs = [vg for vg in report.vgs if vg.name == "testVG"]
+        self.assertEqual(len(vgs), 1)
+        self.assertEqual(vgs[0].pv_count, 1)
+
+        lvs = {lv.lv_name: lv for lv in report.lvs if lv.vg_name == "testVG"}
+        self.assertCountEqual(lvs.keys(), ["testLV", "testLV2"])
+        self.assertEqual(lvs["testLV"].size, 24 * 1024**2)
+        self.assertEqual(len(lvs["testLV"].segs), 2)
+        self.assertEqual(len(lvs["testLV2"].segs), 1)
+        self.assertEqual(lvs["testLV2"].segs[0].pvdev, self.loop_dev)
+
+        # same information as from the separate calls
+        tree = {lv.lv_name: lv for lv in BlockDev.lvm_lvs_tree("testVG")}
+        for name, lv in lvs.items():
+            self.assertEqual(lv.uuid, tree[name].uuid)
+            self.assertEqual(lv.attr, tree[name].attr)
+            self.assertEqual(len(lv.segs), len(tree[name].segs))
+
     @tag_test(TestTags.SLOW)
     def test_create_cached_lv(self):
         """Verify that it is possible to create a cached LV in a single step"""
@@ -1380,6 +1464,16 @@ class LvmTestLVs(LvmPVVGLVTestCase):
         self.assertEqual(stats.cache_size, 512 * 1024**2)
         self.assertEqual(stats.md_size, 8 * 1024**2)
         self.assertEqual(stats.mode, BlockDev.LVMCacheMode.WRITETHROUGH)
+        # nothing is ever dirty in a writethrough cache
+        self.assertEqual(stats.dirty, 0)
+
+        # the same stats for all cached LVs at once
+        all_stats = [s for s in BlockDev.lvm_cache_stats_all() if s.vg_name == "testVG"]
+        self.assertEqual(len(all_stats), 1)
+        self.assertEqual(all_stats[0].lv_name, "testLV")
+        self.assertEqual(all_stats[0].stats.cache_size, 512 * 1024**2)
+        self.assertEqual(all_stats[0].stats.md_size, 8 * 1024**2)
+        self.assertEqual(all_stats[0].stats.mode, BlockDev.LVMCacheMode.WRITETHROUGH)
 
     @tag_test(TestTags.SLOW)
     def test_thinpool_cache_get_stats(self):
@@ -1417,6 +1511,12 @@ class LvmTestLVs(LvmPVVGLVTestCase):
         self.assertEqual(stats.md_size, 8 * 1024**2)
         self.assertEqual(stats.mode, BlockDev.LVMCacheMode.WRITETHROUGH)
 
+        # the cached data LV is reported when asking for all cached LVs
+        all_stats = [s for s in BlockDev.lvm_cache_stats_all() if s.vg_name == "testVG"]
+        self.assertEqual(len(all_stats), 1)
+        self.assertEqual(all_stats[0].lv_name, "testPool_tdata")
+        self.assertEqual(all_stats[0].stats.cache_size, 512 * 1024**2)
+
     def test_lvtags(self):
         """Verify that it's possible to set and get info about LV tags"""
 
@@ -1690,6 +1790,65 @@ class LvmTestThpool(LvmPVVGthpoolTestCase):
         lvs = BlockDev.lvm_lvs("testVG")
         self.assertGreaterEqual(len(lvs), 3)
 
+    def test_thpool_stats_monitor(self):
+        """Verify that thin pool usage can be monitored"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_thpoolcreate("testVG", "testPool", 256 * 1024**2, 4 * 1024**2, 512 * 1024, None, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_thlvcreate("testVG", "testPool", "testThLV", 512 * 1024**2, None)
+        self.assertTrue(succ)
+
+        # write something to the thin LV to allocate some data blocks
+        run_command("dd if=/dev/urandom of=/dev/testVG/testThLV bs=1M count=16 oflag=direct")
+
+        stats = [s for s in BlockDev.lvm_thpool_stats_all() if s.vg_name == "testVG"]
+        self.assertEqual(len(stats), 1)
+        self.assertEqual(stats[0].pool_name, "testPool")
+        self.assertEqual(stats[0].data_size, 256 * 1024**2)
+        self.assertEqual(stats[0].metadata_size, 4 * 1024**2)
+        self.assertGreaterEqual(stats[0].data_used, 16 * 1024**2)
+        self.assertAlmostEqual(stats[0].data_percent, 100.0 * stats[0].data_used / stats[0].data_size)
+        self.assertGreater(stats[0].metadata_percent, 0)
+        self.assertFalse(stats[0].out_of_data_space)
+
+        reported = []
+        def report(stats, user_data):
+            if stats.vg_name == "testVG":
+                reported.append(stats.pool_name)
+            return True
+
+        # over the data threshold, reported only once
+        succ = BlockDev.lvm_thpool_monitor(5, 0, 1, 2, None, report, None)
+        self.assertTrue(succ)
+        self.assertEqual(reported, ["testPool"])
+
+        # under the thresholds
+        reported.clear()
+        succ = BlockDev.lvm_thpool_monitor(90, 90, 1, 1, None, report, None)
+        self.assertTrue(succ)
+        self.assertEqual(reported, [])
+
+        # monitoring until cancelled, the (long) wait for the next check is cut short
+        cancellable = Gio.Cancellable()
+        def cancel(stats, user_data):
+            cancellable.cancel()
+            return True
+
+        start = time.time()
+        with self.assertRaisesRegex(GLib.GError, "cancelled"):
+            BlockDev.lvm_thpool_monitor(5, 0, 3600, 0, cancellable, cancel, None)
+        self.assertLess(time.time() - start, 60)
+
+        succ = BlockDev.lvm_lvremove("testVG", "testThLV", True, None)
+        self.assertTrue(succ)
+
     @tag_test(TestTags.CORE)
     def test_thpoolcreate(self):
         """Verify that it is possible to create a thin pool"""
@@ -2270,6 +2429,53 @@ class LvmVDOTest(LvmTestCase):
         full_stats = BlockDev.lvm_vdo_get_stats_full("testVDOVG", "vdoPool")
         self.assertIn("writeAmplificationRatio", full_stats.keys())
 
+        samples = [s for s in BlockDev.lvm_vdo_sample_all() if s.vg_name == "testVDOVG"]
+        self.assertEqual(len(samples), 1)
+        self.assertEqual(samples[0].pool_name, "vdoPool")
+
+        # write something to the VDO LV to get some non-zero rates
+        with open("/dev/testVDOVG/vdoLV", "wb") as f:
+            f.write(os.urandom(1024**2))
+            os.fsync(f.fileno())
+
+        new_samples = [s for s in BlockDev.lvm_vdo_sample_all() if s.vg_name == "testVDOVG"]
+        self.assertEqual(len(new_samples), 1)
+        self.assertGreater(new_samples[0].bios_in_write, samples[0].bios_in_write)
+
+        rates = BlockDev.lvm_vdo_sample_rates(samples[0], new_samples[0])
+        self.assertEqual(rates.pool_name, "vdoPool")
+        self.assertGreater(rates.interval, 0)
+        self.assertGreater(rates.bios_in_per_sec, 0)
+        self.assertGreaterEqual(rates.dedupe_hit_rate, 0)
+        self.assertLessEqual(rates.dedupe_hit_rate, 1)
+
+        # samples must be given in the right order
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_vdo_sample_rates(new_samples[0], samples[0])
+
+    @tag_test(TestTags.SLOW)
+    def test_sample_all_skip(self):
+        succ = BlockDev.lvm_vdo_pool_create("testVDOVG", "vdoLV", "vdoPool", 7 * 1024**3, 35 * 1024**3)
+        self.assertTrue(succ)
+
+        # a pool in a weird state is either sampled or skipped, it never makes
+        # the sampling of all the pools fail
+        ret, _out, err = run_command("dmsetup suspend testVDOVG-vdoPool-vpool")
+        self.assertEqual(ret, 0, err)
+        self.addCleanup(run_command, "dmsetup resume testVDOVG-vdoPool-vpool")
+
+        samples = [s for s in BlockDev.lvm_vdo_sample_all() if s.vg_name == "testVDOVG"]
+        self.assertLessEqual(len(samples), 1)
+        if samples:
+            self.assertEqual(samples[0].pool_name, "vdoPool")
+
+        ret, _out, err = run_command("dmsetup resume testVDOVG-vdoPool-vpool")
+        self.assertEqual(ret, 0, err)
+
+        samples = [s for s in BlockDev.lvm_vdo_sample_all() if s.vg_name == "testVDOVG"]
+        self.assertEqual(len(samples), 1)
+        self.assertEqual(samples[0].pool_name, "vdoPool")
+
 
 class LvmTestDevicesFile(LvmPVonlyTestCase):
     devicefile = "bd_lvm_tests.devices"
@@ -122,6 +122,29 @@ class TestGenericWipe(GenericTestCase):
         self.assertEqual(fs_type, b"")
 
 
+class TestGetFstype(GenericTestCase):
+    @tag_test(TestTags.CORE)
+    def test_get_fstype_ambiguous(self):
+        """Verify that ambiguous signatures are reported without waiting for the device to settle"""
+
+        ret = utils.run("mkfs.ext2 -F %s >/dev/null 2>&1" % self.loop_devs[0])
+        self.assertEqual(ret, 0)
+
+        # add a swap signature (at the end of the first 4 KiB page) without
+        # removing the ext2 one, blkid can't decide which one is valid
+        ret = utils.run("printf SWAPSPACE2 | dd of=%s bs=1 seek=4086 conv=notrunc,fsync >/dev/null 2>&1" % self.loop_devs[0])
+        self.assertEqual(ret, 0)
+        utils.run("udevadm settle")
+
+        start = time.monotonic()
+        with self.assertRaisesRegex(GLib.GError, "Failed to probe the device"):
+            BlockDev.fs_get_fstype(self.loop_devs[0])
+        duration = time.monotonic() - start
+
+        # not a transient error, no retries
+        self.assertLess(duration, 0.25)
+
+
 class TestClean(GenericTestCase):
     def test_clean(self):
         """Verify that device clean works as expected"""
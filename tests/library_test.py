@@ -121,6 +121,98 @@ class LibraryOpsTestCase(unittest.TestCase):
         # loaded again
         self.assertTrue(BlockDev.md_canonicalize_uuid("3386ff85:f5012621:4a435f06:1eb47236"))
 
+    @tag_test(TestTags.CORE)
+    def test_lazy_loading(self):
+        """Verify that plugins can be loaded lazily"""
+
+        BlockDev.set_lazy_loading(True)
+        try:
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+
+            # available without being initialized
+            self.assertTrue(BlockDev.is_plugin_available(BlockDev.Plugin.MDRAID))
+            self.assertIn("mdraid", BlockDev.get_available_plugin_names())
+            self.assertEqual(BlockDev.get_plugin_soname(BlockDev.Plugin.MDRAID), "libbd_mdraid.so.3")
+
+            # loaded and initialized on the first use (even after the checks above)
+            self.assertTrue(BlockDev.md_canonicalize_uuid("3386ff85:f5012621:4a435f06:1eb47236"))
+            self.assertTrue(BlockDev.md_canonicalize_uuid("3386ff85:f5012621:4a435f06:1eb47236"))
+            self.assertEqual(BlockDev.get_plugin_soname(BlockDev.Plugin.MDRAID), "libbd_mdraid.so.3")
+
+            # plugins that cannot be loaded are not available and report errors
+            ps = BlockDev.PluginSpec(name=BlockDev.Plugin.SWAP, so_name="libbd_swap.so.1337")
+            self.assertTrue(BlockDev.reinit([ps], True, None))
+            self.assertFalse(BlockDev.is_plugin_available(BlockDev.Plugin.SWAP))
+            with self.assertRaises(GLib.GError):
+                BlockDev.swap_swapstatus("/dev/nonexistent")
+
+            # not loaded at all
+            with self.assertRaises(GLib.GError):
+                BlockDev.md_canonicalize_uuid("3386ff85:f5012621:4a435f06:1eb47236")
+        finally:
+            BlockDev.set_lazy_loading(False)
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+
+        # loaded normally again
+        self.assertTrue(BlockDev.md_canonicalize_uuid("3386ff85:f5012621:4a435f06:1eb47236"))
+
+    @tag_test(TestTags.CORE)
+    def test_deps_probing(self):
+        """Verify that probing the dependencies at init time gives the same results"""
+
+        def _avail():
+            try:
+                return BlockDev.md_is_tech_avail(BlockDev.MDTech.MDRAID, 0)
+            except GLib.GError:
+                return False
+
+        self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+        expected = _avail()
+
+        BlockDev.set_deps_probing(True)
+        try:
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+            self.assertEqual(_avail(), expected)
+
+            # probing the already loaded plugins again is fine
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, False, None))
+            self.assertEqual(_avail(), expected)
+        finally:
+            BlockDev.set_deps_probing(False)
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+
+    @tag_test(TestTags.CORE)
+    def test_api_stats(self):
+        """Verify that statistics of the API calls are collected"""
+
+        BlockDev.reset_api_stats()
+        for _i in range(3):
+            self.assertTrue(BlockDev.md_canonicalize_uuid("3386ff85:f5012621:4a435f06:1eb47236"))
+        with self.assertRaises(GLib.GError):
+            BlockDev.md_canonicalize_uuid("not-an-uuid")
+
+        stats = {st.function: st for st in BlockDev.get_api_stats()}
+        if not stats:
+            self.skipTest("library built without instrumented API functions")
+
+        md_stats = stats["bd_md_canonicalize_uuid"]
+        self.assertEqual(md_stats.calls, 4)
+        self.assertEqual(md_stats.errors, 1)
+        self.assertEqual(sum(md_stats.histogram), 4)
+        self.assertGreaterEqual(md_stats.total_time, md_stats.max_time)
+
+        # tracing
+        events = []
+        BlockDev.set_api_trace_func(lambda fn, finished, _duration, failed: events.append((fn, finished, failed)))
+        try:
+            self.assertTrue(BlockDev.md_canonicalize_uuid("3386ff85:f5012621:4a435f06:1eb47236"))
+        finally:
+            BlockDev.set_api_trace_func(None)
+        self.assertEqual(events, [("bd_md_canonicalize_uuid", False, False), ("bd_md_canonicalize_uuid", True, False)])
+
+        BlockDev.reset_api_stats()
+        self.assertEqual(BlockDev.get_api_stats(), [])
+
     def test_ensure_init(self):
         """Verify that ensure_init just returns when already initialized"""
 
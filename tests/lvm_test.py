@@ -1,6 +1,13 @@
+import os
+import json
+import shutil
+import tempfile
+import threading
+import time
+
 import _lvm_cases
 
-from utils import TestTags, tag_test, required_plugins, fake_path
+from utils import TestTags, tag_test, required_plugins, fake_path, run_command
 
 import gi
 gi.require_version('GLib', '2.0')
@@ -103,6 +110,46 @@ class LvmTestLVs(_lvm_cases.LvmTestLVs, LvmTestCase):
         _lvm_cases.LvmTestLVs.setUpClass()
         LvmTestCase.setUpClass()
 
+    def test_lvs_select(self):
+        """Verify that it's possible to get only some information about selected LVs"""
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_vgcreate("testVG", [self.loop_dev], 0, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV", 100 * 1024**2, None, None, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_lvcreate("testVG", "testLV2", 100 * 1024**2, None, None, None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_add_lv_tags("testVG", "testLV2", ["sel"])
+        self.assertTrue(succ)
+
+        lvs = BlockDev.lvm_lvs_select("testVG", "lv_tags=sel", BlockDev.LVMLVdataField.SIZE)
+        self.assertEqual(len(lvs), 1)
+        self.assertEqual(lvs[0].lv_name, "testLV2")
+        self.assertEqual(lvs[0].vg_name, "testVG")
+        self.assertEqual(lvs[0].size, 100 * 1024**2)
+        # not requested
+        self.assertIsNone(lvs[0].uuid)
+        self.assertIsNone(lvs[0].attr)
+
+        lvs = BlockDev.lvm_lvs_select("testVG", None, BlockDev.LVMLVdataField.ALL)
+        self.assertEqual({lv.lv_name for lv in lvs}, {"testLV", "testLV2"})
+        self.assertTrue(all(lv.uuid and lv.attr for lv in lvs))
+
+        lvs = BlockDev.lvm_lvs_select("testVG", "lv_name=nonexistingLV", BlockDev.LVMLVdataField.ALL)
+        self.assertEqual(len(lvs), 0)
+
+        with self.assertRaises(GLib.GError):
+            BlockDev.lvm_lvs_select("testVG", "nonexisting_field=1", 0)
+
+        succ = BlockDev.lvm_lvremove("testVG", "testLV2", True, None)
+        self.assertTrue(succ)
+
 
 class LvmCLITestLVcreateType(_lvm_cases.LvmTestLVcreateType, LvmTestCase):
     @classmethod
@@ -145,3 +192,375 @@ class LvmTestDevicesFile(_lvm_cases.LvmTestDevicesFile, LvmTestCase):
         _lvm_cases.LvmTestDevicesFile.setUpClass()
         LvmTestCase.setUpClass()
 
+
+class LvmTestShellMode(_lvm_cases.LvmPVonlyTestCase, LvmTestCase):
+    @classmethod
+    def setUpClass(cls):
+        LvmTestCase.setUpClass()
+
+    def _shell_running(self):
+        ret, _out, _err = run_command("pgrep -P %d -x lvm" % os.getpid())
+        return ret == 0
+
+    def _num_shells(self):
+        _ret, out, _err = run_command("pgrep -P %d -x lvm" % os.getpid())
+        return len(out.split())
+
+    def test_shell_mode(self):
+        """Verify that LVM commands can be run in a persistent LVM shell"""
+
+        self.addCleanup(BlockDev.lvm_set_shell_mode, False, 0)
+
+        succ = BlockDev.lvm_set_shell_mode(True, 0)
+        self.assertTrue(succ)
+
+        succ = BlockDev.lvm_pvcreate(self.loop_dev, 0, 0, None)
+        self.assertTrue(succ)
+        self.assertTrue(self._shell_running())
+
+        info = BlockDev.lvm_pvinfo(self.loop_dev)
+        self.assertEqual(info.pv_name, self.loop_dev)
+
+        pvs = BlockDev.lvm_pvs()
+        self.assertTrue(any(pv.pv_name == self.loop_dev for pv in pvs))
+
+        # failures are reported the same way as without the shell (ECMD_FAILED)
+        with self.assertRaisesRegex(GLib.GError, "exit code 5"):
+            BlockDev.lvm_vgcreate("testVG", ["/non/existing/device"], 0, None)
+
+        # a new shell is started if the old one exits
+        run_command("pkill -KILL -P %d -x lvm" % os.getpid())
+        time.sleep(0.5)
+        info = BlockDev.lvm_pvinfo(self.loop_dev)
+        self.assertEqual(info.pv_name, self.loop_dev)
+        self.assertTrue(self._shell_running())
+
+        succ = BlockDev.lvm_pvremove(self.loop_dev, None)
+        self.assertTrue(succ)
+
+        # disabling the shell mode terminates the shell
+        succ = BlockDev.lvm_set_shell_mode(False, 0)
+        self.assertTrue(succ)
+        self.assertFalse(self._shell_running())
+
+    def test_shell_mode_config_change(self):
+        """Verify that LVM shells for a replaced global config are terminated"""
+
+        self.addCleanup(BlockDev.lvm_set_shell_mode, False, 0)
+        self.addCleanup(BlockDev.lvm_set_global_config, None)
+
+        succ = BlockDev.lvm_set_shell_mode(True, 0)
+        self.assertTrue(succ)
+
+        BlockDev.lvm_pvs()
+        self.assertEqual(self._num_shells(), 1)
+
+        succ = BlockDev.lvm_set_global_config("backup {backup=0 archive=0}")
+        self.assertTrue(succ)
+        self.assertEqual(self._num_shells(), 0)
+
+        BlockDev.lvm_pvs()
+        self.assertEqual(self._num_shells(), 1)
+
+        # back to the original config, still just one shell
+        succ = BlockDev.lvm_set_global_config(None)
+        self.assertTrue(succ)
+        BlockDev.lvm_pvs()
+        self.assertEqual(self._num_shells(), 1)
+
+    def test_shell_mode_idle_timeout(self):
+        """Verify that idle LVM shells are terminated"""
+
+        self.addCleanup(BlockDev.lvm_set_shell_mode, False, 0)
+
+        succ = BlockDev.lvm_set_shell_mode(True, 1)
+        self.assertTrue(succ)
+
+        BlockDev.lvm_pvs()
+        self.assertTrue(self._shell_running())
+
+        time.sleep(3)
+        self.assertFalse(self._shell_running())
+
+        # and started again when needed
+        BlockDev.lvm_pvs()
+        self.assertTrue(self._shell_running())
+
+
+class LvmFakeToolTestCase(LvmTestCase):
+    """Base class for tests feeding synthetic reports to the plugin via a fake 'lvm' tool"""
+
+    n_vgs = 10
+
+    @classmethod
+    def setUpClass(cls):
+        LvmTestCase.setUpClass()
+
+    def setUp(self):
+        self.fake_dir = tempfile.mkdtemp(prefix="libblockdev-lvm-report")
+        self.addCleanup(shutil.rmtree, self.fake_dir)
+        self.addCleanup(BlockDev.reinit, self.requested_plugins, True, None)
+
+    def _lv_entry(self, vg, lv, seg):
+        return {"vg_name": vg, "lv_name": lv, "lv_uuid": "%s-%s-uuid" % (vg, lv),
+                "lv_size": str(8 * 1024**2), "lv_attr": "-wi-a-----", "segtype": "linear",
+                "origin": "", "pool_lv": "", "data_lv": "", "metadata_lv": "", "lv_role": ["public"],
+                "move_pv": "", "data_percent": None, "metadata_percent": None, "copy_percent": None,
+                "lv_tags": [], "devices": ["/dev/sd%s(%d)" % (vg[-1], seg * 2)], "metadata_devices": [],
+                "seg_size_pe": "2", "vg_uuid": "%s-uuid" % vg, "vg_seqno": self._vg_seqno,
+                "vg_missing_pv_count": self._vg_missing_pvs}
+
+    def _write_report(self, n_lvs, compact=False, delay=0):
+        """Every VG has LVs with the same names, every 10th LV has two segments
+
+           The start and end times of the report calls are logged to calls.log
+           (see _get_calls()), all the LVM commands run to execs.log (see
+           _get_execs()).
+        """
+        self._n_lvs = n_lvs
+        self._compact = compact
+
+        execs_log = os.path.join(self.fake_dir, "execs.log")
+        with open(os.path.join(self.fake_dir, "lvm"), "w") as f:
+            f.write("#!/bin/sh\n"
+                    "if [ \"$1\" = \"version\" ]; then\n"
+                    "    echo 'LVM version:     2.03.99(2) (2099-01-01)'\n"
+                    "elif [ \"$1\" = \"vgs\" ]; then\n"
+                    "    echo \"$1\" >> %s\n"
+                    "    cat %s\n"
+                    "else\n"
+                    "    echo \"$1\" >> %s\n"
+                    "    start=$(date +%%s.%%N 2>/dev/null)\n"
+                    "    %s\n"
+                    "    cat %s\n"
+                    "    echo \"$start $(date +%%s.%%N 2>/dev/null)\" >> %s\n"
+                    "fi\n" % (execs_log, os.path.join(self.fake_dir, "vgs.json"), execs_log,
+                               "sleep %d" % delay if delay else "true",
+                               os.path.join(self.fake_dir, "report.json"),
+                               os.path.join(self.fake_dir, "calls.log")))
+        os.chmod(os.path.join(self.fake_dir, "lvm"), 0o755)
+        self._write_vgs_report(1)
+
+    def _write_lvs_report(self):
+        lvs = []
+        for i in range(self._n_lvs):
+            vg = "vg%d" % (i % self.n_vgs)
+            lv = "lv%d" % (i // self.n_vgs)
+            lvs.append(self._lv_entry(vg, lv, 0))
+            if i % 10 == 0:
+                lvs.append(self._lv_entry(vg, lv, 1))
+
+        with open(os.path.join(self.fake_dir, "report.json"), "w") as f:
+            if self._compact:
+                json.dump({"report": [{"lv": lvs}]}, f)
+            else:
+                # the same layout as LVM uses -- one row per line
+                f.write("  {\n      \"report\": [\n          {\n              \"lv\": [\n")
+                f.write(",\n".join("                  " + json.dumps(lv, separators=(",", ":")) for lv in lvs))
+                f.write("\n              ]\n          }\n      ]\n      ,\n      \"log\": [\n      ]\n  }\n")
+
+    def _get_execs(self):
+        """LVM commands run by the fake tool so far"""
+        execs_log = os.path.join(self.fake_dir, "execs.log")
+        if not os.path.exists(execs_log):
+            return []
+        with open(execs_log, "r") as f:
+            return [line.strip() for line in f if line.strip()]
+
+    def _get_calls(self):
+        """Start and end times of the report calls of the fake tool so far"""
+        calls_log = os.path.join(self.fake_dir, "calls.log")
+        if not os.path.exists(calls_log):
+            return []
+        with open(calls_log, "r") as f:
+            return [tuple(float(t) for t in line.split()) for line in f if line.strip()]
+
+    def _write_vgs_report(self, seqno, missing_pvs=0):
+        """The VGs' versions are also reported for the LVs"""
+        self._vg_seqno = seqno
+        self._vg_missing_pvs = missing_pvs
+
+        vgs = [{"vg_name": "vg%d" % i, "vg_uuid": "vg%d-uuid" % i, "vg_seqno": seqno,
+                "vg_missing_pv_count": missing_pvs} for i in range(self.n_vgs)]
+        with open(os.path.join(self.fake_dir, "vgs.json"), "w") as f:
+            json.dump({"report": [{"vg": vgs}]}, f)
+        self._write_lvs_report()
+
+
+class LvmReportParserBenchmark(LvmFakeToolTestCase):
+    """Feeds synthetic reports with lots of LVs to the parser via a fake 'lvm' tool"""
+
+    def _parse_report(self, n_lvs, compact=False):
+        """Returns the times it took to get all the LVs and the LVs with their segments"""
+        self._write_report(n_lvs, compact)
+
+        with fake_path(self.fake_dir, keep_utils=["cat"]):
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+
+            start = time.monotonic()
+            lvs = BlockDev.lvm_lvs(None)
+            lvs_time = time.monotonic() - start
+
+            start = time.monotonic()
+            tree = BlockDev.lvm_lvs_tree(None)
+            tree_time = time.monotonic() - start
+
+        # LVs with the same name in different VGs are not duplicates
+        self.assertEqual(len(lvs), n_lvs)
+        self.assertEqual(len(tree), n_lvs)
+        self.assertEqual(len({(lv.vg_name, lv.lv_name) for lv in lvs}), n_lvs)
+
+        # multi-segment LVs are reported once with all their segments
+        segs = {(lv.vg_name, lv.lv_name): len(lv.segs) for lv in tree}
+        self.assertEqual(segs[("vg0", "lv0")], 2)
+        self.assertEqual(segs[("vg1", "lv0")], 1)
+        self.assertEqual(sum(segs.values()), n_lvs + (n_lvs + 9) // 10)
+
+        return lvs_time, tree_time
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.SLOW)
+    def test_parse_many_lvs(self):
+        """Verify that the time to parse a report grows linearly with the number of LVs"""
+        # best of two runs to rule out hiccups of the machine
+        small = [min(t) for t in zip(*(self._parse_report(10000) for _ in range(2)))]
+        big = [min(t) for t in zip(*(self._parse_report(50000) for _ in range(2)))]
+
+        # 5 times more LVs, linear growth means ~5 times more time, quadratic
+        # ~25 times more (tiny times of fast machines are rounded up)
+        for small_time, big_time in zip(small, big):
+            self.assertLess(big_time, 10 * max(small_time, 0.05))
+
+    @tag_test(TestTags.NOSTORAGE)
+    def test_parallel_queries(self):
+        """Verify that LVM queries from multiple threads run in parallel"""
+        self._write_report(10, delay=2)
+
+        results = []
+        def query():
+            results.append(len(BlockDev.lvm_lvs(None)))
+
+        with fake_path(self.fake_dir, keep_utils=["cat", "sleep", "date"]):
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+            calls_before = len(self._get_calls())
+
+            threads = [threading.Thread(target=query) for _ in range(4)]
+            for thread in threads:
+                thread.start()
+            for thread in threads:
+                thread.join()
+
+        self.assertEqual(results, [10] * 4)
+
+        # all the four calls of the tool were running at the same time: the
+        # last one started before the first one ended
+        calls = self._get_calls()[calls_before:]
+        self.assertEqual(len(calls), 4)
+        self.assertLess(max(start for start, _end in calls), min(end for _start, end in calls))
+
+    @tag_test(TestTags.NOSTORAGE)
+    def test_parse_compact_report(self):
+        """Verify that a report not split into lines is parsed too"""
+        self._parse_report(100, compact=True)
+
+
+class LvmMetadataCacheTest(LvmFakeToolTestCase):
+    """Checks the metadata cache with a fake 'lvm' tool"""
+
+    def setUp(self):
+        super(LvmMetadataCacheTest, self).setUp()
+        self.addCleanup(BlockDev.lvm_set_metadata_cache, False)
+
+    def _check_stats(self, hits, misses):
+        stats = BlockDev.lvm_metadata_cache_get_stats()
+        self.assertEqual((stats.hits, stats.misses), (hits, misses))
+
+    def _check_execs(self, execs):
+        """Check the LVM commands run since the last check"""
+        all_execs = self._get_execs()
+        self.assertEqual(all_execs[self._n_execs:], execs)
+        self._n_execs = len(all_execs)
+
+    def _wait_probe_ttl(self):
+        """The VGs' versions are only checked again after a second"""
+        time.sleep(1.1)
+
+    @tag_test(TestTags.NOSTORAGE)
+    def test_metadata_cache(self):
+        """Verify that the metadata cache is used and validated"""
+        self._write_report(100)
+
+        with fake_path(self.fake_dir, keep_utils=["cat", "sleep"]):
+            self.assertTrue(BlockDev.reinit(self.requested_plugins, True, None))
+            self.assertTrue(BlockDev.lvm_set_metadata_cache(True))
+            self._check_stats(0, 0)
+            # ignore whatever was run by the plugin initialization
+            self._n_execs = len(self._get_execs())
+
+            # nothing cached, no need to check the versions
+            lvs = BlockDev.lvm_lvs(None)
+            self.assertEqual(len(lvs), 100)
+            self._check_stats(0, 1)
+            self._check_execs(["lvs"])
+
+            # nothing changed, answered from the cache
+            lvs = BlockDev.lvm_lvs(None)
+            self.assertEqual(len(lvs), 100)
+            self._check_stats(1, 1)
+            self._check_execs(["vgs"])
+
+            # polling the LVs only needs the one check of the versions above
+            for i in range(10):
+                lv = BlockDev.lvm_lvinfo("vg%d" % i, "lv5")
+                self.assertEqual(lv.lv_name, "lv5")
+                self.assertEqual(lv.vg_name, "vg%d" % i)
+            self._check_stats(11, 1)
+            self._check_execs([])
+
+            # metadata of the VGs changed
+            self._write_vgs_report(2)
+            self._wait_probe_ttl()
+            lvs = BlockDev.lvm_lvs(None)
+            self.assertEqual(len(lvs), 100)
+            self._check_stats(11, 2)
+            self._check_execs(["vgs", "lvs"])
+            lvs = BlockDev.lvm_lvs("vg3")
+            self._check_stats(12, 2)
+            self._check_execs([])
+
+            # a PV went missing (no change of the metadata)
+            self._write_vgs_report(2, missing_pvs=1)
+            self._wait_probe_ttl()
+            lvs = BlockDev.lvm_lvs("vg3")
+            self._check_stats(12, 3)
+            self._check_execs(["vgs", "lvs"])
+            lvs = BlockDev.lvm_lvs("vg3")
+            self._check_stats(13, 3)
+            self._check_execs([])
+            self._write_vgs_report(2)
+            self._wait_probe_ttl()
+            lvs = BlockDev.lvm_lvs(None)
+            self._check_stats(13, 4)
+            self._check_execs(["vgs", "lvs"])
+
+            # explicitly dropped, nothing cached for the VG
+            self.assertTrue(BlockDev.lvm_metadata_cache_invalidate("vg3"))
+            lvs = BlockDev.lvm_lvs("vg3")
+            self._check_stats(13, 5)
+            self._check_execs(["lvs"])
+            lvs = BlockDev.lvm_lvs("vg4")
+            self._check_stats(14, 5)
+            self._check_execs(["vgs"])
+
+            # LVM may report different things with a different global config
+            self.assertTrue(BlockDev.lvm_set_global_config("backup {backup=0}"))
+            self.addCleanup(BlockDev.lvm_set_global_config, None)
+            lvs = BlockDev.lvm_lvs("vg4")
+            self._check_stats(14, 6)
+            self._check_execs(["lvs"])
+
+            # disabled
+            self.assertTrue(BlockDev.lvm_set_metadata_cache(False))
+            lvs = BlockDev.lvm_lvs(None)
+            self.assertEqual(len(lvs), 100)
+            self._check_stats(14, 6)
+            self._check_execs(["lvs"])
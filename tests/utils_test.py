@@ -2,13 +2,19 @@ import unittest
 import re
 import os
 import glob
+import shutil
+import tempfile
+import time
+import signal
+import ctypes
 import overrides_hack
 from utils import fake_utils, create_sparse_tempfile, create_lio_device, delete_lio_device, run_command, TestTags, tag_test, read_file
 
 import gi
 gi.require_version('GLib', '2.0')
 gi.require_version('BlockDev', '3.0')
-from gi.repository import GLib, BlockDev
+gi.require_version('Gio', '2.0')
+from gi.repository import GLib, Gio, BlockDev
 
 
 class UtilsTestCase(unittest.TestCase):
@@ -143,6 +149,87 @@ class UtilsExecLoggingTest(UtilsTestCase):
         BlockDev.utils_log(BlockDev.UTILS_LOG_INFO, "info message")
         self.assertIn("info message", self.log)
 
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_log_enabled(self):
+        """Verify that checking whether messages would be logged works"""
+
+        succ = BlockDev.utils_init_logging(self.my_log_func)
+        self.assertTrue(succ)
+
+        self.assertTrue(BlockDev.utils_log_enabled(BlockDev.UTILS_LOG_WARNING))
+        self.assertFalse(BlockDev.utils_log_enabled(BlockDev.UTILS_LOG_INFO))
+
+        BlockDev.utils_set_log_level(BlockDev.UTILS_LOG_INFO)
+        self.assertTrue(BlockDev.utils_log_enabled(BlockDev.UTILS_LOG_INFO))
+
+        # no log function -> nothing is logged
+        succ = BlockDev.utils_init_logging(None)
+        self.assertTrue(succ)
+        self.assertFalse(BlockDev.utils_log_enabled(BlockDev.UTILS_LOG_EMERG))
+
+        # nothing logged for the exec calls either
+        succ, out = BlockDev.utils_exec_and_capture_output(["echo", "hi"])
+        self.assertTrue(succ)
+        self.assertFalse(self.log)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_logging(self):
+        """Verify that structured exec logging works as expected"""
+
+        entries = []
+
+        def exec_log_func(task_id, argv, exit_status, spawn_time, wall_time):
+            entries.append((task_id, argv, exit_status, spawn_time, wall_time))
+
+        succ = BlockDev.utils_init_exec_logging(exec_log_func)
+        self.assertTrue(succ)
+        self.addCleanup(BlockDev.utils_init_exec_logging, None)
+
+        # called even with no "normal" log function
+        succ = BlockDev.utils_init_logging(None)
+        self.assertTrue(succ)
+
+        succ = BlockDev.utils_exec_and_report_error(["sleep", "0.1"])
+        self.assertTrue(succ)
+
+        with self.assertRaises(GLib.GError):
+            BlockDev.utils_exec_and_report_error(["false"])
+
+        succ, _out, _err, status = BlockDev.utils_exec_and_capture_output_no_progress(["false"])
+        self.assertTrue(succ)
+
+        self.assertEqual(len(entries), 3)
+
+        task_id, argv, exit_status, spawn_time, wall_time = entries[0]
+        self.assertGreater(task_id, 0)
+        self.assertEqual(argv, ["sleep", "0.1"])
+        self.assertEqual(exit_status, 0)
+        self.assertGreaterEqual(spawn_time, 0)
+        self.assertGreaterEqual(wall_time, 100000)
+        self.assertLessEqual(spawn_time, wall_time)
+
+        self.assertEqual(entries[1][1], ["false"])
+        self.assertEqual(entries[1][2], 1)
+        self.assertGreater(entries[1][0], task_id)
+
+        # spawn time is not known for the "no progress" functions
+        self.assertEqual(entries[2][2], 1)
+        self.assertEqual(entries[2][3], -1)
+
+        # processes that failed to start are logged too
+        with self.assertRaises(GLib.GError):
+            BlockDev.utils_exec_and_report_error(["/non/existing/binary"])
+        self.assertEqual(len(entries), 4)
+        self.assertEqual(entries[3][1], ["/non/existing/binary"])
+        self.assertEqual(entries[3][2], -1)
+        self.assertEqual(entries[3][3], -1)
+
+        # disabled -> no more calls
+        succ = BlockDev.utils_init_exec_logging(None)
+        self.assertTrue(succ)
+        succ = BlockDev.utils_exec_and_report_error(["true"])
+        self.assertEqual(len(entries), 4)
+
     @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
     def test_version_cmp(self):
         """Verify that version comparison works as expected"""
@@ -220,6 +307,90 @@ class UtilsExecLoggingTest(UtilsTestCase):
             # exit code != 0
             self.assertTrue(BlockDev.utils_check_util_version("libblockdev-fake-util-fail", "1.1", "version", "Version:\\s(.*)"))
 
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_util_feature(self):
+        """Verify that checking utility features works as expected"""
+
+        with self.assertRaises(GLib.GError):
+            BlockDev.utils_check_util_feature("libblockdev-fake-util", "1.2", "", None)
+
+        with fake_utils("tests/fake_utils/utils_fake_util/"):
+            self.assertTrue(BlockDev.utils_check_util_feature("libblockdev-fake-util", "1.2", "", "Version:\\s(.*)"))
+            self.assertTrue(BlockDev.utils_check_util_feature("libblockdev-fake-util", "Version", "version", None))
+
+            with self.assertRaisesRegex(GLib.GError, "Required feature 1.2 not supported"):
+                BlockDev.utils_check_util_feature("libblockdev-fake-util", "1.2", "version", "Version:\\s(.*)")
+
+            with self.assertRaisesRegex(GLib.GError, "Failed to determine"):
+                BlockDev.utils_check_util_feature("libblockdev-fake-util", "1.2", "version", "Features:\\s(.*)")
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_util_info_cache(self):
+        """Verify that results of the utility checks are cached and invalidated"""
+
+        tmpdir = tempfile.mkdtemp(prefix="libblockdev-utils-cache-")
+        self.addCleanup(shutil.rmtree, tmpdir)
+        util = os.path.join(tmpdir, "libblockdev-fake-util")
+        shutil.copy("tests/fake_utils/utils_fake_util/libblockdev-fake-util", util)
+
+        with fake_utils(tmpdir):
+            self.assertTrue(BlockDev.utils_check_util_version("libblockdev-fake-util", "1.2", "", "Version:\\s(.*)"))
+
+            # change the reported version without changing size and mtime of the util
+            # so the cached result is used
+            st = os.stat(util)
+            with open(util, "r") as f:
+                script = f.read()
+            with open(util, "w") as f:
+                f.write(script.replace("Version: 1.2", "Version: 1.3"))
+            os.utime(util, ns=(st.st_atime_ns, st.st_mtime_ns))
+
+            with self.assertRaises(GLib.GError):
+                BlockDev.utils_check_util_version("libblockdev-fake-util", "1.3", "", "Version:\\s(.*)")
+
+            # no cached result after flushing the cache
+            self.assertTrue(BlockDev.utils_flush_util_info_cache())
+            self.assertTrue(BlockDev.utils_check_util_version("libblockdev-fake-util", "1.3", "", "Version:\\s(.*)"))
+
+            # changed util invalidates its entry
+            with open(util, "w") as f:
+                f.write(script.replace("Version: 1.2", "Version: 1.4.1"))
+            self.assertTrue(BlockDev.utils_check_util_version("libblockdev-fake-util", "1.4.1", "", "Version:\\s(.*)"))
+
+            # the cache is only readable by the user
+            cache_dir = os.path.join(GLib.get_user_runtime_dir(), "libblockdev-utils")
+            cache_files = os.listdir(cache_dir)
+            self.assertTrue(cache_files)
+            for cache_file in cache_files:
+                self.assertEqual(os.stat(os.path.join(cache_dir, cache_file)).st_mode & 0o777, 0o600)
+
+            # output on stderr with a non-zero exit code is cached too
+            self.assertTrue(BlockDev.utils_flush_util_info_cache())
+            with open(util, "w") as f:
+                f.write("#!/bin/bash\necho 'Version: 1.2' >&2\nexit 1\n")
+            st = os.stat(util)
+            self.assertTrue(BlockDev.utils_check_util_version("libblockdev-fake-util", "1.2", "", "Version:\\s(.*)"))
+            self.assertEqual(len(os.listdir(cache_dir)), 1)
+            with open(util, "w") as f:
+                f.write("#!/bin/bash\necho 'Version: 1.0' >&2\nexit 1\n")
+            os.utime(util, ns=(st.st_atime_ns, st.st_mtime_ns))
+            self.assertTrue(BlockDev.utils_check_util_version("libblockdev-fake-util", "1.2", "", "Version:\\s(.*)"))
+
+            # failures to run the util are not cached
+            self.assertTrue(BlockDev.utils_flush_util_info_cache())
+            with open(util, "w") as f:
+                f.write("#!/nonexistent/interpreter\n")
+            with self.assertRaises(GLib.GError):
+                BlockDev.utils_check_util_version("libblockdev-fake-util", "1.2", "", "Version:\\s(.*)")
+            self.assertFalse(os.path.exists(cache_dir) and os.listdir(cache_dir))
+
+            # neither are runs killed with a signal
+            with open(util, "w") as f:
+                f.write("#!/bin/bash\necho 'Version: 1.2' >&2\nkill -9 $$\n")
+            with self.assertRaises(GLib.GError):
+                BlockDev.utils_check_util_version("libblockdev-fake-util", "1.2", "", "Version:\\s(.*)")
+            self.assertFalse(os.path.exists(cache_dir) and os.listdir(cache_dir))
+
     @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
     def test_exec_locale(self):
         """Verify that setting locale for exec functions works as expected"""
@@ -405,6 +576,300 @@ class UtilsExecLoggingTest(UtilsTestCase):
         status = BlockDev.utils_exec_with_input(["grep", DATA_MATCH], data, None)
         self.assertTrue(status)
 
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_env_change(self):
+        """Verify that changes of the environment are propagated to the spawned processes"""
+
+        self.addCleanup(os.environ.pop, "LIBBLOCKDEV_TEST_VAR", None)
+
+        os.environ["LIBBLOCKDEV_TEST_VAR"] = "first"
+        succ, out = BlockDev.utils_exec_and_capture_output(["printenv", "LIBBLOCKDEV_TEST_VAR"])
+        self.assertTrue(succ)
+        self.assertEqual(out, "first\n")
+
+        os.environ["LIBBLOCKDEV_TEST_VAR"] = "second"
+        succ, out = BlockDev.utils_exec_and_capture_output(["printenv", "LIBBLOCKDEV_TEST_VAR"])
+        self.assertTrue(succ)
+        self.assertEqual(out, "second\n")
+
+        del os.environ["LIBBLOCKDEV_TEST_VAR"]
+        with self.assertRaisesRegex(GLib.GError, r"Process reported exit code 1"):
+            BlockDev.utils_exec_and_capture_output(["printenv", "LIBBLOCKDEV_TEST_VAR"])
+
+        # putenv() puts the given string into the environment, changing it in
+        # place changes the environment too
+        libc = ctypes.CDLL(None)
+        var = ctypes.create_string_buffer(b"LIBBLOCKDEV_TEST_VAR=third")
+        self.assertEqual(libc.putenv(var), 0)
+        try:
+            succ, out = BlockDev.utils_exec_and_capture_output(["printenv", "LIBBLOCKDEV_TEST_VAR"])
+            self.assertTrue(succ)
+            self.assertEqual(out, "third\n")
+
+            var.value = b"LIBBLOCKDEV_TEST_VAR=other"
+            succ, out = BlockDev.utils_exec_and_capture_output(["printenv", "LIBBLOCKDEV_TEST_VAR"])
+            self.assertTrue(succ)
+            self.assertEqual(out, "other\n")
+        finally:
+            # the buffer must not be freed while it's still in the environment
+            libc.unsetenv(b"LIBBLOCKDEV_TEST_VAR")
+
+        with self.assertRaisesRegex(GLib.GError, r"Failed to execute child process"):
+            BlockDev.utils_exec_and_report_error(["libblockdev-nonexistent-util"])
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_spawn(self):
+        """Verify that the spawned processes get the right stdin, stdout and stderr"""
+
+        # stdout and stderr are read separately
+        succ, out = BlockDev.utils_exec_and_capture_output(["sh", "-c", "echo out; echo err >&2"])
+        self.assertTrue(succ)
+        self.assertEqual(out, "out\n")
+
+        # exit code is reported together with stderr
+        with self.assertRaisesRegex(GLib.GError, r"Process reported exit code 3: err"):
+            BlockDev.utils_exec_and_report_error(["sh", "-c", "echo out; echo err >&2; exit 3"])
+
+        # stdin is /dev/null unless some input is given (same as with g_spawn_*())
+        succ, out = BlockDev.utils_exec_and_capture_output(["readlink", "/proc/self/fd/0"])
+        self.assertTrue(succ)
+        self.assertEqual(out, "/dev/null\n")
+
+        succ = BlockDev.utils_exec_with_input(["grep", "-q", "input"], "some input\n", None)
+        self.assertTrue(succ)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.SLOW)
+    def test_exec_spawn_latency(self):
+        """Compare spawn latency of the exec functions with plain g_spawn_async_with_pipes"""
+
+        runs = 500
+
+        def glib_spawn():
+            # spawn the same way the exec functions used to -- building the
+            # environment and going through g_spawn_async_with_pipes
+            env = GLib.environ_setenv(GLib.get_environ(), "LC_ALL", "C.UTF-8", True)
+            env = GLib.environ_unsetenv(env, "LANGUAGE")
+            _succ, pid, _in_fd, out_fd, err_fd = GLib.spawn_async_with_pipes(None, ["true"], env,
+                                                                             GLib.SpawnFlags.SEARCH_PATH | GLib.SpawnFlags.DO_NOT_REAP_CHILD,
+                                                                             None, None)
+            os.close(out_fd)
+            os.close(err_fd)
+            os.waitpid(pid, 0)
+
+        def bd_spawn():
+            self.assertTrue(BlockDev.utils_exec_and_report_error(["true"]))
+
+        def measure(spawn):
+            start = time.monotonic()
+            for _i in range(runs):
+                spawn()
+            return (time.monotonic() - start) / runs
+
+        # best of two rounds to rule out hiccups of the machine
+        glib_time = min(measure(glib_spawn) for _ in range(2))
+        bd_time = min(measure(bd_spawn) for _ in range(2))
+
+        # the exec functions also log, poll the outputs and collect statistics,
+        # but they shouldn't be significantly slower than a plain spawn
+        self.assertLess(bd_time, 3 * glib_time + 0.001,
+                        "spawn latency: g_spawn %.3f ms, libblockdev exec %.3f ms" % (glib_time * 1000, bd_time * 1000))
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_signals_reset(self):
+        """Verify that the spawned processes don't inherit blocked or ignored signals"""
+
+        # Python itself ignores SIGPIPE
+        old_mask = signal.pthread_sigmask(signal.SIG_BLOCK, [signal.SIGUSR1])
+        self.addCleanup(signal.pthread_sigmask, signal.SIG_SETMASK, old_mask)
+
+        succ, out = BlockDev.utils_exec_and_capture_output(["grep", "-E", "^Sig(Blk|Ign)", "/proc/self/status"])
+        self.assertTrue(succ)
+        masks = dict(line.split(":") for line in out.splitlines())
+        self.assertEqual(int(masks["SigBlk"], 16), 0)
+        self.assertEqual(int(masks["SigIgn"], 16), 0)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_stats(self):
+        """Verify that statistics of the executed processes are collected"""
+
+        BlockDev.utils_reset_exec_stats()
+        self.assertEqual(BlockDev.utils_get_exec_stats(), [])
+
+        for _i in range(3):
+            succ, out = BlockDev.utils_exec_and_capture_output(["echo", "hello"])
+            self.assertTrue(succ)
+        with self.assertRaises(GLib.GError):
+            BlockDev.utils_exec_and_report_error(["/bin/false"])
+        succ = BlockDev.utils_exec_and_report_error(["sleep", "0.1"])
+        self.assertTrue(succ)
+        # processes killed by a signal are counted too
+        with self.assertRaises(GLib.GError):
+            BlockDev.utils_exec_and_report_error(["sh", "-c", "kill -9 $$"])
+
+        stats = {st.util: st for st in BlockDev.utils_get_exec_stats()}
+
+        self.assertEqual(stats["echo"].count, 3)
+        self.assertEqual(stats["echo"].failed, 0)
+        self.assertEqual(stats["echo"].bytes, 3 * len("hello\n"))
+        self.assertEqual(stats["echo"].spawn_count, 3)
+        self.assertEqual(stats["echo"].first_output_count, 3)
+        self.assertEqual(sum(stats["echo"].histogram), 3)
+
+        # utilities are identified by the basename
+        self.assertEqual(stats["false"].count, 1)
+        self.assertEqual(stats["false"].failed, 1)
+
+        self.assertEqual(stats["sh"].count, 1)
+        self.assertEqual(stats["sh"].failed, 1)
+
+        self.assertEqual(stats["sleep"].count, 1)
+        self.assertGreaterEqual(stats["sleep"].wall_time, 100000)
+        self.assertEqual(stats["sleep"].max_wall_time, stats["sleep"].wall_time)
+        self.assertEqual(stats["sleep"].first_output_count, 0)
+        # 100 ms or more -- not in the buckets for less than 64 ms
+        self.assertEqual(sum(stats["sleep"].histogram[7:]), 1)
+
+        BlockDev.utils_reset_exec_stats()
+        self.assertEqual(BlockDev.utils_get_exec_stats(), [])
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_and_stream_lines(self):
+        """Verify that output lines are streamed to the callback"""
+
+        lines = []
+
+        def line_func(line, is_stderr, _data):
+            lines.append((line, is_stderr))
+            # retain only the even numbers
+            return int(line) % 2 == 0
+
+        succ, out = BlockDev.utils_exec_and_stream_lines(["sh", "-c", "seq 1 1000; echo 1001 >&2"], None, line_func, None, 0)
+        self.assertTrue(succ)
+        self.assertEqual(len(lines), 1001)
+        self.assertEqual(lines[0], ("1\n", False))
+        self.assertEqual(lines[-1], ("1001\n", True))
+        self.assertEqual(out, "".join("%d\n" % i for i in range(2, 1001, 2)))
+
+        # only 10 bytes retained, all the lines still processed
+        lines.clear()
+        succ, out = BlockDev.utils_exec_and_stream_lines(["seq", "1", "1000"], None, line_func, None, 10)
+        self.assertTrue(succ)
+        self.assertEqual(len(lines), 1000)
+        self.assertEqual(out, "2\n4\n6\n8\n[output truncated]\n")
+
+        # nothing retained after the first line over the limit (even if the
+        # following lines would fit), no line function needed
+        succ, out = BlockDev.utils_exec_and_stream_lines(["printf", "1\\n123456789\\n2\\n"], None, None, None, 10)
+        self.assertTrue(succ)
+        self.assertEqual(out, "1\n[output truncated]\n")
+
+        # errors are reported with the retained output after all the lines
+        # are delivered
+        lines.clear()
+        with self.assertRaisesRegex(GLib.GError, "Process reported exit code 1: 42\n"):
+            BlockDev.utils_exec_and_stream_lines(["sh", "-c", "echo 41; echo 42; echo 43 >&2; exit 1"], None, line_func, None, 0)
+        self.assertEqual(lines, [("41\n", False), ("42\n", False), ("43\n", True)])
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_batch(self):
+        """Verify that batches of processes are run in parallel"""
+
+        jobs = [BlockDev.UtilsExecJob.new(["sh", "-c", "sleep 0.5; echo %d" % i], None) for i in range(8)]
+        start = time.monotonic()
+        succ = BlockDev.utils_exec_batch(jobs, 4)
+        self.assertTrue(succ)
+        # two rounds of 4 parallel processes
+        self.assertLess(time.monotonic() - start, 3)
+        for i, job in enumerate(jobs):
+            self.assertTrue(job.success)
+            self.assertEqual(job.status, 0)
+            self.assertEqual(job.stdout_data, "%d\n" % i)
+            self.assertIsNone(job.error_msg)
+
+        # extra args are appended, failures don't stop the other jobs
+        jobs = [BlockDev.UtilsExecJob.new(["echo", "hello"], [BlockDev.ExtraArg.new("world", "")]),
+                BlockDev.UtilsExecJob.new(["sh", "-c", "echo failed >&2; exit 3"], None),
+                BlockDev.UtilsExecJob.new(["/non/existing/binary"], None),
+                BlockDev.UtilsExecJob.new(["echo", "bye"], None)]
+        with self.assertRaisesRegex(GLib.GError, "2 of 4 processes failed"):
+            BlockDev.utils_exec_batch(jobs, 0)
+
+        self.assertTrue(jobs[0].success)
+        self.assertEqual(jobs[0].stdout_data, "hello world\n")
+        self.assertFalse(jobs[1].success)
+        self.assertEqual(jobs[1].status, 3)
+        self.assertEqual(jobs[1].stderr_data, "failed\n")
+        self.assertIn("Process reported exit code 3", jobs[1].error_msg)
+        self.assertFalse(jobs[2].success)
+        self.assertEqual(jobs[2].status, -1)
+        self.assertTrue(jobs[3].success)
+        self.assertEqual(jobs[3].stdout_data, "bye\n")
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_async(self):
+        """Verify that processes can be run asynchronously"""
+
+        loop = GLib.MainLoop()
+        results = {}
+
+        def done(_source, result, num):
+            results[num] = BlockDev.utils_exec_async_finish(result)
+            if len(results) == 10:
+                loop.quit()
+
+        for i in range(10):
+            BlockDev.utils_exec_async(["sh", "-c", "sleep 0.1; echo %d" % i], None, None, None, done, i)
+        GLib.timeout_add_seconds(10, loop.quit)
+        loop.run()
+
+        self.assertEqual(len(results), 10)
+        for i in range(10):
+            succ, status, out, _err = results[i]
+            self.assertTrue(succ)
+            self.assertEqual(status, 0)
+            self.assertEqual(out, "%d\n" % i)
+
+        # errors are reported by the finish function
+        results.clear()
+
+        def failed(_source, result, _data):
+            try:
+                BlockDev.utils_exec_async_finish(result)
+            except GLib.GError as e:
+                results["error"] = e
+            loop.quit()
+
+        BlockDev.utils_exec_async(["false"], None, None, None, failed, None)
+        loop.run()
+        self.assertIn("Process reported exit code 1", results["error"].message)
+
+        with self.assertRaises(GLib.GError):
+            BlockDev.utils_exec_async_set_max_threads(0)
+        self.assertTrue(BlockDev.utils_exec_async_set_max_threads(8))
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_exec_async_cancel(self):
+        """Verify that cancelling an asynchronous process kills it"""
+
+        loop = GLib.MainLoop()
+        cancellable = Gio.Cancellable()
+        results = {}
+
+        def done(_source, result, _data):
+            try:
+                BlockDev.utils_exec_async_finish(result)
+            except GLib.GError as e:
+                results["error"] = e
+            loop.quit()
+
+        start = time.monotonic()
+        BlockDev.utils_exec_async(["sleep", "10"], None, None, cancellable, done, None)
+        GLib.timeout_add(100, lambda: cancellable.cancel() and False)
+        loop.run()
+
+        self.assertLess(time.monotonic() - start, 5)
+        self.assertTrue(results["error"].matches(Gio.io_error_quark(), Gio.IOErrorEnum.CANCELLED))
+
 
 class UtilsStorageTestCase(UtilsTestCase):
     def setUp(self):
@@ -496,6 +961,65 @@ class UtilsDevUtilsSymlinksTestCase(UtilsStorageTestCase):
         self.assertGreaterEqual(len(symlinks), 4)
 
 
+class UtilsDevWaitTest(UtilsTestCase):
+    """Tests for the BDUtilsDevWait helper (not introspectable, used via ctypes)"""
+
+    def setUp(self):
+        # already loaded by the BlockDev module
+        self.libutils = ctypes.CDLL("libbd_utils.so.3")
+        self.libutils.bd_utils_dev_wait_new.restype = ctypes.c_void_p
+        self.libutils.bd_utils_dev_wait_new.argtypes = [ctypes.c_char_p, ctypes.c_uint]
+        self.libutils.bd_utils_dev_wait_next.restype = ctypes.c_int
+        self.libutils.bd_utils_dev_wait_next.argtypes = [ctypes.c_void_p]
+        self.libutils.bd_utils_dev_wait_free.restype = None
+        self.libutils.bd_utils_dev_wait_free.argtypes = [ctypes.c_void_p]
+
+    def _wait_for(self, attempts_needed, timeout):
+        """Simulate an operation that succeeds on the @attempts_needed-th attempt"""
+
+        wait = self.libutils.bd_utils_dev_wait_new(b"/dev/null", timeout)
+        self.addCleanup(self.libutils.bd_utils_dev_wait_free, wait)
+
+        attempts = 0
+        start = time.monotonic()
+        while True:
+            attempts += 1
+            if attempts == attempts_needed:
+                return (True, attempts, time.monotonic() - start)
+            if not self.libutils.bd_utils_dev_wait_next(wait):
+                return (False, attempts, time.monotonic() - start)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_dev_wait_timeout(self):
+        """Verify that waiting for a device gives up after the timeout"""
+
+        succ, attempts, duration = self._wait_for(-1, 300)
+        self.assertFalse(succ)
+        self.assertGreaterEqual(duration, 0.3)
+        # the last delay is cut at the deadline
+        self.assertLess(duration, 1.0)
+        # exponential backoff: 10 + 20 + 40 + 80 + 150 ms
+        self.assertGreaterEqual(attempts, 4)
+        self.assertLessEqual(attempts, 7)
+
+    @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
+    def test_dev_wait_early_success(self):
+        """Verify that waiting for a device stops as soon as the operation succeeds"""
+
+        # success on the first attempt, no waiting at all
+        succ, attempts, duration = self._wait_for(1, 2000)
+        self.assertTrue(succ)
+        self.assertEqual(attempts, 1)
+        self.assertLess(duration, 0.1)
+
+        # success on the third attempt, only the first two delays (10 + 20 ms)
+        succ, attempts, duration = self._wait_for(3, 2000)
+        self.assertTrue(succ)
+        self.assertEqual(attempts, 3)
+        self.assertGreaterEqual(duration, 0.03)
+        self.assertLess(duration, 1.0)
+
+
 class UtilsLinuxKernelVersionTest(UtilsTestCase):
     @tag_test(TestTags.NOSTORAGE, TestTags.CORE)
     def test_kernel_version(self):
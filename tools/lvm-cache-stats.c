@@ -9,11 +9,16 @@
 
 void print_usage (const char *cmd) {
     fprintf (stderr,
-             "Usage: %s CACHED_LV [CACHED_LV2...]\n"
-             "-h    --help   Print this usage info\n"
-             "-j    --json   Print stats as JSON\n"
-             "Options need to be specified before LVs.\n",
-             cmd);
+             "Usage: %s [-j] CACHED_LV [CACHED_LV2...]\n"
+             "       %s [-j] -i INTERVAL [-c COUNT] [CACHED_LV...]\n"
+             "-h    --help       Print this usage info\n"
+             "-j    --json       Print stats as JSON\n"
+             "-i    --interval   Print stats for all (or the given) cached LVs every INTERVAL seconds\n"
+             "-c    --count      Stop after COUNT intervals (default: run until interrupted)\n"
+             "Options need to be specified before LVs.\n"
+             "With an interval, hits, misses, promotions and demotions are reported for the\n"
+             "last interval and the dirty data change since the previous interval is reported.\n",
+             cmd, cmd);
 }
 
 void print_size (guint64 bytes, gboolean newline) {
@@ -67,7 +72,7 @@ gboolean print_lv_stats_json(const char *vg_name, const char *lv_name, GError **
     printf ("  \"lv-size\": %"G_GUINT64_FORMAT",\n", lv_data->size);
     printf ("  \"cache-size\": %"G_GUINT64_FORMAT",\n", stats->cache_size);
     printf ("  \"cache-size-pct\": %0.2f,\n", (double) stats->cache_size / lv_data->size);
-    printf ("  \"cache-used\": %"G_GUINT64_FORMAT",\n", stats->cache_size);
+    printf ("  \"cache-used\": %"G_GUINT64_FORMAT",\n", stats->cache_used);
     printf ("  \"cache-used-pct\": %0.2f,\n", (double) stats->cache_used / stats->cache_size);
     printf ("  \"read-misses\": %"G_GUINT64_FORMAT",\n", stats->read_misses);
     printf ("  \"read-hits\": %"G_GUINT64_FORMAT",\n", stats->read_hits);
@@ -83,6 +88,199 @@ gboolean print_lv_stats_json(const char *vg_name, const char *lv_name, GError **
     return TRUE;
 }
 
+/* counters are reset when the cache is re-activated */
+guint64 counter_delta (guint64 prev, guint64 cur) {
+    return cur >= prev ? cur - prev : cur;
+}
+
+double ratio (guint64 part, guint64 total) {
+    return total > 0 ? (double) part / total : 0.0;
+}
+
+gboolean lv_spec_listed (char **lv_specs, const char *lv_spec) {
+    for (char **spec = lv_specs; *spec; spec++)
+        if (g_strcmp0 (*spec, lv_spec) == 0)
+            return TRUE;
+    return FALSE;
+}
+
+/* takes over the stats of the LVs */
+GHashTable* sample_lvs (BDLVMCachedLVStats **all, char **lv_specs) {
+    GHashTable *ret = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) bd_lvm_cache_stats_free);
+    char *lv_spec = NULL;
+
+    for (BDLVMCachedLVStats **entry = all; *entry; entry++) {
+        lv_spec = g_strdup_printf ("%s/%s", (*entry)->vg_name, (*entry)->lv_name);
+        if (!lv_specs || lv_spec_listed (lv_specs, lv_spec)) {
+            g_hash_table_insert (ret, lv_spec, (*entry)->stats);
+            (*entry)->stats = NULL;
+        } else
+            g_free (lv_spec);
+        bd_lvm_cached_lv_stats_free (*entry);
+    }
+    g_free (all);
+
+    return ret;
+}
+
+void print_interval_header (double interval) {
+    GDateTime *now = g_date_time_new_now_local ();
+    char *now_str = g_date_time_format (now, "%T");
+
+    printf ("%s (%.1f s)\n", now_str, interval);
+    printf ("%-24s %-12s %9s %12s %12s %8s %8s %10s %10s %8s %8s\n",
+            "LV", "mode", "used", "dirty", "dirty chg", "rd hit", "wr hit",
+            "reads/s", "writes/s", "promo/s", "demo/s");
+
+    g_free (now_str);
+    g_date_time_unref (now);
+}
+
+void print_interval_stats (const char *lv_spec, const BDLVMCacheStats *prev, const BDLVMCacheStats *cur, double interval) {
+    guint64 read_hits = counter_delta (prev->read_hits, cur->read_hits);
+    guint64 reads = read_hits + counter_delta (prev->read_misses, cur->read_misses);
+    guint64 write_hits = counter_delta (prev->write_hits, cur->write_hits);
+    guint64 writes = write_hits + counter_delta (prev->write_misses, cur->write_misses);
+    gint64 dirty_change = (gint64) cur->dirty - (gint64) prev->dirty;
+    BSSize size = bs_size_new_from_bytes (cur->dirty, 1);
+    char *dirty_str = bs_size_human_readable (size, BS_BUNIT_MiB, 2, true);
+    char *dirty_change_str = NULL;
+    char *signed_change_str = NULL;
+
+    bs_size_free (size);
+    size = bs_size_new_from_bytes (dirty_change >= 0 ? dirty_change : -dirty_change, 1);
+    dirty_change_str = bs_size_human_readable (size, BS_BUNIT_MiB, 2, true);
+    bs_size_free (size);
+    signed_change_str = g_strdup_printf ("%c%s", dirty_change >= 0 ? '+' : '-', dirty_change_str);
+
+    printf ("%-24s %-12s %8.2f%% %12s %12s %7.2f%% %7.2f%% %10.1f %10.1f %8.1f %8.1f\n",
+            lv_spec, bd_lvm_cache_get_mode_str (cur->mode, NULL),
+            ratio (cur->cache_used, cur->cache_size) * 100, dirty_str, signed_change_str,
+            ratio (read_hits, reads) * 100, ratio (write_hits, writes) * 100,
+            reads / interval, writes / interval,
+            counter_delta (prev->promotions, cur->promotions) / interval,
+            counter_delta (prev->demotions, cur->demotions) / interval);
+
+    free (dirty_str);
+    free (dirty_change_str);
+    g_free (signed_change_str);
+}
+
+void print_interval_stats_json (const char *lv_spec, const BDLVMCacheStats *prev, const BDLVMCacheStats *cur, gboolean first) {
+    guint64 read_hits = counter_delta (prev->read_hits, cur->read_hits);
+    guint64 read_misses = counter_delta (prev->read_misses, cur->read_misses);
+    guint64 write_hits = counter_delta (prev->write_hits, cur->write_hits);
+    guint64 write_misses = counter_delta (prev->write_misses, cur->write_misses);
+
+    /* one line per interval so that the output is easy to consume as a stream */
+    printf ("%s{\"lv\": \"%s\", \"mode\": \"%s\"", first ? "" : ", ", lv_spec, bd_lvm_cache_get_mode_str (cur->mode, NULL));
+    printf (", \"cache-size\": %"G_GUINT64_FORMAT", \"cache-used\": %"G_GUINT64_FORMAT", \"cache-used-pct\": %0.2f",
+            cur->cache_size, cur->cache_used, ratio (cur->cache_used, cur->cache_size));
+    printf (", \"dirty\": %"G_GUINT64_FORMAT", \"dirty-change\": %"G_GINT64_FORMAT,
+            cur->dirty, (gint64) cur->dirty - (gint64) prev->dirty);
+    printf (", \"read-hits\": %"G_GUINT64_FORMAT", \"read-misses\": %"G_GUINT64_FORMAT", \"read-hit-ratio\": %0.2f",
+            read_hits, read_misses, ratio (read_hits, read_hits + read_misses));
+    printf (", \"write-hits\": %"G_GUINT64_FORMAT", \"write-misses\": %"G_GUINT64_FORMAT", \"write-hit-ratio\": %0.2f",
+            write_hits, write_misses, ratio (write_hits, write_hits + write_misses));
+    printf (", \"promotions\": %"G_GUINT64_FORMAT", \"demotions\": %"G_GUINT64_FORMAT"}",
+            counter_delta (prev->promotions, cur->promotions), counter_delta (prev->demotions, cur->demotions));
+}
+
+gboolean sample_lv_stats (guint interval, guint count, char **lv_specs, gboolean json, GError **error) {
+    BDLVMCachedLVStats **all = NULL;
+    GHashTable *prev = NULL;
+    GHashTable *cur = NULL;
+    GList *lv_names = NULL;
+    const BDLVMCacheStats *prev_stats = NULL;
+    gint64 prev_time = 0;
+    gint64 cur_time = 0;
+    double elapsed = 0;
+    gboolean ok = TRUE;
+
+    /* the first sample is only the baseline for the first interval */
+    all = bd_lvm_cache_stats_all (error);
+    if (!all)
+        return FALSE;
+    prev_time = g_get_monotonic_time ();
+    prev = sample_lvs (all, lv_specs);
+
+    for (char **lv_spec = lv_specs; lv_spec && *lv_spec; lv_spec++)
+        if (!g_hash_table_contains (prev, *lv_spec)) {
+            fprintf (stderr, "No stats for '%s', not an active cached LV?\n", *lv_spec);
+            ok = FALSE;
+        }
+    if (!ok) {
+        g_hash_table_destroy (prev);
+        return FALSE;
+    }
+
+    for (guint n = 0; count == 0 || n < count; n++) {
+        sleep (interval);
+
+        /* a single pass over the DM maps for all the LVs */
+        all = bd_lvm_cache_stats_all (error);
+        if (!all) {
+            g_hash_table_destroy (prev);
+            return FALSE;
+        }
+        cur_time = g_get_monotonic_time ();
+        cur = sample_lvs (all, lv_specs);
+        elapsed = (cur_time - prev_time) / (double) G_USEC_PER_SEC;
+
+        if (json)
+            printf ("{\"time\": %"G_GINT64_FORMAT", \"interval\": %0.2f, \"lvs\": [",
+                    g_get_real_time () / G_USEC_PER_SEC, elapsed);
+        else {
+            if (n > 0)
+                printf ("\n");
+            print_interval_header (elapsed);
+        }
+
+        lv_names = g_list_sort (g_hash_table_get_keys (cur), (GCompareFunc) g_strcmp0);
+        for (GList *name = lv_names; name; name = name->next) {
+            const BDLVMCacheStats *cur_stats = g_hash_table_lookup (cur, name->data);
+
+            /* LVs that appeared during the interval have no history yet */
+            prev_stats = g_hash_table_lookup (prev, name->data);
+            if (!prev_stats)
+                prev_stats = cur_stats;
+
+            if (json)
+                print_interval_stats_json (name->data, prev_stats, cur_stats, name == lv_names);
+            else
+                print_interval_stats (name->data, prev_stats, cur_stats, elapsed);
+        }
+        g_list_free (lv_names);
+
+        if (json)
+            printf ("]}\n");
+        fflush (stdout);
+
+        g_hash_table_destroy (prev);
+        prev = cur;
+        prev_time = cur_time;
+    }
+
+    g_hash_table_destroy (prev);
+    return TRUE;
+}
+
+gboolean parse_number_arg (int argc, char *argv[], int idx, guint *value) {
+    guint64 number = 0;
+    char *end = NULL;
+
+    if (idx < argc)
+        number = g_ascii_strtoull (argv[idx], &end, 10);
+    if (idx >= argc || *end != '\0' || number == 0 || number > G_MAXUINT) {
+        fprintf (stderr, "Invalid value for '%s' specified, has to be a positive number.\n", argv[idx - 1]);
+        print_usage (argv[0]);
+        return FALSE;
+    }
+    *value = (guint) number;
+
+    return TRUE;
+}
+
 int main (int argc, char *argv[]) {
     gboolean ret = FALSE;
     GError *error = NULL;
@@ -93,20 +291,42 @@ int main (int argc, char *argv[]) {
     }
 
     gboolean json = FALSE;
+    guint interval = 0;
+    guint count = 0;
     int first_lv_arg = 1;
-    for (int i=0; i < argc; i++) {
-        if ((g_strcmp0 (argv[i], "-j") == 0) || g_strcmp0 (argv[i], "--json") == 0) {
+    for (; first_lv_arg < argc; first_lv_arg++) {
+        const char *arg = argv[first_lv_arg];
+        if ((g_strcmp0 (arg, "-j") == 0) || g_strcmp0 (arg, "--json") == 0)
             json = TRUE;
-            first_lv_arg++;
-        }
+        else if ((g_strcmp0 (arg, "-i") == 0) || g_strcmp0 (arg, "--interval") == 0) {
+            if (!parse_number_arg (argc, argv, ++first_lv_arg, &interval))
+                return 1;
+        } else if ((g_strcmp0 (arg, "-c") == 0) || g_strcmp0 (arg, "--count") == 0) {
+            if (!parse_number_arg (argc, argv, ++first_lv_arg, &count))
+                return 1;
+        } else
+            break;
     }
 
-    if (first_lv_arg >= argc) {
+    if (count > 0 && interval == 0) {
+        fprintf (stderr, "Count can only be specified together with an interval!\n");
+        print_usage (argv[0]);
+        return 1;
+    }
+
+    if (first_lv_arg >= argc && interval == 0) {
         fprintf (stderr, "No cached LV to get the stats for specified!\n");
         print_usage (argv[0]);
         return 1;
     }
 
+    for (int i = first_lv_arg; i < argc; i++) {
+        if (!strchr (argv[i], '/')) {
+            fprintf (stderr, "Invalid LV specified: '%s'. Has to be in the VG/LV format.\n", argv[i]);
+            return 1;
+        }
+    }
+
     /* check that we are running as root */
     if ((getuid() != 0) || (geteuid() != 0)) {
         fprintf (stderr, "This utility must be run as root.\n");
@@ -124,6 +344,13 @@ int main (int argc, char *argv[]) {
         return 2;
     }
 
+    if (interval > 0) {
+        ret = sample_lv_stats (interval, count, first_lv_arg < argc ? &(argv[first_lv_arg]) : NULL, json, &error);
+        if (!ret && error)
+            fprintf (stderr, "Failed to get stats for the cached LVs: %s\n", error->message);
+        return ret ? 0 : 3;
+    }
+
     gboolean ok = TRUE;
     for (int i = first_lv_arg; i < argc; i++) {
         /* Add one blank line between stats for the individual LVs */
@@ -131,11 +358,6 @@ int main (int argc, char *argv[]) {
             printf("\n");
 
         char *slash = strchr (argv[i], '/');
-        if (!slash) {
-            fprintf (stderr, "Invalid LV specified: '%s'. Has to be in the VG/LV format.\n", argv[i]);
-            ok = FALSE;
-            continue;
-        }
         *slash = '\0';
         const char *vg_name = argv[i];
         const char *lv_name = slash + 1;
@@ -148,6 +370,7 @@ int main (int argc, char *argv[]) {
         if (!ret) {
             fprintf (stderr, "Failed to get stats for '%s/%s': %s\n",
                      vg_name, lv_name, error->message);
+            g_clear_error (&error);
             ok = FALSE;
         }
     }